@@ -316,6 +316,164 @@ juce::Font MicroAcidLookAndFeel::getLabelFont(juce::Label&)
     return juce::Font(juce::FontOptions("Helvetica", 13.0f, juce::Font::plain));
 }
 
+//==============================================================================
+// SequencerGrid Implementation
+//==============================================================================
+
+SequencerGrid::SequencerGrid(MicroAcid303AudioProcessor& processor)
+    : m_processor(processor),
+      m_pattern(processor.getSequencerPattern())
+{
+    setTooltip("Drag or scroll a note to change it (shift: octave). Click GATE, ACC and SLIDE to toggle.");
+}
+
+void SequencerGrid::refresh()
+{
+    const auto& pattern = m_processor.getSequencerPattern();
+    const int playingStep = m_processor.getSequencerStep();
+
+    if (pattern.notes != m_pattern.notes || pattern.flags != m_pattern.flags || playingStep != m_playingStep)
+    {
+        m_pattern = pattern;
+        m_playingStep = playingStep;
+        repaint();
+    }
+}
+
+juce::Rectangle<int> SequencerGrid::getCellBounds(int step, Row row) const
+{
+    const int noteHeight = getHeight() / 2;
+    const int toggleHeight = (getHeight() - noteHeight) / 3;
+    const int rowIndex = static_cast<int>(row);
+
+    const int x = step * getWidth() / Sequencer::Pattern::NUM_STEPS;
+    const int width = (step + 1) * getWidth() / Sequencer::Pattern::NUM_STEPS - x;
+    const int y = row == Row::Note ? 0 : noteHeight + (rowIndex - 1) * toggleHeight;
+
+    return { x, y, width, row == Row::Note ? noteHeight : toggleHeight };
+}
+
+int SequencerGrid::getStepAt(juce::Point<int> position) const
+{
+    return juce::jlimit(0, Sequencer::Pattern::NUM_STEPS - 1,
+                        position.x * Sequencer::Pattern::NUM_STEPS / juce::jmax(1, getWidth()));
+}
+
+SequencerGrid::Row SequencerGrid::getRowAt(juce::Point<int> position) const
+{
+    const int noteHeight = getHeight() / 2;
+    if (position.y < noteHeight)
+        return Row::Note;
+
+    const int toggleHeight = juce::jmax(1, (getHeight() - noteHeight) / 3);
+    return static_cast<Row>(juce::jlimit(1, 3, 1 + (position.y - noteHeight) / toggleHeight));
+}
+
+void SequencerGrid::paint(juce::Graphics& g)
+{
+    const auto font = juce::Font(juce::FontOptions("Helvetica", 10.0f, juce::Font::bold));
+    g.setFont(font);
+
+    for (int step = 0; step < Sequencer::Pattern::NUM_STEPS; ++step)
+    {
+        const bool gated = m_pattern.hasFlag(step, Sequencer::Pattern::Gate);
+
+        // Note cell - beats are marked, the playing step is lit
+        auto noteCell = getCellBounds(step, Row::Note).reduced(1);
+        g.setColour(step == m_playingStep ? orangeAccent.withAlpha(0.6f)
+                                          : (step % 4 == 0 ? darkGrey.brighter(0.2f) : darkGrey));
+        g.fillRect(noteCell);
+
+        g.setColour(gated ? juce::Colours::white.withAlpha(0.9f) : juce::Colours::white.withAlpha(0.3f));
+        g.drawFittedText(juce::MidiMessage::getMidiNoteName(m_pattern.notes[static_cast<size_t>(step)], true, true, 4),
+                         noteCell, juce::Justification::centred, 1);
+
+        // Gate, accent and slide toggles
+        const std::pair<Row, Sequencer::Pattern::Flags> toggles[] = {
+            { Row::Gate, Sequencer::Pattern::Gate },
+            { Row::Accent, Sequencer::Pattern::Accent },
+            { Row::Slide, Sequencer::Pattern::Slide }
+        };
+
+        for (const auto& [row, flag] : toggles)
+        {
+            auto cell = getCellBounds(step, row).reduced(2).toFloat();
+            const bool on = m_pattern.hasFlag(step, flag);
+
+            g.setColour(on ? (row == Row::Gate ? blueAccent : orangeAccent) : juce::Colours::black.withAlpha(0.4f));
+            g.fillRoundedRectangle(cell, 2.0f);
+        }
+    }
+
+    // Row captions over the first step's toggles
+    g.setColour(juce::Colours::white.withAlpha(0.7f));
+    g.setFont(juce::Font(juce::FontOptions("Helvetica", 8.0f, juce::Font::plain)));
+    g.drawText("GATE", getCellBounds(0, Row::Gate), juce::Justification::centred);
+    g.drawText("ACC", getCellBounds(0, Row::Accent), juce::Justification::centred);
+    g.drawText("SLIDE", getCellBounds(0, Row::Slide), juce::Justification::centred);
+}
+
+void SequencerGrid::mouseDown(const juce::MouseEvent& event)
+{
+    const int step = getStepAt(event.getPosition());
+
+    switch (getRowAt(event.getPosition()))
+    {
+        case Row::Note:
+            m_dragStep = step;
+            m_dragStartNote = m_pattern.notes[static_cast<size_t>(step)];
+            return;
+        case Row::Gate:
+            m_pattern.setFlag(step, Sequencer::Pattern::Gate, !m_pattern.hasFlag(step, Sequencer::Pattern::Gate));
+            break;
+        case Row::Accent:
+            m_pattern.setFlag(step, Sequencer::Pattern::Accent, !m_pattern.hasFlag(step, Sequencer::Pattern::Accent));
+            break;
+        case Row::Slide:
+            m_pattern.setFlag(step, Sequencer::Pattern::Slide, !m_pattern.hasFlag(step, Sequencer::Pattern::Slide));
+            break;
+    }
+
+    m_dragStep = -1;
+    commit();
+}
+
+void SequencerGrid::mouseDrag(const juce::MouseEvent& event)
+{
+    if (m_dragStep < 0)
+        return;
+
+    // Upwards raises the note
+    const int semitones = -event.getDistanceFromDragStartY() / PIXELS_PER_SEMITONE;
+    setNote(m_dragStep, m_dragStartNote + (event.mods.isShiftDown() ? semitones * 12 : semitones));
+}
+
+void SequencerGrid::mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel)
+{
+    if (getRowAt(event.getPosition()) != Row::Note || wheel.deltaY == 0.0f)
+        return;
+
+    const int step = getStepAt(event.getPosition());
+    const int direction = wheel.deltaY > 0.0f ? 1 : -1;
+    setNote(step, m_pattern.notes[static_cast<size_t>(step)] + direction * (event.mods.isShiftDown() ? 12 : 1));
+}
+
+void SequencerGrid::setNote(int step, int note)
+{
+    note = juce::jlimit(MIN_NOTE, MAX_NOTE, note);
+    if (note == m_pattern.notes[static_cast<size_t>(step)])
+        return;
+
+    m_pattern.notes[static_cast<size_t>(step)] = static_cast<uint8_t>(note);
+    commit();
+}
+
+void SequencerGrid::commit()
+{
+    m_processor.setSequencerPattern(m_pattern);
+    repaint();
+}
+
 //==============================================================================
 // MicroAcid303AudioProcessorEditor Implementation
 //==============================================================================
@@ -323,6 +481,7 @@ juce::Font MicroAcidLookAndFeel::getLabelFont(juce::Label&)
 MicroAcid303AudioProcessorEditor::MicroAcid303AudioProcessorEditor (MicroAcid303AudioProcessor& p)
     : AudioProcessorEditor (&p),
       m_audioProcessor (p),
+      m_sequencerGrid (p),
       m_midiKeyboard (p.getKeyboardState(), juce::MidiKeyboardComponent::horizontalKeyboard)
 {
     // Set the custom look and feel
@@ -486,7 +645,7 @@ MicroAcid303AudioProcessorEditor::MicroAcid303AudioProcessorEditor (MicroAcid303
     //==============================================================================
     // EFFECTS SECTION
 
-    // Add all 8 effect types
+    // Add all 9 effect types
     m_fxTypeSelector.addItem("Tape Dly", 1);
     m_fxTypeSelector.addItem("Digi Dly", 2);
     m_fxTypeSelector.addItem("PingPong", 3);
@@ -495,18 +654,33 @@ MicroAcid303AudioProcessorEditor::MicroAcid303AudioProcessorEditor (MicroAcid303
     m_fxTypeSelector.addItem("Flanger", 6);
     m_fxTypeSelector.addItem("Phaser", 7);
     m_fxTypeSelector.addItem("Bitcrush", 8);
+    m_fxTypeSelector.addItem("Convolve", 9);
     addAndMakeVisible(m_fxTypeSelector);
-    m_fxTypeSelector.setTooltip("Effects: Tape Delay, Digital Delay, Ping Pong, Reverb, Chorus, Flanger, Phaser, Bitcrush");
-    m_fxTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
-        m_audioProcessor.getValueTreeState(), MicroAcidParameters::IDs::FX_TYPE, m_fxTypeSelector);
+    m_fxTypeSelector.setTooltip("Effects: Tape Delay, Digital Delay, Ping Pong, Reverb, Chorus, Flanger, Phaser, Bitcrush, Convolution (slots 2-4)");
 
-    setupLabel(m_fxTypeLabel, "FX TYPE");
+    setupLabel(m_fxTypeLabel, "FX");
     addAndMakeVisible(m_fxTypeLabel);
 
+    // Rack slots run in series; the controls edit one slot at a time
+    for (int slot = 0; slot < static_cast<int>(MicroAcidParameters::NUM_FX_SLOTS); ++slot)
+        m_fxSlotSelector.addItem("Slot " + juce::String(slot + 1), slot + 1);
+    m_fxSlotSelector.setTooltip("Effects rack slot to edit - slots are processed in order, 1 to 4");
+    m_fxSlotSelector.onChange = [this] { selectFxSlot(m_fxSlotSelector.getSelectedItemIndex()); };
+    addAndMakeVisible(m_fxSlotSelector);
+
+    m_fxBypassButton.setButtonText("BYP");
+    m_fxBypassButton.setClickingTogglesState(true);
+    m_fxBypassButton.setTooltip("Bypass this slot - a bypassed slot uses no CPU");
+    addAndMakeVisible(m_fxBypassButton);
+
+    // Impulse response for the convolution type (room or speaker cabinet)
+    m_fxImpulseResponseButton.setButtonText("IR");
+    m_fxImpulseResponseButton.onClick = [this] { showImpulseResponseMenu(); };
+    addAndMakeVisible(m_fxImpulseResponseButton);
+    updateImpulseResponseButton();
+
     setupRotarySlider(m_fxTimeSlider);
     m_fxTimeSlider.setTooltip("Delay time or reverb size");
-    m_fxTimeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        m_audioProcessor.getValueTreeState(), MicroAcidParameters::IDs::FX_TIME, m_fxTimeSlider);
 
     setupLabel(m_fxTimeLabel, "TIME");
     addAndMakeVisible(m_fxTimeLabel);
@@ -517,8 +691,6 @@ MicroAcid303AudioProcessorEditor::MicroAcid303AudioProcessorEditor (MicroAcid303
 
     setupRotarySlider(m_fxFeedbackSlider);
     m_fxFeedbackSlider.setTooltip("Effect feedback amount");
-    m_fxFeedbackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        m_audioProcessor.getValueTreeState(), MicroAcidParameters::IDs::FX_FEEDBACK, m_fxFeedbackSlider);
 
     setupLabel(m_fxFeedbackLabel, "FEEDBACK");
     addAndMakeVisible(m_fxFeedbackLabel);
@@ -529,8 +701,6 @@ MicroAcid303AudioProcessorEditor::MicroAcid303AudioProcessorEditor (MicroAcid303
 
     setupRotarySlider(m_fxMixSlider);
     m_fxMixSlider.setTooltip("Dry/wet mix of effect");
-    m_fxMixAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        m_audioProcessor.getValueTreeState(), MicroAcidParameters::IDs::FX_MIX, m_fxMixSlider);
 
     setupLabel(m_fxMixLabel, "MIX");
     addAndMakeVisible(m_fxMixLabel);
@@ -539,6 +709,9 @@ MicroAcid303AudioProcessorEditor::MicroAcid303AudioProcessorEditor (MicroAcid303
     m_fxMixValueLabel.setFont(juce::Font(juce::FontOptions(11.0f)));
     addAndMakeVisible(m_fxMixValueLabel);
 
+    m_fxSlotSelector.setSelectedItemIndex(0, juce::dontSendNotification);
+    selectFxSlot(0);
+
     //==============================================================================
     // ARPEGGIATOR SECTION
 
@@ -619,6 +792,27 @@ MicroAcid303AudioProcessorEditor::MicroAcid303AudioProcessorEditor (MicroAcid303
     m_arpSwingValueLabel.setFont(juce::Font(juce::FontOptions(10.0f)));
     addAndMakeVisible(m_arpSwingValueLabel);
 
+    //==============================================================================
+    // SEQUENCER SECTION
+
+    m_seqEnabledButton.setButtonText("SEQ ON");
+    m_seqEnabledButton.setClickingTogglesState(true);
+    m_seqEnabledButton.setTooltip("Play the internal 16-step pattern in sync with the host (MIDI notes are ignored)");
+    addAndMakeVisible(m_seqEnabledButton);
+    m_seqEnabledAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        m_audioProcessor.getValueTreeState(), MicroAcidParameters::IDs::SEQ_ENABLED, m_seqEnabledButton);
+
+    setupLinearSlider(m_seqShuffleSlider);
+    m_seqShuffleSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    m_seqShuffleSlider.setTooltip("Shuffle - delays every second step");
+    m_seqShuffleAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        m_audioProcessor.getValueTreeState(), MicroAcidParameters::IDs::SEQ_SHUFFLE, m_seqShuffleSlider);
+
+    setupLabel(m_seqShuffleLabel, "SHUFFLE");
+    addAndMakeVisible(m_seqShuffleLabel);
+
+    addAndMakeVisible(m_sequencerGrid);
+
     //==============================================================================
     // OUTPUT SECTION
 
@@ -775,9 +969,9 @@ void MicroAcid303AudioProcessorEditor::paint (juce::Graphics& g)
 
     bounds.removeFromTop(8);
 
-    // Middle row: ARPEGGIATOR (full width)
+    // Middle row: ARPEGGIATOR with the SEQUENCER strip below it (full width)
     auto middleRow = bounds.removeFromTop(bounds.getHeight() / 2 - 4);
-    drawSection(g, middleRow, "ARPEGGIATOR");
+    drawSection(g, middleRow, "ARPEGGIATOR / SEQUENCER");
 
     bounds.removeFromTop(8);
 
@@ -907,9 +1101,21 @@ void MicroAcid303AudioProcessorEditor::resized()
     bounds.removeFromTop(8);
 
     //==============================================================================
-    // MIDDLE ROW LAYOUT (ARPEGGIATOR)
+    // MIDDLE ROW LAYOUT (ARPEGGIATOR, SEQUENCER)
     auto middleRow = bounds.removeFromTop(bounds.getHeight() / 2 - 4).reduced(12, 32);
 
+    // Sequencer strip along the bottom of the row
+    auto seqRow = middleRow.removeFromBottom(juce::jmax(48, middleRow.getHeight() - 92));
+    seqRow.removeFromTop(4);
+
+    auto seqControls = seqRow.removeFromLeft(80);
+    m_seqEnabledButton.setBounds(seqControls.removeFromTop(24).reduced(4, 0));
+    m_seqShuffleLabel.setBounds(seqControls.removeFromTop(12));
+    m_seqShuffleSlider.setBounds(seqControls.removeFromTop(20));
+
+    seqRow.removeFromLeft(10);
+    m_sequencerGrid.setBounds(seqRow);
+
     // Arp enable button
     auto arpEnableArea = middleRow.removeFromLeft(80);
     m_arpEnabledButton.setBounds(arpEnableArea.reduced(4, 20));
@@ -973,7 +1179,13 @@ void MicroAcid303AudioProcessorEditor::resized()
     auto fxSection = bottomRow.removeFromLeft(bottomRow.getWidth() * 2 / 3 - 4).reduced(12, 28);
 
     auto fxTypeRow = fxSection.removeFromTop(26);
-    m_fxTypeLabel.setBounds(fxTypeRow.removeFromLeft(65));
+    m_fxTypeLabel.setBounds(fxTypeRow.removeFromLeft(24));
+    m_fxSlotSelector.setBounds(fxTypeRow.removeFromLeft(72));
+    fxTypeRow.removeFromLeft(4);
+    m_fxImpulseResponseButton.setBounds(fxTypeRow.removeFromRight(32));
+    fxTypeRow.removeFromRight(4);
+    m_fxBypassButton.setBounds(fxTypeRow.removeFromRight(52));
+    fxTypeRow.removeFromRight(4);
     m_fxTypeSelector.setBounds(fxTypeRow);
 
     fxSection.removeFromTop(6);
@@ -1061,22 +1273,27 @@ void MicroAcid303AudioProcessorEditor::timerCallback()
         juce::String(params.getRawParameterValue(MicroAcidParameters::IDs::DRIVE)->load(), 1),
         juce::dontSendNotification);
 
+    const auto& fxSlot = MicroAcidParameters::FX_SLOTS[static_cast<size_t>(m_fxSlot)];
+
     m_fxTimeValueLabel.setText(
-        juce::String(params.getRawParameterValue(MicroAcidParameters::IDs::FX_TIME)->load(), 0) + " ms",
+        juce::String(params.getRawParameterValue(MicroAcidParameters::getInfo(fxSlot.time).id)->load(), 0) + " ms",
         juce::dontSendNotification);
 
     m_fxFeedbackValueLabel.setText(
-        juce::String(int(params.getRawParameterValue(MicroAcidParameters::IDs::FX_FEEDBACK)->load() * 100)) + " %",
+        juce::String(int(params.getRawParameterValue(MicroAcidParameters::getInfo(fxSlot.feedback).id)->load() * 100)) + " %",
         juce::dontSendNotification);
 
     m_fxMixValueLabel.setText(
-        juce::String(int(params.getRawParameterValue(MicroAcidParameters::IDs::FX_MIX)->load() * 100)) + " %",
+        juce::String(int(params.getRawParameterValue(MicroAcidParameters::getInfo(fxSlot.mix).id)->load() * 100)) + " %",
         juce::dontSendNotification);
 
     m_outputGainValueLabel.setText(
         juce::String(params.getRawParameterValue(MicroAcidParameters::IDs::OUTPUT_GAIN)->load(), 1) + " dB",
         juce::dontSendNotification);
 
+    // Sequencer pattern and playhead
+    m_sequencerGrid.refresh();
+
     // Arpeggiator values
     m_arpGateValueLabel.setText(
         juce::String(int(params.getRawParameterValue(MicroAcidParameters::IDs::ARP_GATE)->load() * 100)) + " %",
@@ -1223,6 +1440,84 @@ void MicroAcid303AudioProcessorEditor::drawSection(juce::Graphics& g, juce::Rect
     drawScrew((float)bounds.getRight() - screwInset, (float)bounds.getBottom() - screwInset);
 }
 
+void MicroAcid303AudioProcessorEditor::showImpulseResponseMenu()
+{
+    const bool loaded = m_audioProcessor.getImpulseResponseFile() != juce::File();
+
+    juce::PopupMenu menu;
+    menu.addItem(1, "Load impulse response...");
+    menu.addItem(2, "Clear impulse response", loaded);
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(m_fxImpulseResponseButton),
+        [this](int result)
+        {
+            if (result == 2)
+            {
+                m_audioProcessor.clearImpulseResponse();
+                updateImpulseResponseButton();
+                return;
+            }
+
+            if (result != 1)
+                return;
+
+            m_impulseResponseChooser = std::make_unique<juce::FileChooser>(
+                "Load impulse response", m_audioProcessor.getImpulseResponseFile(), "*.wav;*.aif;*.aiff");
+
+            m_impulseResponseChooser->launchAsync(
+                juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                [this](const juce::FileChooser& chooser)
+                {
+                    const auto file = chooser.getResult();
+                    if (file.existsAsFile() && !m_audioProcessor.loadImpulseResponse(file))
+                        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                            "Impulse response", "Could not read " + file.getFileName());
+
+                    updateImpulseResponseButton();
+                });
+        });
+}
+
+void MicroAcid303AudioProcessorEditor::selectFxSlot(int slot)
+{
+    using Attachments = juce::AudioProcessorValueTreeState;
+
+    m_fxSlot = juce::jlimit(0, static_cast<int>(MicroAcidParameters::NUM_FX_SLOTS) - 1, slot);
+    const auto& parameters = MicroAcidParameters::FX_SLOTS[static_cast<size_t>(m_fxSlot)];
+    auto& state = m_audioProcessor.getValueTreeState();
+
+    // Detach from the previous slot before attaching, so its values are not overwritten
+    m_fxTypeAttachment.reset();
+    m_fxBypassAttachment.reset();
+    m_fxTimeAttachment.reset();
+    m_fxFeedbackAttachment.reset();
+    m_fxMixAttachment.reset();
+
+    // Slot 1's type list stops before "Convolve"
+    const auto& typeInfo = MicroAcidParameters::getInfo(parameters.type);
+    for (int item = 1; item <= m_fxTypeSelector.getNumItems(); ++item)
+        m_fxTypeSelector.setItemEnabled(item, item <= typeInfo.numChoices);
+
+    m_fxTypeAttachment = std::make_unique<Attachments::ComboBoxAttachment>(
+        state, typeInfo.id, m_fxTypeSelector);
+    m_fxBypassAttachment = std::make_unique<Attachments::ButtonAttachment>(
+        state, MicroAcidParameters::getInfo(parameters.bypass).id, m_fxBypassButton);
+    m_fxTimeAttachment = std::make_unique<Attachments::SliderAttachment>(
+        state, MicroAcidParameters::getInfo(parameters.time).id, m_fxTimeSlider);
+    m_fxFeedbackAttachment = std::make_unique<Attachments::SliderAttachment>(
+        state, MicroAcidParameters::getInfo(parameters.feedback).id, m_fxFeedbackSlider);
+    m_fxMixAttachment = std::make_unique<Attachments::SliderAttachment>(
+        state, MicroAcidParameters::getInfo(parameters.mix).id, m_fxMixSlider);
+}
+
+void MicroAcid303AudioProcessorEditor::updateImpulseResponseButton()
+{
+    const auto file = m_audioProcessor.getImpulseResponseFile();
+    m_fxImpulseResponseButton.setTooltip(file == juce::File()
+        ? juce::String("Load an impulse response (room or speaker cabinet) for the Convolve effect")
+        : "Impulse response: " + file.getFileName());
+}
+
 //==============================================================================
 // VISUALIZATION DRAWING METHODS (v1.1)
 //==============================================================================
@@ -40,6 +40,55 @@ private:
     juce::Colour blueAccent = juce::Colour(0xff00aaff);    // LED blue for displays
 };
 
+/**
+ * 16-step pattern editor for the internal sequencer
+ *
+ * Each column is one step: its note on top (drag or scroll to change, with
+ * shift for octaves), then gate, accent and slide toggles. Every edit hands
+ * the whole pattern to the processor; the playing step is highlighted.
+ */
+class SequencerGrid : public juce::Component,
+                      public juce::SettableTooltipClient
+{
+public:
+    explicit SequencerGrid(MicroAcid303AudioProcessor& processor);
+
+    void paint(juce::Graphics& g) override;
+    void mouseDown(const juce::MouseEvent& event) override;
+    void mouseDrag(const juce::MouseEvent& event) override;
+    void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
+
+    /** Picks up the playing step and patterns loaded with a state - called from the editor's timer. */
+    void refresh();
+
+private:
+    enum class Row { Note = 0, Gate, Accent, Slide };
+
+    int getStepAt(juce::Point<int> position) const;
+    Row getRowAt(juce::Point<int> position) const;
+    juce::Rectangle<int> getCellBounds(int step, Row row) const;
+    void setNote(int step, int note);
+    void commit();
+
+    MicroAcid303AudioProcessor& m_processor;
+    Sequencer::Pattern m_pattern;
+    int m_playingStep = -1;
+
+    // Note dragging
+    int m_dragStep = -1;
+    int m_dragStartNote = 0;
+
+    static constexpr int MIN_NOTE = 24;             // C1
+    static constexpr int MAX_NOTE = 84;             // C6
+    static constexpr int PIXELS_PER_SEMITONE = 6;
+
+    juce::Colour orangeAccent = juce::Colour(0xffff6600);
+    juce::Colour blueAccent = juce::Colour(0xff00aaff);
+    juce::Colour darkGrey = juce::Colour(0xff3a3a3a);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SequencerGrid)
+};
+
 /**
  * Plugin Editor (GUI) for the TB-Style Bassline.
  *
@@ -72,6 +121,9 @@ private:
     void setupLinearSlider(juce::Slider& slider, const juce::String& suffix = "");
     void setupLabel(juce::Label& label, const juce::String& text);
     void drawSection(juce::Graphics& g, juce::Rectangle<int> bounds, const juce::String& title);
+    void showImpulseResponseMenu();
+    void updateImpulseResponseButton();
+    void selectFxSlot(int slot);
 
     // Visualization drawing methods
     void drawOscilloscope(juce::Graphics& g, juce::Rectangle<int> bounds);
@@ -149,10 +201,19 @@ private:
 
     //==============================================================================
     // EFFECTS SECTION
+    juce::ComboBox m_fxSlotSelector;   // Rack slot the controls below are attached to
+    int m_fxSlot = 0;
+
     juce::ComboBox m_fxTypeSelector;
     juce::Label m_fxTypeLabel;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> m_fxTypeAttachment;
 
+    juce::ToggleButton m_fxBypassButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> m_fxBypassAttachment;
+
+    juce::TextButton m_fxImpulseResponseButton;
+    std::unique_ptr<juce::FileChooser> m_impulseResponseChooser;
+
     juce::Slider m_fxTimeSlider;
     juce::Label m_fxTimeLabel;
     juce::Label m_fxTimeValueLabel;
@@ -196,6 +257,17 @@ private:
     juce::Label m_arpSwingValueLabel;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> m_arpSwingAttachment;
 
+    //==============================================================================
+    // SEQUENCER SECTION (shares the arpeggiator row)
+    juce::ToggleButton m_seqEnabledButton;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> m_seqEnabledAttachment;
+
+    juce::Slider m_seqShuffleSlider;
+    juce::Label m_seqShuffleLabel;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> m_seqShuffleAttachment;
+
+    SequencerGrid m_sequencerGrid;
+
     //==============================================================================
     // OUTPUT SECTION
     juce::Slider m_outputGainSlider;
@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include <juce_audio_formats/juce_audio_formats.h>
 #include <cmath>
 
 MicroAcid303AudioProcessor::MicroAcid303AudioProcessor()
@@ -9,20 +10,22 @@ MicroAcid303AudioProcessor::MicroAcid303AudioProcessor()
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                       #endif
-                       .withOutput ("Output", juce::AudioChannelSet::mono(), true)
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        ),
 #endif
       m_parameters (*this, nullptr, juce::Identifier("MicroAcid303"),
-                    MicroAcidParameters::createParameterLayout())
+                    MicroAcidParameters::createParameterLayout()),
+      m_parameterCache (m_parameters)
 {
-    // Create DSP modules
-    m_oscillator = std::make_unique<Oscillator>();
-    m_envelope = std::make_unique<Envelope>();
-    m_filter = std::make_unique<LadderFilter>();
-    m_overdrive = std::make_unique<Overdrive>();
-    m_effects = std::make_unique<Effects>();
-    m_arpeggiator = std::make_unique<Arpeggiator>();
+    // New instances get a fresh seed; loading a state restores the saved one
+    setRandomSeed(juce::Random::getSystemRandom().nextInt64() & 0x7fffffffffffffff);
+    setSequencerPattern(Sequencer::Pattern());
+
+    // Both channels play the same curve - build each one once
+    const auto tableBuilder = Overdrive::createTableBuilder();
+    for (auto& chain : m_channelChains)
+        chain.get<Overdrive>().setTableBuilder(tableBuilder);
 }
 
 MicroAcid303AudioProcessor::~MicroAcid303AudioProcessor()
@@ -63,7 +66,8 @@ bool MicroAcid303AudioProcessor::isMidiEffect() const
 
 double MicroAcid303AudioProcessor::getTailLengthSeconds() const
 {
-    return 2.0; // Effects tail
+    // The last note's release, then every enabled effect ringing out in series
+    return m_envelope.getReleaseTime() + m_effects.getTailLengthSeconds();
 }
 
 int MicroAcid303AudioProcessor::getNumPrograms()
@@ -97,23 +101,38 @@ void MicroAcid303AudioProcessor::prepareToPlay (double sampleRate, int samplesPe
     m_sampleRate = sampleRate;
     m_samplesPerBlock = samplesPerBlock;
 
-    if (m_oscillator)
-        m_oscillator->prepare(sampleRate, samplesPerBlock);
+    // Allocate scratch buffers - never resized on the audio thread
+    m_envelopeBuffer.assign(static_cast<size_t>(samplesPerBlock), 0.0f);
 
-    if (m_envelope)
-        m_envelope->prepare(sampleRate, samplesPerBlock);
+    // Seeds must be in place before prepare() resets the generators
+    applyRandomSeed();
 
-    if (m_filter)
-        m_filter->prepare(sampleRate, samplesPerBlock);
+    m_oscillator.prepare(sampleRate, samplesPerBlock);
+    m_envelope.prepare(sampleRate, samplesPerBlock);
+    m_effects.prepare(sampleRate, samplesPerBlock);
+    m_arpeggiator.prepare(sampleRate);
+    m_sequencer.prepare(sampleRate);
 
-    if (m_overdrive)
-        m_overdrive->prepare(sampleRate, samplesPerBlock);
+    if (sampleRate != m_appliedImpulseResponseRate)
+        applyImpulseResponse();
 
-    if (m_effects)
-        m_effects->prepare(sampleRate, samplesPerBlock);
+    using Index = MicroAcidParameters::Index;
+    m_parameterCache.update(m_snapshot);
 
-    if (m_arpeggiator)
-        m_arpeggiator->prepare(sampleRate);
+    // Filter and overdrive run at the oversampled rate
+    m_oversampling.prepare(sampleRate, samplesPerBlock);
+    m_oversampling.setFactor(m_snapshot.getInt(Index::Oversampling));
+    m_oversampling.setFilterType(m_snapshot.getInt(Index::OversamplingFilter));
+    prepareChannelChains();
+    setLatencySamples(m_oversampling.getLatencySamples());
+
+    // Output-stage ramps start at the current parameter values
+    m_outputGainSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+    m_outputGainSmoother.reset(juce::Decibels::decibelsToGain(m_snapshot.get(Index::OutputGain)));
+    m_accentSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+    m_accentSmoother.reset(m_snapshot.get(Index::Accent));
+
+    m_isAsleep = false;
 }
 
 void MicroAcid303AudioProcessor::releaseResources()
@@ -147,137 +166,69 @@ void MicroAcid303AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // Get playhead info for arpeggiator
+    // Get playhead info for arpeggiator - while the host is stopped the grid
+    // free-runs from the last known position
     if (auto* playHead = getPlayHead())
     {
         if (auto posInfo = playHead->getPosition())
         {
             if (posInfo->getBpm())
                 m_bpm = *posInfo->getBpm();
-            if (posInfo->getTimeInSamples())
-                m_samplePosition = *posInfo->getTimeInSamples();
+            if (posInfo->getIsPlaying() && posInfo->getPpqPosition())
+                m_ppqPosition = *posInfo->getPpqPosition();
         }
     }
 
-    // Update ALL parameters
-    updateOscillatorParameters();
-    updateEnvelopeParameters();
-    updateFilterParameters();
-    updateOverdriveParameters();
-    updateEffectsParameters();
-    updateArpeggiatorParameters();
-
-    // Get output gain
-    auto* outputGainParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::OUTPUT_GAIN));
-    float outputGainDb = outputGainParam ? outputGainParam->get() : 0.0f;
-    float outputGain = juce::Decibels::decibelsToGain(outputGainDb);
-
-    // Check if arpeggiator is enabled
-    auto* arpEnabledParam = dynamic_cast<juce::AudioParameterBool*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::ARP_ENABLED));
-    bool arpEnabled = arpEnabledParam ? arpEnabledParam->get() : false;
+    // Snapshot ALL parameters, then re-apply only the groups that changed
+    m_parameterCache.update(m_snapshot);
+    applyParameterChanges();
 
-    // Merge MIDI from keyboard state (for standalone)
-    m_keyboardState.processNextMidiBuffer(midiMessages, 0, buffer.getNumSamples(), true);
+    using Index = MicroAcidParameters::Index;
 
-    // Process MIDI (with or without arpeggiator)
-    for (const auto metadata : midiMessages)
-    {
-        auto msg = metadata.getMessage();
+    // Output gain ramps in linear gain - the ramp buffers are rendered per chunk
+    m_outputGainSmoother.setTarget(juce::Decibels::decibelsToGain(m_snapshot.get(Index::OutputGain)));
 
-        if (arpEnabled && m_arpeggiator)
-        {
-            // Feed notes to arpeggiator
-            if (msg.isNoteOn())
-                m_arpeggiator->noteOn(msg.getNoteNumber(), msg.getVelocity() / 127.0f);
-            else if (msg.isNoteOff())
-                m_arpeggiator->noteOff(msg.getNoteNumber());
-            else if (msg.isAllNotesOff())
-                m_arpeggiator->allNotesOff();
-        }
-        else
-        {
-            // Direct MIDI handling
-            handleMidiMessage(msg);
-        }
-    }
+    // The internal sequencer takes over the voice from MIDI and the arpeggiator
+    const NoteSource source = m_snapshot.getBool(Index::SeqEnabled) ? NoteSource::Sequencer
+                            : m_snapshot.getBool(Index::ArpEnabled) ? NoteSource::Arpeggiator
+                                                                    : NoteSource::Midi;
 
-    // Generate audio
-    auto* channelData = buffer.getWritePointer(0);
+    // Merge MIDI from keyboard state (for standalone)
+    m_keyboardState.processNextMidiBuffer(midiMessages, 0, buffer.getNumSamples(), true);
+
+    // Generate audio (right is null on a mono bus)
+    auto* left = buffer.getWritePointer(0);
+    auto* right = totalNumOutputChannels > 1 ? buffer.getWritePointer(1) : nullptr;
     const int numSamples = buffer.getNumSamples();
 
-    if (!m_oscillator || !m_envelope || !m_filter || !m_overdrive || !m_effects)
+    if (m_envelopeBuffer.empty())
     {
         buffer.clear();
         return;
     }
 
-    for (int sample = 0; sample < numSamples; ++sample)
-    {
-        // Process arpeggiator timing
-        if (arpEnabled && m_arpeggiator)
-        {
-            if (m_arpeggiator->process(m_bpm, m_samplePosition + sample))
-            {
-                // Arpeggiator triggered a new note
-                if (m_arpeggiator->isNoteActive())
-                {
-                    int note = m_arpeggiator->getCurrentNote();
-                    float vel = m_arpeggiator->getCurrentVelocity();
-
-                    m_currentNote = note;
-                    m_currentVelocity = vel;
-                    m_isNoteActive = true;
-
-                    if (m_oscillator)
-                        m_oscillator->setFrequency(midiNoteToFrequency(note));
-                    if (m_envelope)
-                        m_envelope->noteOn();
-                }
-            }
-
-            // Check if gate closed
-            if (!m_arpeggiator->isNoteActive() && m_isNoteActive)
-            {
-                m_isNoteActive = false;
-                if (m_envelope)
-                    m_envelope->noteOff();
-            }
-        }
-
-        // 1. Generate oscillator
-        float signal = m_oscillator->processSample(0.0f);
+    const double beatsPerSample = m_bpm / (60.0 * getSampleRate());
 
-        // 2. Get envelope
-        float envValue = m_envelope->processSample(0.0f);
-
-        // 3. Apply envelope to amplitude with accent
-        float amplitude = m_currentVelocity * (1.0f + m_accentAmount * 0.5f);
-        signal *= envValue * amplitude;
-
-        // 4. Apply filter with envelope modulation
-        m_filter->setEnvelopeValue(envValue);
-        signal = m_filter->processSample(signal);
-
-        // 5. Apply overdrive
-        signal = m_overdrive->processSample(signal);
-
-        // 6. Apply effects
-        signal = m_effects->processSample(signal);
-
-        // 7. Apply output gain
-        signal *= outputGain;
-
-        // 8. Final soft clip
-        signal = std::tanh(signal * 0.9f);
+    if (m_isAsleep && midiMessages.isEmpty() && isChainSilent(source))
+    {
+        // Nothing to play and nothing left ringing: the block is silence, and
+        // only the meters and the playhead move on
+        buffer.clear();
 
-        channelData[sample] = signal;
+        // Ramps land on their targets rather than resuming mid-way on wake
+        m_outputGainSmoother.reset(m_outputGainSmoother.getTarget());
+        m_accentSmoother.reset(m_accentSmoother.getTarget());
+    }
+    else
+    {
+        // Render in chunks no larger than the scratch buffers; MIDI is applied at
+        // each event's sample position inside them
+        const int maxChunk = static_cast<int>(m_envelopeBuffer.size());
+        for (int offset = 0; offset < numSamples; offset += maxChunk)
+            renderBlock(left + offset, right != nullptr ? right + offset : nullptr,
+                        std::min(maxChunk, numSamples - offset), m_ppqPosition + offset * beatsPerSample,
+                        source, midiMessages, offset);
     }
-
-    // Copy mono to stereo if needed
-    if (totalNumOutputChannels > 1)
-        buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
 
     //==============================================================================
     // VISUALIZATION DATA CAPTURE (thread-safe)
@@ -303,17 +254,15 @@ void MicroAcid303AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     m_outputPeakL.store(peakL > currentPeakL ? peakL : currentPeakL * decay);
     m_outputPeakR.store(peakR > currentPeakR ? peakR : currentPeakR * decay);
 
+    // Skip the chain from the next block once the output and every stage are silent
+    m_isAsleep = std::max(peakL, peakR) < DSPModule::SILENCE_THRESHOLD && isChainSilent(source);
+
     // Store envelope level for visualization
-    if (m_envelope)
-        m_envelopeLevel.store(m_envelope->getCurrentLevel());
+    m_envelopeLevel.store(m_envelope.getCurrentLevel());
 
     // Store filter parameters for visualization
-    auto* cutoffParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::CUTOFF));
-    auto* resonanceParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::RESONANCE));
-    if (cutoffParam) m_currentCutoff.store(cutoffParam->get());
-    if (resonanceParam) m_currentResonance.store(resonanceParam->get());
+    m_currentCutoff.store(m_snapshot.get(Index::Cutoff));
+    m_currentResonance.store(m_snapshot.get(Index::Resonance));
 
     // Update waveform buffer (circular, for oscilloscope)
     int writeIdx = m_waveformWriteIndex.load();
@@ -324,7 +273,189 @@ void MicroAcid303AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     }
     m_waveformWriteIndex.store((writeIdx + samplesToWrite) % WAVEFORM_BUFFER_SIZE);
 
-    m_samplePosition += numSamples;
+    m_ppqPosition += numSamples * beatsPerSample;
+}
+
+bool MicroAcid303AudioProcessor::isChainSilent(NoteSource source) const
+{
+    // The sequencer plays whenever it is enabled, the arpeggiator while notes are held
+    if (source == NoteSource::Sequencer || (source == NoteSource::Arpeggiator && !m_arpeggiator.isIdle()))
+        return false;
+
+    return m_envelope.isSilent()
+        && m_channelChains[0].isSilent() && m_channelChains[1].isSilent()
+        && m_effects.isSilent();
+}
+
+void MicroAcid303AudioProcessor::renderBlock(float* left, float* right, int numSamples,
+                                             double ppqPosition, NoteSource source,
+                                             const juce::MidiBuffer& midiMessages, int midiOffset)
+{
+    const float* accent = m_accentSmoother.render(numSamples);
+    const float* outputGain = m_outputGainSmoother.render(numSamples);
+
+    // 1-3. Render oscillator and envelope, split at MIDI, arpeggiator and sequencer events
+    int segmentStart = 0;
+    const auto splitAt = [&](int sample)
+    {
+        renderVoice(left, right, accent, segmentStart, sample);
+        segmentStart = sample;
+    };
+
+    auto event = midiMessages.findNextSamplePosition(midiOffset);
+    int sample = 0;
+
+    while (sample < numSamples)
+    {
+        // Position of the next MIDI event in this chunk
+        int nextEvent = numSamples;
+        if (event != midiMessages.cend())
+            nextEvent = juce::jlimit(sample, numSamples, (*event).samplePosition - midiOffset);
+
+        const double spanPpq = ppqPosition + sample * m_bpm / (60.0 * getSampleRate());
+
+        if (source == NoteSource::Arpeggiator && nextEvent > sample)
+        {
+            // Arpeggiator steps and gate-offs up to the next MIDI event
+            const auto& arpEvents = m_arpeggiator.process(m_bpm, spanPpq, nextEvent - sample);
+
+            for (const auto& arpEvent : arpEvents)
+            {
+                splitAt(sample + arpEvent.offset);
+
+                if (arpEvent.type == Arpeggiator::Event::Type::NoteOn)
+                {
+                    m_currentNote = arpEvent.note;
+                    m_currentVelocity = arpEvent.velocity;
+                    m_isNoteActive = true;
+
+                    m_oscillator.setFrequency(midiNoteToFrequency(arpEvent.note));
+                    m_envelope.noteOn();
+                }
+                else
+                {
+                    m_isNoteActive = false;
+                    m_envelope.noteOff();
+                }
+            }
+        }
+        else if (source == NoteSource::Sequencer && nextEvent > sample)
+        {
+            // Sequencer steps and gate-offs up to the next MIDI event
+            using Index = MicroAcidParameters::Index;
+            const auto& stepEvents = m_sequencer.process(m_bpm, spanPpq, nextEvent - sample);
+
+            for (const auto& stepEvent : stepEvents)
+            {
+                splitAt(sample + stepEvent.offset);
+
+                if (stepEvent.type == Sequencer::Event::Type::NoteOn)
+                {
+                    m_currentNote = stepEvent.note;
+                    m_currentVelocity = 1.0f;
+                    m_voiceAccent = stepEvent.accent ? 1.0f : 0.0f;
+                    m_isNoteActive = true;
+
+                    // A slid step glides to its pitch and keeps the envelope running
+                    m_oscillator.setSlideTime(stepEvent.slide ? m_snapshot.get(Index::SlideTime) : UNSLID_STEP_SLIDE_TIME);
+                    m_oscillator.setFrequency(midiNoteToFrequency(stepEvent.note));
+                    if (!stepEvent.slide)
+                        m_envelope.noteOn();
+                }
+                else
+                {
+                    m_isNoteActive = false;
+                    m_envelope.noteOff();
+                }
+            }
+        }
+
+        sample = nextEvent;
+
+        // Apply every MIDI event at this position, before the arpeggiator's step for it
+        for (; event != midiMessages.cend() && (*event).samplePosition - midiOffset <= sample
+               && sample < numSamples; ++event)
+        {
+            splitAt(sample);
+            handleMidiMessage((*event).getMessage(), source);
+        }
+    }
+
+    renderVoice(left, right, accent, segmentStart, numSamples);
+
+    // 4-5. Filter with envelope modulation and overdrive, per channel and oversampled
+    const float* envelope = m_oversampling.upsampleControl(m_envelopeBuffer.data(), numSamples);
+
+    m_oversampling.process(left, right, numSamples, [this, envelope](float* const* channels, int numChannels, int numOversampled)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& chain = m_channelChains[static_cast<size_t>(ch)];
+            chain.get<LadderFilter>().setEnvelopeBuffer(envelope);
+            chain.process(channels[ch], numOversampled);
+        }
+    });
+
+    // 6. Effects rack, slots in series
+    m_effects.process(left, right, numSamples);
+
+    // 7-8. Apply output gain and final soft clip
+    float* channels[] = { left, right };
+    const int numChannels = right != nullptr ? 2 : 1;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* output = channels[ch];
+        auto& clipState = m_outputClipStates[static_cast<size_t>(ch)];
+        const Antiderivative::Tanh curve;
+
+        switch (m_outputAntialiasing)
+        {
+            case Antiderivative::Order::First:
+                for (int i = 0; i < numSamples; ++i)
+                    output[i] = clipState.first(curve, output[i] * outputGain[i] * 0.9f);
+                break;
+            case Antiderivative::Order::Second:
+                for (int i = 0; i < numSamples; ++i)
+                    output[i] = clipState.second(curve, output[i] * outputGain[i] * 0.9f);
+                break;
+            case Antiderivative::Order::Off:
+            default:
+                for (int i = 0; i < numSamples; ++i)
+                    output[i] = std::tanh(output[i] * outputGain[i] * 0.9f);
+                break;
+        }
+    }
+}
+
+void MicroAcid303AudioProcessor::renderVoice(float* left, float* right, const float* accent,
+                                             int startSample, int endSample)
+{
+    const int numSamples = endSample - startSample;
+    if (numSamples <= 0)
+        return;
+
+    float* signalLeft = left + startSample;
+    float* signalRight = right != nullptr ? right + startSample : nullptr;
+    float* envelope = m_envelopeBuffer.data() + startSample;
+    accent += startSample;
+
+    // 1. Generate oscillator (mono downmix when there is no right channel)
+    m_oscillator.process(signalLeft, signalRight, numSamples);
+
+    // 2. Get envelope
+    m_envelope.process(envelope, numSamples);
+
+    // 3. Apply envelope to amplitude with accent
+    const float velocity = m_currentVelocity;
+    const float voiceAccent = m_voiceAccent * 0.5f;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float gain = envelope[i] * velocity * (1.0f + accent[i] * voiceAccent);
+        signalLeft[i] *= gain;
+        if (signalRight != nullptr)
+            signalRight[i] *= gain;
+    }
 }
 
 bool MicroAcid303AudioProcessor::hasEditor() const
@@ -350,22 +481,173 @@ void MicroAcid303AudioProcessor::setStateInformation (const void* data, int size
 
     if (xmlState.get() != nullptr)
         if (xmlState->hasTagName (m_parameters.state.getType()))
+        {
             m_parameters.replaceState (juce::ValueTree::fromXml (*xmlState));
+
+            // States saved before the seed existed keep the current one
+            if (m_parameters.state.hasProperty (MicroAcidParameters::IDs::RANDOM_SEED))
+                m_randomSeed.store (static_cast<juce::int64> (m_parameters.state.getProperty (MicroAcidParameters::IDs::RANDOM_SEED)));
+            else
+                setRandomSeed (m_randomSeed.load());
+
+            // States without a (valid) pattern start from the default one
+            Sequencer::Pattern pattern;
+            pattern.fromString (m_parameters.state.getProperty (MicroAcidParameters::IDs::SEQUENCER_PATTERN).toString());
+            setSequencerPattern (pattern);
+
+            // A missing response file leaves the convolution silent but keeps the path
+            const juce::File impulseResponse (m_parameters.state.getProperty (MicroAcidParameters::IDs::IMPULSE_RESPONSE).toString());
+            if (impulseResponse.existsAsFile())
+                loadImpulseResponse (impulseResponse);
+            else
+                m_effects.setImpulseResponse ({});
+        }
+}
+
+void MicroAcid303AudioProcessor::setRandomSeed (juce::int64 seed)
+{
+    m_randomSeed.store (seed);
+    m_parameters.state.setProperty (MicroAcidParameters::IDs::RANDOM_SEED, seed, nullptr);
+}
+
+void MicroAcid303AudioProcessor::setSequencerPattern (const Sequencer::Pattern& pattern)
+{
+    m_sequencer.setPattern (pattern);
+    m_parameters.state.setProperty (MicroAcidParameters::IDs::SEQUENCER_PATTERN, pattern.toString(), nullptr);
 }
 
-void MicroAcid303AudioProcessor::handleMidiMessage(const juce::MidiMessage& message)
+bool MicroAcid303AudioProcessor::loadImpulseResponse (const juce::File& file)
 {
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    // Long responses are read through a memory map rather than streamed
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    if (auto* format = formats.findFormatForFileExtension (file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (file));
+        if (mapped != nullptr && mapped->mapEntireFile())
+            reader = std::move (mapped);
+    }
+
+    if (reader == nullptr)
+        reader.reset (formats.createReaderFor (file));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+        return false;
+
+    const int numChannels = juce::jmin (2, static_cast<int> (reader->numChannels));
+    const auto length = static_cast<int> (juce::jmin (reader->lengthInSamples,
+                                                      static_cast<juce::int64> (MAX_IMPULSE_RESPONSE_SECONDS * reader->sampleRate)));
+
+    juce::AudioBuffer<float> response (numChannels, length);
+    if (! reader->read (&response, 0, length, 0, true, numChannels > 1))
+        return false;
+
+    m_impulseResponse = std::move (response);
+    m_impulseResponseRate = reader->sampleRate;
+    m_impulseResponseFile = file;
+    m_parameters.state.setProperty (MicroAcidParameters::IDs::IMPULSE_RESPONSE, file.getFullPathName(), nullptr);
+
+    applyImpulseResponse();
+    return true;
+}
+
+void MicroAcid303AudioProcessor::clearImpulseResponse()
+{
+    m_impulseResponse.setSize (0, 0);
+    m_impulseResponseFile = juce::File();
+    m_parameters.state.removeProperty (MicroAcidParameters::IDs::IMPULSE_RESPONSE, nullptr);
+
+    applyImpulseResponse();
+}
+
+void MicroAcid303AudioProcessor::applyImpulseResponse()
+{
+    m_appliedImpulseResponseRate = m_sampleRate;
+
+    const int numChannels = m_impulseResponse.getNumChannels();
+    const int sourceLength = m_impulseResponse.getNumSamples();
+    if (numChannels == 0 || sourceLength == 0)
+    {
+        m_effects.setImpulseResponse ({});
+        return;
+    }
+
+    // Resample to the session rate
+    const double ratio = m_impulseResponseRate / m_sampleRate;
+    const int length = juce::jmax (1, static_cast<int> (std::ceil (sourceLength / ratio)));
+
+    juce::AudioBuffer<float> response (numChannels, length);
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        if (ratio == 1.0)
+        {
+            response.copyFrom (channel, 0, m_impulseResponse, channel, 0, sourceLength);
+            continue;
+        }
+
+        juce::LagrangeInterpolator interpolator;
+        interpolator.process (ratio, m_impulseResponse.getReadPointer (channel), response.getWritePointer (channel),
+                              length, sourceLength, 0);
+    }
+
+    // Unit energy on the louder channel, so short cabinets and long rooms sit at a similar level
+    float energy = 0.0f;
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* samples = response.getReadPointer (channel);
+        float channelEnergy = 0.0f;
+        for (int i = 0; i < length; ++i)
+            channelEnergy += samples[i] * samples[i];
+
+        energy = juce::jmax (energy, channelEnergy);
+    }
+
+    if (energy > 0.0f)
+        response.applyGain (1.0f / std::sqrt (energy));
+
+    m_effects.setImpulseResponse (response);
+}
+
+void MicroAcid303AudioProcessor::applyRandomSeed()
+{
+    // Every module draws from its own stream derived from the session seed
+    const auto seed = static_cast<uint64_t>(m_randomSeed.load());
+
+    m_oscillator.setRandomSeed(RandomGenerator::deriveSeed(seed, 0));
+    m_effects.setRandomSeed(RandomGenerator::deriveSeed(seed, 1));
+    m_arpeggiator.setRandomSeed(RandomGenerator::deriveSeed(seed, 2));
+}
+
+void MicroAcid303AudioProcessor::handleMidiMessage(const juce::MidiMessage& message, NoteSource source)
+{
+    // The sequencer plays its own notes
+    if (source == NoteSource::Sequencer)
+        return;
+
+    if (source == NoteSource::Arpeggiator)
+    {
+        // Feed notes to arpeggiator
+        if (message.isNoteOn())
+            m_arpeggiator.noteOn(message.getNoteNumber(), message.getVelocity() / 127.0f);
+        else if (message.isNoteOff())
+            m_arpeggiator.noteOff(message.getNoteNumber());
+        else if (message.isAllNotesOff())
+            m_arpeggiator.allNotesOff();
+
+        return;
+    }
+
+    // Direct MIDI handling
     if (message.isNoteOn())
     {
         m_currentNote = message.getNoteNumber();
         m_currentVelocity = message.getVelocity() / 127.0f;
         m_isNoteActive = true;
 
-        if (m_oscillator)
-            m_oscillator->setFrequency(midiNoteToFrequency(m_currentNote));
-
-        if (m_envelope)
-            m_envelope->noteOn();
+        m_oscillator.setFrequency(midiNoteToFrequency(m_currentNote));
+        m_envelope.noteOn();
     }
     else if (message.isNoteOff())
     {
@@ -375,8 +657,7 @@ void MicroAcid303AudioProcessor::handleMidiMessage(const juce::MidiMessage& mess
             m_currentNote = -1;
             m_currentVelocity = 0.0f;
 
-            if (m_envelope)
-                m_envelope->noteOff();
+            m_envelope.noteOff();
         }
     }
     else if (message.isAllNotesOff())
@@ -385,151 +666,190 @@ void MicroAcid303AudioProcessor::handleMidiMessage(const juce::MidiMessage& mess
         m_currentNote = -1;
         m_currentVelocity = 0.0f;
 
-        if (m_envelope)
-            m_envelope->noteOff();
-
-        if (m_arpeggiator)
-            m_arpeggiator->allNotesOff();
+        m_envelope.noteOff();
+        m_arpeggiator.allNotesOff();
     }
 }
 
+void MicroAcid303AudioProcessor::applyParameterChanges()
+{
+    using Group = MicroAcidParameters::Group;
+
+    if (consumeGroupChange(Group::Oscillator))  updateOscillatorParameters();
+    if (consumeGroupChange(Group::Envelope))    updateEnvelopeParameters();
+    if (consumeGroupChange(Group::Filter))      updateFilterParameters();
+    if (consumeGroupChange(Group::Overdrive))   updateOverdriveParameters();
+    if (consumeGroupChange(Group::Effects))     updateEffectsParameters();
+    if (consumeGroupChange(Group::Arpeggiator)) updateArpeggiatorParameters();
+    if (consumeGroupChange(Group::Sequencer))   updateSequencerParameters();
+    if (consumeGroupChange(Group::Oversampling)) updateOversamplingParameters();
+}
+
+bool MicroAcid303AudioProcessor::consumeGroupChange(MicroAcidParameters::Group group)
+{
+    auto& applied = m_appliedVersions[MicroAcidParameters::toIndex(group)];
+    const auto current = m_snapshot.getVersion(group);
+
+    if (applied == current)
+        return false;
+
+    applied = current;
+    return true;
+}
+
 void MicroAcid303AudioProcessor::updateOscillatorParameters()
 {
-    if (!m_oscillator) return;
+    using Index = MicroAcidParameters::Index;
 
-    // Waveform
-    auto* waveformParam = dynamic_cast<juce::AudioParameterChoice*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::WAVEFORM));
-    if (waveformParam)
-        m_oscillator->setWaveform(waveformParam->getIndex());
+    m_oscillator.setWaveform(m_snapshot.getInt(Index::Waveform));
+    m_oscillator.setFineTune(m_snapshot.get(Index::FineTune));
 
-    // Fine tune
-    auto* fineTuneParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::FINE_TUNE));
-    if (fineTuneParam)
-        m_oscillator->setFineTune(fineTuneParam->get());
+    // The sequencer sets the slide time per step
+    if (!m_snapshot.getBool(Index::SeqEnabled))
+        m_oscillator.setSlideTime(m_snapshot.get(Index::SlideTime));
 
-    // Slide time
-    auto* slideParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::SLIDE_TIME));
-    if (slideParam)
-        m_oscillator->setSlideTime(slideParam->get());
+    m_oscillator.setSuperSawVoices(m_snapshot.getInt(Index::SuperSawVoices));
+    m_oscillator.setSuperSawDetune(m_snapshot.get(Index::SuperSawDetune));
+    m_oscillator.setSuperSawMix(m_snapshot.get(Index::SuperSawMix));
+    m_oscillator.setSuperSawSpread(m_snapshot.get(Index::SuperSawSpread));
 }
 
 void MicroAcid303AudioProcessor::updateEnvelopeParameters()
 {
-    if (!m_envelope) return;
+    using Index = MicroAcidParameters::Index;
 
-    auto* decayParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::DECAY));
-    if (decayParam)
-    {
-        float decayTime = decayParam->get();
-        m_envelope->setAttack(0.001f);
-        m_envelope->setDecay(decayTime);
-        m_envelope->setSustain(0.0f);
-        m_envelope->setRelease(0.01f);
-    }
+    float decayTime = m_snapshot.get(Index::Decay);
+    m_envelope.setAttack(0.001f);
+    m_envelope.setDecay(decayTime);
+    m_envelope.setSustain(0.0f);
+    m_envelope.setRelease(0.01f);
 
-    auto* accentParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::ACCENT));
-    if (accentParam)
-        m_accentAmount = accentParam->get();
+    m_accentSmoother.setTarget(m_snapshot.get(Index::Accent));
 }
 
 void MicroAcid303AudioProcessor::updateFilterParameters()
 {
-    if (!m_filter) return;
-
-    auto* cutoffParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::CUTOFF));
-    if (cutoffParam)
-        m_filter->setCutoff(cutoffParam->get());
+    using Index = MicroAcidParameters::Index;
 
-    auto* resonanceParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::RESONANCE));
-    if (resonanceParam)
-        m_filter->setResonance(resonanceParam->get());
-
-    auto* envModParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::ENV_MOD));
-    if (envModParam)
-        m_filter->setEnvelopeAmount(envModParam->get());
+    for (auto& chain : m_channelChains)
+    {
+        auto& filter = chain.get<LadderFilter>();
+        filter.setCutoff(m_snapshot.get(Index::Cutoff));
+        filter.setResonance(m_snapshot.get(Index::Resonance));
+        filter.setEnvelopeAmount(m_snapshot.get(Index::EnvMod));
+        filter.setModel(m_snapshot.getInt(Index::FilterModel));
+        filter.setQuality(m_snapshot.getInt(Index::FilterQuality));
+    }
 }
 
 void MicroAcid303AudioProcessor::updateOverdriveParameters()
 {
-    if (!m_overdrive) return;
+    using Index = MicroAcidParameters::Index;
+
+    // Unity drive is skipped inside the stage once its curve table has caught up
+    for (auto& chain : m_channelChains)
+    {
+        auto& overdrive = chain.get<Overdrive>();
+        overdrive.setDrive(m_snapshot.get(Index::Drive));
+        overdrive.setMode(m_snapshot.getInt(Index::DriveMode));
+        overdrive.setAntialiasing(m_snapshot.getInt(Index::DriveAntialiasing));
+    }
 
-    auto* driveParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::DRIVE));
-    if (driveParam)
-        m_overdrive->setDrive(driveParam->get());
+    // The output clipper follows the same setting; its history restarts on a change
+    const auto antialiasing = static_cast<Antiderivative::Order>(
+        juce::jlimit(0, 2, m_snapshot.getInt(Index::DriveAntialiasing)));
 
-    auto* driveModeParam = dynamic_cast<juce::AudioParameterChoice*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::DRIVE_MODE));
-    if (driveModeParam)
-        m_overdrive->setMode(driveModeParam->getIndex());
+    if (antialiasing != m_outputAntialiasing)
+    {
+        m_outputAntialiasing = antialiasing;
+        for (auto& state : m_outputClipStates)
+            state.reset();
+    }
 }
 
 void MicroAcid303AudioProcessor::updateEffectsParameters()
 {
-    if (!m_effects) return;
+    static_assert(MicroAcidParameters::NUM_FX_SLOTS == EffectsRack::NUM_SLOTS, "One parameter set per rack slot");
+
+    for (int s = 0; s < EffectsRack::NUM_SLOTS; ++s)
+    {
+        const auto& parameters = MicroAcidParameters::FX_SLOTS[static_cast<size_t>(s)];
+        auto& effects = m_effects.getSlot(s);
+
+        effects.setType(m_snapshot.getInt(parameters.type));
+        effects.setTime(m_snapshot.get(parameters.time));
+        effects.setFeedback(m_snapshot.get(parameters.feedback));
+        effects.setMix(m_snapshot.get(parameters.mix));
+        m_effects.setBypassed(s, m_snapshot.getBool(parameters.bypass));
+    }
+}
+
+void MicroAcid303AudioProcessor::updateArpeggiatorParameters()
+{
+    using Index = MicroAcidParameters::Index;
+
+    m_arpeggiator.setEnabled(m_snapshot.getBool(Index::ArpEnabled));
+    m_arpeggiator.setMode(m_snapshot.getInt(Index::ArpMode));
+    m_arpeggiator.setDivision(m_snapshot.getInt(Index::ArpDivision));
+    m_arpeggiator.setGate(m_snapshot.get(Index::ArpGate));
+    m_arpeggiator.setOctaves(m_snapshot.getInt(Index::ArpOctaves));
+    m_arpeggiator.setSwing(m_snapshot.get(Index::ArpSwing));
+}
+
+void MicroAcid303AudioProcessor::updateSequencerParameters()
+{
+    using Index = MicroAcidParameters::Index;
+
+    const bool enabled = m_snapshot.getBool(Index::SeqEnabled);
+
+    // Switching off releases the sequenced note and hands the voice back
+    if (!enabled && m_sequencer.isEnabled())
+    {
+        m_sequencer.reset();
+        m_isNoteActive = false;
+        m_voiceAccent = 1.0f;
+        m_envelope.noteOff();
+        m_oscillator.setSlideTime(m_snapshot.get(Index::SlideTime));
+    }
+
+    m_sequencer.setEnabled(enabled);
+    m_sequencer.setShuffle(m_snapshot.get(Index::SeqShuffle));
+}
+
+void MicroAcid303AudioProcessor::updateOversamplingParameters()
+{
+    using Index = MicroAcidParameters::Index;
 
-    auto* fxTypeParam = dynamic_cast<juce::AudioParameterChoice*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::FX_TYPE));
-    if (fxTypeParam)
-        m_effects->setType(fxTypeParam->getIndex());
+    const int previousFactor = m_oversampling.getFactor();
 
-    auto* fxTimeParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::FX_TIME));
-    if (fxTimeParam)
-        m_effects->setTime(fxTimeParam->get());
+    m_oversampling.setFactor(m_snapshot.getInt(Index::Oversampling));
+    m_oversampling.setFilterType(m_snapshot.getInt(Index::OversamplingFilter));
 
-    auto* fxFeedbackParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::FX_FEEDBACK));
-    if (fxFeedbackParam)
-        m_effects->setFeedback(fxFeedbackParam->get());
+    // The filter and overdrive move to the new rate with their state intact
+    if (m_oversampling.getFactor() != previousFactor)
+        for (auto& chain : m_channelChains)
+            chain.setSampleRate(m_oversampling.getOversampledRate());
 
-    auto* fxMixParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::FX_MIX));
-    if (fxMixParam)
-        m_effects->setMix(fxMixParam->get());
+    if (m_oversampling.getLatencySamples() != getLatencySamples())
+        setLatencySamples(m_oversampling.getLatencySamples());
 }
 
-void MicroAcid303AudioProcessor::updateArpeggiatorParameters()
+void MicroAcid303AudioProcessor::prepareChannelChains()
 {
-    if (!m_arpeggiator) return;
-
-    auto* arpEnabledParam = dynamic_cast<juce::AudioParameterBool*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::ARP_ENABLED));
-    if (arpEnabledParam)
-        m_arpeggiator->setEnabled(arpEnabledParam->get());
-
-    auto* arpModeParam = dynamic_cast<juce::AudioParameterChoice*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::ARP_MODE));
-    if (arpModeParam)
-        m_arpeggiator->setMode(arpModeParam->getIndex());
-
-    auto* arpDivParam = dynamic_cast<juce::AudioParameterChoice*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::ARP_DIVISION));
-    if (arpDivParam)
-        m_arpeggiator->setDivision(arpDivParam->getIndex());
-
-    auto* arpGateParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::ARP_GATE));
-    if (arpGateParam)
-        m_arpeggiator->setGate(arpGateParam->get());
-
-    auto* arpOctParam = dynamic_cast<juce::AudioParameterInt*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::ARP_OCTAVES));
-    if (arpOctParam)
-        m_arpeggiator->setOctaves(arpOctParam->get());
-
-    auto* arpSwingParam = dynamic_cast<juce::AudioParameterFloat*>(
-        m_parameters.getParameter(MicroAcidParameters::IDs::ARP_SWING));
-    if (arpSwingParam)
-        m_arpeggiator->setSwing(arpSwingParam->get());
+    // Prepared at the host rate for the largest oversampled block, with filter
+    // tables for every factor, so switching factor on the audio thread only
+    // swaps tables and ramp lengths instead of reallocating and resetting
+    static_assert(OversamplingStage::MAX_FACTOR <= LadderFilter::MAX_RATE_FACTOR,
+                  "The filter needs a cutoff table for every oversampling factor");
+
+    const int maxBlock = m_samplesPerBlock * OversamplingStage::MAX_FACTOR;
+
+    for (auto& chain : m_channelChains)
+    {
+        chain.get<LadderFilter>().setMaxRateFactor(OversamplingStage::MAX_FACTOR);
+        chain.prepare(m_sampleRate, maxBlock);
+        chain.setSampleRate(m_oversampling.getOversampledRate());
+    }
 }
 
 float MicroAcid303AudioProcessor::midiNoteToFrequency(int midiNote)
@@ -6,12 +6,18 @@
 #include <atomic>
 #include <array>
 #include "core/Parameters.h"
+#include "core/ParameterSnapshot.h"
+#include "core/SignalChain.h"
+#include "core/SmoothedParameter.h"
 #include "dsp/Oscillator.h"
 #include "dsp/Envelope.h"
 #include "dsp/LadderFilter.h"
 #include "dsp/Overdrive.h"
-#include "dsp/Effects.h"
+#include "dsp/Antiderivative.h"
+#include "dsp/OversamplingStage.h"
+#include "dsp/EffectsRack.h"
 #include "dsp/Arpeggiator.h"
+#include "dsp/Sequencer.h"
 
 /**
  * Main audio processor for the 303 Micro Acid plugin.
@@ -52,6 +58,31 @@ public:
 
     juce::AudioProcessorValueTreeState& getValueTreeState() { return m_parameters; }
 
+    /**
+     * Seed for noise, tape flutter and the random arp mode. It is saved with the
+     * plugin state and applied on the next prepareToPlay(), so offline bounces of
+     * the same session are bit-identical.
+     */
+    void setRandomSeed(juce::int64 seed);
+    juce::int64 getRandomSeed() const { return m_randomSeed.load(); }
+
+    /**
+     * Internal sequencer pattern (message thread). Edits reach the audio thread
+     * through a wait-free hand-off and are saved with the plugin state.
+     */
+    void setSequencerPattern(const Sequencer::Pattern& pattern);
+    const Sequencer::Pattern& getSequencerPattern() const { return m_sequencer.getPattern(); }
+    int getSequencerStep() const { return m_sequencer.getPlayingStep(); }
+
+    /**
+     * Impulse response for the convolution effect (message thread). Loads the
+     * first two channels of an audio file, resampled to the session rate; the
+     * file path is saved with the plugin state. Returns false if unreadable.
+     */
+    bool loadImpulseResponse(const juce::File& file);
+    void clearImpulseResponse();
+    juce::File getImpulseResponseFile() const { return m_impulseResponseFile; }
+
     //==============================================================================
     // Visualization data access (thread-safe)
     float getOutputPeakL() const { return m_outputPeakL.load(); }
@@ -72,34 +103,86 @@ public:
     juce::MidiKeyboardState& getKeyboardState() { return m_keyboardState; }
 
 private:
-    void handleMidiMessage(const juce::MidiMessage& message);
+    /** What plays the voice - MIDI notes directly, the arpeggiator, or the internal sequencer. */
+    enum class NoteSource { Midi, Arpeggiator, Sequencer };
+
+    void handleMidiMessage(const juce::MidiMessage& message, NoteSource source);
+    void applyParameterChanges();
+    void applyRandomSeed();
+    void applyImpulseResponse();
+    bool consumeGroupChange(MicroAcidParameters::Group group);
+    bool isChainSilent(NoteSource source) const;
+    void renderBlock(float* left, float* right, int numSamples, double ppqPosition, NoteSource source,
+                     const juce::MidiBuffer& midiMessages, int midiOffset);
+    void renderVoice(float* left, float* right, const float* accent, int startSample, int endSample);
     void updateOscillatorParameters();
     void updateEnvelopeParameters();
     void updateFilterParameters();
     void updateOverdriveParameters();
     void updateEffectsParameters();
     void updateArpeggiatorParameters();
+    void updateSequencerParameters();
+    void updateOversamplingParameters();
+    void prepareChannelChains();
     float midiNoteToFrequency(int midiNote);
 
     juce::AudioProcessorValueTreeState m_parameters;
 
-    // DSP modules
-    std::unique_ptr<Oscillator> m_oscillator;
-    std::unique_ptr<Envelope> m_envelope;
-    std::unique_ptr<LadderFilter> m_filter;
-    std::unique_ptr<Overdrive> m_overdrive;
-    std::unique_ptr<Effects> m_effects;
-    std::unique_ptr<Arpeggiator> m_arpeggiator;
+    // Index-based parameter access for the audio thread
+    ParameterCache m_parameterCache;
+    ParameterSnapshot m_snapshot;
+    std::array<uint32_t, MicroAcidParameters::NUM_GROUPS> m_appliedVersions{};
+
+    // DSP modules (stored inline - the voice is rendered per MIDI/arp event segment,
+    // the rest of the chain runs over the whole block). Filter and overdrive
+    // run once per output channel so the SuperSaw stereo spread survives them,
+    // inside the optional oversampled region.
+    using ChannelChain = SignalChain<LadderFilter, Overdrive>;
+
+    Oscillator m_oscillator;
+    Envelope m_envelope;
+    OversamplingStage m_oversampling;
+    std::array<ChannelChain, 2> m_channelChains;
+    EffectsRack m_effects;
+    Arpeggiator m_arpeggiator;
+    Sequencer m_sequencer;
+
+    // Scratch buffers for block processing (sized in prepareToPlay)
+    std::vector<float> m_envelopeBuffer;
+
+    // Set once a block renders silent with every stage silent; the next blocks
+    // skip the chain until a MIDI event or a sounding stage wakes it
+    bool m_isAsleep = false;
 
     // Voice state (monophonic)
     int m_currentNote = -1;
     float m_currentVelocity = 0.0f;
     bool m_isNoteActive = false;
-    float m_accentAmount = 0.0f;
+    float m_voiceAccent = 1.0f;     // Scales the accent amount - per step when sequenced
 
-    // Playhead info for arpeggiator
+    // Output soft clipper with the same anti-aliasing as the overdrive
+    Antiderivative::Order m_outputAntialiasing = Antiderivative::Order::Off;
+    std::array<Antiderivative::State, 2> m_outputClipStates;
+
+    // Output-stage parameter ramps
+    SmoothedParameter m_outputGainSmoother{SmoothedParameter::Curve::Multiplicative};
+    SmoothedParameter m_accentSmoother;
+    static constexpr float PARAMETER_RAMP_TIME = 0.02f;   // 20ms
+    static constexpr float UNSLID_STEP_SLIDE_TIME = 0.001f; // Sequenced steps without slide jump to pitch
+
+    // Playhead info for arpeggiator and sequencer
     double m_bpm = 120.0;
-    int64_t m_samplePosition = 0;
+    double m_ppqPosition = 0.0;     // Host position in quarter notes, free-running when stopped
+
+    // Seed shared with the state tree (applied in prepareToPlay)
+    std::atomic<juce::int64> m_randomSeed{0};
+
+    // Convolution response as loaded; resampled whenever the session rate changes
+    juce::AudioBuffer<float> m_impulseResponse;
+    double m_impulseResponseRate = 44100.0;
+    double m_appliedImpulseResponseRate = 0.0;
+    juce::File m_impulseResponseFile;
+    static constexpr double MAX_IMPULSE_RESPONSE_SECONDS = 10.0;
 
     // Sample rate storage
     double m_sampleRate = 44100.0;
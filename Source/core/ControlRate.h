@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+
+/**
+ * Control-rate coefficient updates.
+ *
+ * Expensive coefficients (tan prewarping, exponential frequency modulation,
+ * LFO-driven allpass coefficients) are evaluated once every N samples at the
+ * last sample of each segment and linearly interpolated in between. An interval
+ * of 1 reproduces the per-sample path exactly.
+ */
+namespace ControlRate
+{
+    inline constexpr int DEFAULT_INTERVAL = 16;
+    inline constexpr int MAX_INTERVAL = 32;
+
+    /** Rounds an interval down to a power of two between 1 and MAX_INTERVAL (1, 2, 4 ... 32). */
+    inline int clampInterval(int samples) noexcept
+    {
+        int interval = 1;
+        while (interval * 2 <= std::min(samples, MAX_INTERVAL))
+            interval *= 2;
+        return interval;
+    }
+}
+
+/**
+ * A coefficient that is set at control rate and read at audio rate.
+ *
+ * setTarget() starts a linear segment of numSamples steps; next() returns the
+ * following value and lands exactly on the target at the end of the segment.
+ */
+class InterpolatedCoefficient
+{
+public:
+    void reset(float value) noexcept
+    {
+        m_current = value;
+        m_target = value;
+        m_step = 0.0f;
+        m_remaining = 0;
+    }
+
+    void setTarget(float target, int numSamples) noexcept
+    {
+        m_target = target;
+        m_remaining = std::max(1, numSamples);
+        m_step = (target - m_current) / static_cast<float>(m_remaining);
+    }
+
+    float next() noexcept
+    {
+        if (m_remaining <= 1)
+        {
+            m_remaining = 0;
+            return m_current = m_target;
+        }
+
+        --m_remaining;
+        return m_current += m_step;
+    }
+
+    float getCurrentValue() const noexcept { return m_current; }
+
+private:
+    float m_current = 0.0f;
+    float m_target = 0.0f;
+    float m_step = 0.0f;
+    int m_remaining = 0;
+};
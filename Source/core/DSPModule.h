@@ -11,6 +11,9 @@
 class DSPModule
 {
 public:
+    /** Level below which a module's output and state count as silent (-100dB). */
+    static constexpr float SILENCE_THRESHOLD = 1.0e-5f;
+
     virtual ~DSPModule() = default;
 
     /**
@@ -41,4 +44,31 @@ public:
      * @return Processed output sample
      */
     virtual float processSample(float input) = 0;
+
+    /**
+     * Process a block of samples in place.
+     * Generators overwrite the buffer, processors transform it.
+     *
+     * The default implementation falls back to processSample(). Modules on the
+     * hot path override it so per-block work is hoisted out of the sample loop.
+     *
+     * @param data Buffer holding numSamples samples
+     * @param numSamples Number of samples to process (at most samplesPerBlock)
+     */
+    virtual void process(float* data, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = processSample(data[i]);
+    }
+
+    /**
+     * Whether the module would output silence for silent input: everything it
+     * holds (levels, filter states, delay lines) has decayed below
+     * SILENCE_THRESHOLD. The host skips the chain while every stage reports
+     * silence, so a module must only return true when skipping it is inaudible.
+     *
+     * Audio thread only. The default is the safe answer for generators and
+     * modules that do not track their state.
+     */
+    virtual bool isSilent() const { return false; }
 };
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+ #include <intrin.h>
+#endif
+
+/**
+ * Fixed-capacity set of held MIDI notes for the arpeggiator.
+ *
+ * Membership is a 128-bit bitset, so insert, remove and lookup are O(1) and
+ * sorted access is a bit scan over two words. Velocities live in a per-note
+ * array. Press order is kept in a 128-entry ring; removing a note closes the
+ * gap from the nearer end, so releasing the oldest or newest note is O(1).
+ *
+ * Nothing is allocated - the whole set is under 1 KB of fixed arrays - so
+ * every call is safe on the audio thread.
+ */
+class HeldNoteSet
+{
+public:
+    static constexpr int NUM_NOTES = 128;
+
+    /** Adds a note, or updates its velocity if already held. Returns true if it was newly added. */
+    bool insert(int note, float velocity) noexcept
+    {
+        if (!isValid(note))
+            return false;
+
+        m_velocities[static_cast<size_t>(note)] = velocity;
+        if (contains(note))
+            return false;
+
+        m_bits[wordOf(note)] |= bitOf(note);
+        orderAt(m_size) = static_cast<uint8_t>(note);
+        ++m_size;
+        return true;
+    }
+
+    /** Removes a note. Returns true if it was held. */
+    bool remove(int note) noexcept
+    {
+        if (!contains(note))
+            return false;
+
+        m_bits[wordOf(note)] &= ~bitOf(note);
+
+        // Close the gap in press order from the nearer end
+        int i = 0;
+        while (orderAt(i) != note)
+            ++i;
+
+        if (i < m_size / 2)
+        {
+            for (; i > 0; --i)
+                orderAt(i) = orderAt(i - 1);
+
+            m_orderStart = (m_orderStart + 1) & ORDER_MASK;
+        }
+        else
+        {
+            for (; i < m_size - 1; ++i)
+                orderAt(i) = orderAt(i + 1);
+        }
+
+        --m_size;
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        m_bits = {};
+        m_size = 0;
+        m_orderStart = 0;
+    }
+
+    bool contains(int note) const noexcept
+    {
+        return isValid(note) && (m_bits[wordOf(note)] & bitOf(note)) != 0;
+    }
+
+    int size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    float getVelocity(int note) const noexcept
+    {
+        return contains(note) ? m_velocities[static_cast<size_t>(note)] : 0.0f;
+    }
+
+    /** The index-th lowest held note (0 <= index < size()). */
+    int getSorted(int index) const noexcept
+    {
+        const int lowCount = popCount(m_bits[0]);
+        if (index < lowCount)
+            return selectBit(m_bits[0], index);
+
+        return 64 + selectBit(m_bits[1], index - lowCount);
+    }
+
+    /** The index-th held note in the order the notes were pressed (0 <= index < size()). */
+    int getInOrder(int index) const noexcept
+    {
+        return m_order[static_cast<size_t>((m_orderStart + index) & ORDER_MASK)];
+    }
+
+    /** Calls function(note, velocity) for every held note, lowest first. */
+    template <typename Function>
+    void forEachSorted(Function&& function) const
+    {
+        for (int word = 0; word < 2; ++word)
+        {
+            for (uint64_t bits = m_bits[static_cast<size_t>(word)]; bits != 0; bits &= bits - 1)
+            {
+                const int note = word * 64 + lowestBit(bits);
+                function(note, m_velocities[static_cast<size_t>(note)]);
+            }
+        }
+    }
+
+private:
+    static constexpr int ORDER_MASK = NUM_NOTES - 1;
+
+    uint8_t& orderAt(int index) noexcept { return m_order[static_cast<size_t>((m_orderStart + index) & ORDER_MASK)]; }
+
+    static bool isValid(int note) noexcept { return note >= 0 && note < NUM_NOTES; }
+    static size_t wordOf(int note) noexcept { return static_cast<size_t>(note >> 6); }
+    static uint64_t bitOf(int note) noexcept { return uint64_t(1) << (note & 63); }
+
+    static int popCount(uint64_t bits) noexcept
+    {
+       #if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(bits));
+       #else
+        return __builtin_popcountll(bits);
+       #endif
+    }
+
+    static int lowestBit(uint64_t bits) noexcept
+    {
+       #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+       #else
+        return __builtin_ctzll(bits);
+       #endif
+    }
+
+    // Position of the index-th set bit, lowest first
+    static int selectBit(uint64_t bits, int index) noexcept
+    {
+        for (int i = 0; i < index; ++i)
+            bits &= bits - 1;
+
+        return lowestBit(bits);
+    }
+
+    std::array<uint64_t, 2> m_bits{};
+    std::array<float, NUM_NOTES> m_velocities{};
+    std::array<uint8_t, NUM_NOTES> m_order{};    // Ring of notes in press order
+    int m_orderStart = 0;
+    int m_size = 0;
+};
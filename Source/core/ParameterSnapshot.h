@@ -0,0 +1,80 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "Parameters.h"
+
+/**
+ * Flat, cache-aligned copy of every parameter value for one processBlock() call.
+ *
+ * Values are stored in REGISTRY order and in plain units (choices as their index,
+ * bools as 0/1). Each Group carries a version that changes whenever one of its
+ * parameters changed, so consumers can skip re-applying unchanged groups.
+ */
+struct alignas(64) ParameterSnapshot
+{
+    using Index = MicroAcidParameters::Index;
+    using Group = MicroAcidParameters::Group;
+
+    std::array<float, MicroAcidParameters::NUM_PARAMETERS> values{};
+    std::array<uint32_t, MicroAcidParameters::NUM_GROUPS> versions{};
+
+    float get(Index index) const noexcept { return values[MicroAcidParameters::toIndex(index)]; }
+    int getInt(Index index) const noexcept { return juce::roundToInt(get(index)); }
+    bool getBool(Index index) const noexcept { return get(index) >= 0.5f; }
+
+    uint32_t getVersion(Group group) const noexcept { return versions[MicroAcidParameters::toIndex(group)]; }
+};
+
+/**
+ * Caches the raw std::atomic<float>* of every registered parameter so the audio
+ * thread never performs string lookups or dynamic_casts.
+ *
+ * Construct on the message thread once the AudioProcessorValueTreeState exists,
+ * then call update() at the start of each block.
+ */
+class ParameterCache
+{
+public:
+    explicit ParameterCache(juce::AudioProcessorValueTreeState& state)
+    {
+        for (const auto& info : MicroAcidParameters::REGISTRY)
+        {
+            auto* value = state.getRawParameterValue(info.id);
+            jassert(value != nullptr);
+            m_values[MicroAcidParameters::toIndex(info.index)] = value;
+        }
+    }
+
+    /** Copies all current values into the snapshot and bumps the version of changed groups. */
+    void update(ParameterSnapshot& snapshot) noexcept
+    {
+        std::array<bool, MicroAcidParameters::NUM_GROUPS> changed{};
+
+        for (const auto& info : MicroAcidParameters::REGISTRY)
+        {
+            const auto index = MicroAcidParameters::toIndex(info.index);
+            const float value = m_values[index]->load(std::memory_order_relaxed);
+
+            if (value != snapshot.values[index] || m_isFirstUpdate)
+            {
+                snapshot.values[index] = value;
+                changed[MicroAcidParameters::toIndex(info.group)] = true;
+            }
+        }
+
+        for (size_t group = 0; group < MicroAcidParameters::NUM_GROUPS; ++group)
+            if (changed[group])
+                ++snapshot.versions[group];
+
+        m_isFirstUpdate = false;
+    }
+
+private:
+    std::array<std::atomic<float>*, MicroAcidParameters::NUM_PARAMETERS> m_values{};
+    bool m_isFirstUpdate = true;
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterCache)
+};
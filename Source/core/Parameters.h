@@ -3,260 +3,431 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_core/juce_core.h>
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <cstddef>
 
 /**
  * Central parameter definitions for the 303 Micro Acid plugin.
+ *
+ * Every parameter is described once in the compile-time REGISTRY table below.
+ * The audio thread addresses parameters by Index rather than by string ID.
  */
 namespace MicroAcidParameters
 {
     namespace IDs
     {
         // Oscillator
-        const juce::String WAVEFORM            = "waveform";
-        const juce::String FINE_TUNE           = "fineTune";
+        inline constexpr const char* WAVEFORM            = "waveform";
+        inline constexpr const char* FINE_TUNE           = "fineTune";
+        inline constexpr const char* SUPERSAW_VOICES     = "superSawVoices";
+        inline constexpr const char* SUPERSAW_DETUNE     = "superSawDetune";
+        inline constexpr const char* SUPERSAW_MIX        = "superSawMix";
+        inline constexpr const char* SUPERSAW_SPREAD     = "superSawSpread";
 
         // Filter
-        const juce::String CUTOFF              = "cutoff";
-        const juce::String RESONANCE           = "resonance";
-        const juce::String ENV_MOD             = "envMod";
+        inline constexpr const char* CUTOFF              = "cutoff";
+        inline constexpr const char* RESONANCE           = "resonance";
+        inline constexpr const char* ENV_MOD             = "envMod";
+        inline constexpr const char* FILTER_MODEL        = "filterModel";
+        inline constexpr const char* FILTER_QUALITY      = "filterQuality";
 
         // Envelope
-        const juce::String DECAY               = "decay";
-        const juce::String ACCENT              = "accent";
+        inline constexpr const char* DECAY               = "decay";
+        inline constexpr const char* ACCENT              = "accent";
 
         // Slide
-        const juce::String SLIDE_TIME          = "slideTime";
+        inline constexpr const char* SLIDE_TIME          = "slideTime";
 
         // Overdrive
-        const juce::String DRIVE               = "drive";
-        const juce::String DRIVE_MODE          = "driveMode";
+        inline constexpr const char* DRIVE               = "drive";
+        inline constexpr const char* DRIVE_MODE          = "driveMode";
+        inline constexpr const char* DRIVE_ANTIALIASING  = "driveAntialiasing";
 
         // Effects
-        const juce::String FX_TYPE             = "fxType";
-        const juce::String FX_TIME             = "fxTime";
-        const juce::String FX_FEEDBACK         = "fxFeedback";
-        const juce::String FX_MIX              = "fxMix";
+        inline constexpr const char* FX_TYPE             = "fxType";
+        inline constexpr const char* FX_TIME             = "fxTime";
+        inline constexpr const char* FX_FEEDBACK         = "fxFeedback";
+        inline constexpr const char* FX_MIX              = "fxMix";
+        inline constexpr const char* FX_BYPASS           = "fxBypass";
+
+        // Effects rack slots 2-4 (slot 1 uses the FX_* parameters above)
+        inline constexpr const char* FX2_TYPE            = "fx2Type";
+        inline constexpr const char* FX2_TIME            = "fx2Time";
+        inline constexpr const char* FX2_FEEDBACK        = "fx2Feedback";
+        inline constexpr const char* FX2_MIX             = "fx2Mix";
+        inline constexpr const char* FX2_BYPASS          = "fx2Bypass";
+        inline constexpr const char* FX3_TYPE            = "fx3Type";
+        inline constexpr const char* FX3_TIME            = "fx3Time";
+        inline constexpr const char* FX3_FEEDBACK        = "fx3Feedback";
+        inline constexpr const char* FX3_MIX             = "fx3Mix";
+        inline constexpr const char* FX3_BYPASS          = "fx3Bypass";
+        inline constexpr const char* FX4_TYPE            = "fx4Type";
+        inline constexpr const char* FX4_TIME            = "fx4Time";
+        inline constexpr const char* FX4_FEEDBACK        = "fx4Feedback";
+        inline constexpr const char* FX4_MIX             = "fx4Mix";
+        inline constexpr const char* FX4_BYPASS          = "fx4Bypass";
 
         // Arpeggiator
-        const juce::String ARP_ENABLED         = "arpEnabled";
-        const juce::String ARP_MODE            = "arpMode";
-        const juce::String ARP_DIVISION        = "arpDivision";
-        const juce::String ARP_GATE            = "arpGate";
-        const juce::String ARP_OCTAVES         = "arpOctaves";
-        const juce::String ARP_SWING           = "arpSwing";
+        inline constexpr const char* ARP_ENABLED         = "arpEnabled";
+        inline constexpr const char* ARP_MODE            = "arpMode";
+        inline constexpr const char* ARP_DIVISION        = "arpDivision";
+        inline constexpr const char* ARP_GATE            = "arpGate";
+        inline constexpr const char* ARP_OCTAVES         = "arpOctaves";
+        inline constexpr const char* ARP_SWING           = "arpSwing";
+
+        // Sequencer
+        inline constexpr const char* SEQ_ENABLED         = "seqEnabled";
+        inline constexpr const char* SEQ_SHUFFLE         = "seqShuffle";
 
         // Output
-        const juce::String OUTPUT_GAIN         = "outputGain";
+        inline constexpr const char* OUTPUT_GAIN         = "outputGain";
+
+        // Oversampling (filter and overdrive)
+        inline constexpr const char* OVERSAMPLING        = "oversampling";
+        inline constexpr const char* OVERSAMPLING_FILTER = "oversamplingFilter";
+
+        // State properties (saved with the plugin state, not host parameters)
+        inline constexpr const char* RANDOM_SEED         = "randomSeed";
+        inline constexpr const char* SEQUENCER_PATTERN   = "sequencerPattern";
+        inline constexpr const char* IMPULSE_RESPONSE    = "impulseResponse";
     }
 
-    inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
+    /** Position of each parameter in REGISTRY and in ParameterSnapshot. */
+    enum class Index : int
     {
-        std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+        Waveform = 0,
+        FineTune,
+        Cutoff,
+        Resonance,
+        EnvMod,
+        Decay,
+        Accent,
+        SlideTime,
+        Drive,
+        DriveMode,
+        FxType,
+        FxTime,
+        FxFeedback,
+        FxMix,
+        ArpEnabled,
+        ArpMode,
+        ArpDivision,
+        ArpGate,
+        ArpOctaves,
+        ArpSwing,
+        OutputGain,
+
+        // Added after the original set - appended to keep host parameter order stable
+        SuperSawVoices,
+        SuperSawDetune,
+        SuperSawMix,
+        SuperSawSpread,
+        Oversampling,
+        OversamplingFilter,
+        DriveAntialiasing,
+        FilterModel,
+        FilterQuality,
+        SeqEnabled,
+        SeqShuffle,
+        FxBypass,
+        Fx2Type,
+        Fx2Time,
+        Fx2Feedback,
+        Fx2Mix,
+        Fx2Bypass,
+        Fx3Type,
+        Fx3Time,
+        Fx3Feedback,
+        Fx3Mix,
+        Fx3Bypass,
+        Fx4Type,
+        Fx4Time,
+        Fx4Feedback,
+        Fx4Mix,
+        Fx4Bypass
+    };
+
+    inline constexpr size_t NUM_PARAMETERS = static_cast<size_t>(Index::Fx4Bypass) + 1;
+
+    constexpr size_t toIndex(Index index) { return static_cast<size_t>(index); }
+
+    /** DSP module a parameter belongs to - each group carries its own change version. */
+    enum class Group : int
+    {
+        Oscillator = 0,
+        Envelope,
+        Filter,
+        Overdrive,
+        Effects,
+        Arpeggiator,
+        Output,
+        Oversampling,
+        Sequencer
+    };
+
+    inline constexpr size_t NUM_GROUPS = static_cast<size_t>(Group::Sequencer) + 1;
+
+    constexpr size_t toIndex(Group group) { return static_cast<size_t>(group); }
+
+    enum class Kind { Float, Choice, Bool, Int };
+
+    /** Display unit used to format parameter values. */
+    enum class Unit { None, Cents, Hertz, Percent, Seconds, SecondsAsMilliseconds, Milliseconds, Multiplier, Decibels };
+
+    // Choice lists
+    inline constexpr std::array<const char*, 12> WAVEFORM_CHOICES {
+        "Saw", "Square", "Triangle", "Sine",
+        "Pulse 25%", "Pulse 12%", "SuperSaw", "Noise",
+        "Saw+Sqr", "Tri+Saw", "Sync", "FM"
+    };
+    inline constexpr std::array<const char*, 5> DRIVE_MODE_CHOICES {
+        "Soft", "Classic", "Saturated", "Fuzz", "Tape"
+    };
+    // Slot 1 keeps the 8 types it shipped with, so automation recorded
+    // against its normalised values still selects the same effect. The
+    // slots added with the rack also offer convolution.
+    inline constexpr std::array<const char*, 8> FX_TYPE_CHOICES {
+        "Tape Dly", "Digi Dly", "PingPong",
+        "Reverb", "Chorus", "Flanger", "Phaser", "Bitcrush"
+    };
+    inline constexpr std::array<const char*, 9> FX_SLOT_TYPE_CHOICES {
+        "Tape Dly", "Digi Dly", "PingPong",
+        "Reverb", "Chorus", "Flanger", "Phaser", "Bitcrush", "Convolve"
+    };
+    inline constexpr std::array<const char*, 7> ARP_MODE_CHOICES {
+        "Up", "Down", "Up/Down", "Down/Up", "Random", "Order", "Chord"
+    };
+    inline constexpr std::array<const char*, 10> ARP_DIVISION_CHOICES {
+        "1/1", "1/2", "1/4", "1/8", "1/16", "1/32",
+        "1/4D", "1/8D", "1/4T", "1/8T"
+    };
+    inline constexpr std::array<const char*, 4> OVERSAMPLING_CHOICES {
+        "Off", "2x", "4x", "8x"
+    };
+    inline constexpr std::array<const char*, 2> OVERSAMPLING_FILTER_CHOICES {
+        "Min Phase", "Linear Phase"
+    };
+    inline constexpr std::array<const char*, 3> ANTIALIASING_CHOICES {
+        "Off", "ADAA 1st", "ADAA 2nd"
+    };
+    inline constexpr std::array<const char*, 2> FILTER_MODEL_CHOICES {
+        "Transistor", "Diode"
+    };
+    inline constexpr std::array<const char*, 3> FILTER_QUALITY_CHOICES {
+        "Linear", "Newton 1x", "Newton Full"
+    };
+
+    /** Compile-time description of one parameter. Choice ranges are 0..numChoices-1. */
+    struct Info
+    {
+        Index index;
+        const char* id;
+        const char* name;
+        Group group;
+        Kind kind;
+        Unit unit;
+        float minValue;
+        float maxValue;
+        float interval;
+        float skew;
+        float defaultValue;
+        const char* const* choices = nullptr;
+        int numChoices = 0;
+    };
+
+    template <size_t N>
+    constexpr Info makeChoice(Index index, const char* id, const char* name, Group group,
+                              const std::array<const char*, N>& choices, int defaultIndex)
+    {
+        return { index, id, name, group, Kind::Choice, Unit::None,
+                 0.0f, static_cast<float>(N - 1), 1.0f, 1.0f, static_cast<float>(defaultIndex),
+                 choices.data(), static_cast<int>(N) };
+    }
 
+    inline constexpr std::array<Info, NUM_PARAMETERS> REGISTRY {{
         // OSCILLATOR - 12 waveforms
-        params.push_back(std::make_unique<juce::AudioParameterChoice>(
-            IDs::WAVEFORM,
-            "Waveform",
-            juce::StringArray{
-                "Saw", "Square", "Triangle", "Sine",
-                "Pulse 25%", "Pulse 12%", "SuperSaw", "Noise",
-                "Saw+Sqr", "Tri+Saw", "Sync", "FM"
-            },
-            0
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::FINE_TUNE,
-            "Fine Tune",
-            juce::NormalisableRange<float>(-50.0f, 50.0f, 0.1f),
-            0.0f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(value, 1) + " ct"; }
-        ));
+        makeChoice(Index::Waveform, IDs::WAVEFORM, "Waveform", Group::Oscillator, WAVEFORM_CHOICES, 0),
+        { Index::FineTune,   IDs::FINE_TUNE,   "Fine Tune", Group::Oscillator,  Kind::Float, Unit::Cents,   -50.0f,   50.0f, 0.1f,   1.0f, 0.0f },
 
         // FILTER
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::CUTOFF,
-            "Cutoff",
-            juce::NormalisableRange<float>(20.0f, 4000.0f, 0.1f, 0.3f),
-            1000.0f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(value, 0) + " Hz"; }
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::RESONANCE,
-            "Resonance",
-            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-            0.5f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(int(value * 100)) + "%"; }
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::ENV_MOD,
-            "Env Mod",
-            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-            0.5f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(int(value * 100)) + "%"; }
-        ));
+        { Index::Cutoff,     IDs::CUTOFF,      "Cutoff",    Group::Filter,      Kind::Float, Unit::Hertz,    20.0f, 4000.0f, 0.1f,   0.3f, 1000.0f },
+        { Index::Resonance,  IDs::RESONANCE,   "Resonance", Group::Filter,      Kind::Float, Unit::Percent,   0.0f,    1.0f, 0.01f,  1.0f, 0.5f },
+        { Index::EnvMod,     IDs::ENV_MOD,     "Env Mod",   Group::Filter,      Kind::Float, Unit::Percent,   0.0f,    1.0f, 0.01f,  1.0f, 0.5f },
 
         // ENVELOPE
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::DECAY,
-            "Decay",
-            juce::NormalisableRange<float>(0.01f, 2.0f, 0.01f, 0.5f),
-            0.5f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(value, 2) + " s"; }
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::ACCENT,
-            "Accent",
-            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-            0.0f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(int(value * 100)) + "%"; }
-        ));
+        { Index::Decay,      IDs::DECAY,       "Decay",     Group::Envelope,    Kind::Float, Unit::Seconds,   0.01f,   2.0f, 0.01f,  0.5f, 0.5f },
+        { Index::Accent,     IDs::ACCENT,      "Accent",    Group::Envelope,    Kind::Float, Unit::Percent,   0.0f,    1.0f, 0.01f,  1.0f, 0.0f },
 
         // SLIDE
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::SLIDE_TIME,
-            "Slide",
-            juce::NormalisableRange<float>(0.001f, 0.5f, 0.001f, 0.4f),
-            0.05f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(int(value * 1000)) + " ms"; }
-        ));
+        { Index::SlideTime,  IDs::SLIDE_TIME,  "Slide",     Group::Oscillator,  Kind::Float, Unit::SecondsAsMilliseconds, 0.001f, 0.5f, 0.001f, 0.4f, 0.05f },
 
         // OVERDRIVE - 5 modes
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::DRIVE,
-            "Drive",
-            juce::NormalisableRange<float>(1.0f, 10.0f, 0.1f, 0.4f),
-            1.0f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(value, 1) + "x"; }
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterChoice>(
-            IDs::DRIVE_MODE,
-            "Drive Mode",
-            juce::StringArray{"Soft", "Classic", "Saturated", "Fuzz", "Tape"},
-            1
-        ));
+        { Index::Drive,      IDs::DRIVE,       "Drive",     Group::Overdrive,   Kind::Float, Unit::Multiplier, 1.0f,  10.0f, 0.1f,   0.4f, 1.0f },
+        makeChoice(Index::DriveMode, IDs::DRIVE_MODE, "Drive Mode", Group::Overdrive, DRIVE_MODE_CHOICES, 1),
 
         // EFFECTS - 8 types
-        params.push_back(std::make_unique<juce::AudioParameterChoice>(
-            IDs::FX_TYPE,
-            "FX Type",
-            juce::StringArray{
-                "Tape Dly", "Digi Dly", "PingPong",
-                "Reverb", "Chorus", "Flanger", "Phaser", "Bitcrush"
-            },
-            0
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::FX_TIME,
-            "FX Time",
-            juce::NormalisableRange<float>(10.0f, 2000.0f, 1.0f, 0.3f),
-            250.0f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(value, 0) + " ms"; }
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::FX_FEEDBACK,
-            "Feedback",
-            juce::NormalisableRange<float>(0.0f, 0.95f, 0.01f),
-            0.5f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(int(value * 100)) + "%"; }
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::FX_MIX,
-            "FX Mix",
-            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-            0.3f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(int(value * 100)) + "%"; }
-        ));
+        makeChoice(Index::FxType, IDs::FX_TYPE, "FX Type", Group::Effects, FX_TYPE_CHOICES, 0),
+        { Index::FxTime,     IDs::FX_TIME,     "FX Time",   Group::Effects,     Kind::Float, Unit::Milliseconds, 10.0f, 2000.0f, 1.0f, 0.3f, 250.0f },
+        { Index::FxFeedback, IDs::FX_FEEDBACK, "Feedback",  Group::Effects,     Kind::Float, Unit::Percent,   0.0f,   0.95f, 0.01f,  1.0f, 0.5f },
+        { Index::FxMix,      IDs::FX_MIX,      "FX Mix",    Group::Effects,     Kind::Float, Unit::Percent,   0.0f,    1.0f, 0.01f,  1.0f, 0.3f },
 
         // ARPEGGIATOR
-        params.push_back(std::make_unique<juce::AudioParameterBool>(
-            IDs::ARP_ENABLED,
-            "Arp On",
-            false
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterChoice>(
-            IDs::ARP_MODE,
-            "Arp Mode",
-            juce::StringArray{"Up", "Down", "Up/Down", "Down/Up", "Random", "Order", "Chord"},
-            0
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterChoice>(
-            IDs::ARP_DIVISION,
-            "Arp Rate",
-            juce::StringArray{
-                "1/1", "1/2", "1/4", "1/8", "1/16", "1/32",
-                "1/4D", "1/8D", "1/4T", "1/8T"
-            },
-            3  // Default to 1/8
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::ARP_GATE,
-            "Arp Gate",
-            juce::NormalisableRange<float>(0.1f, 1.0f, 0.01f),
-            0.5f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(int(value * 100)) + "%"; }
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterInt>(
-            IDs::ARP_OCTAVES,
-            "Arp Oct",
-            1, 4, 1
-        ));
-
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::ARP_SWING,
-            "Swing",
-            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
-            0.0f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(int(value * 100)) + "%"; }
-        ));
+        { Index::ArpEnabled, IDs::ARP_ENABLED, "Arp On",    Group::Arpeggiator, Kind::Bool,  Unit::None,      0.0f,    1.0f, 1.0f,   1.0f, 0.0f },
+        makeChoice(Index::ArpMode, IDs::ARP_MODE, "Arp Mode", Group::Arpeggiator, ARP_MODE_CHOICES, 0),
+        makeChoice(Index::ArpDivision, IDs::ARP_DIVISION, "Arp Rate", Group::Arpeggiator, ARP_DIVISION_CHOICES, 3), // Default to 1/8
+        { Index::ArpGate,    IDs::ARP_GATE,    "Arp Gate",  Group::Arpeggiator, Kind::Float, Unit::Percent,   0.1f,    1.0f, 0.01f,  1.0f, 0.5f },
+        { Index::ArpOctaves, IDs::ARP_OCTAVES, "Arp Oct",   Group::Arpeggiator, Kind::Int,   Unit::None,      1.0f,    4.0f, 1.0f,   1.0f, 1.0f },
+        { Index::ArpSwing,   IDs::ARP_SWING,   "Swing",     Group::Arpeggiator, Kind::Float, Unit::Percent,   0.0f,    1.0f, 0.01f,  1.0f, 0.0f },
 
         // OUTPUT
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            IDs::OUTPUT_GAIN,
-            "Output",
-            juce::NormalisableRange<float>(-12.0f, 12.0f, 0.1f),
-            0.0f,
-            juce::String(),
-            juce::AudioProcessorParameter::genericParameter,
-            [](float value, int) { return juce::String(value, 1) + " dB"; }
-        ));
+        { Index::OutputGain, IDs::OUTPUT_GAIN, "Output",    Group::Output,      Kind::Float, Unit::Decibels, -12.0f,  12.0f, 0.1f,   1.0f, 0.0f },
+
+        // SUPERSAW
+        { Index::SuperSawVoices, IDs::SUPERSAW_VOICES, "Saw Voices", Group::Oscillator, Kind::Int,   Unit::None,    1.0f, 16.0f, 1.0f,  1.0f, 7.0f },
+        { Index::SuperSawDetune, IDs::SUPERSAW_DETUNE, "Saw Detune", Group::Oscillator, Kind::Float, Unit::Percent, 0.0f,  1.0f, 0.01f, 1.0f, 0.5f },
+        { Index::SuperSawMix,    IDs::SUPERSAW_MIX,    "Saw Mix",    Group::Oscillator, Kind::Float, Unit::Percent, 0.0f,  1.0f, 0.01f, 1.0f, 0.5f },
+        { Index::SuperSawSpread, IDs::SUPERSAW_SPREAD, "Saw Spread", Group::Oscillator, Kind::Float, Unit::Percent, 0.0f,  1.0f, 0.01f, 1.0f, 0.5f },
+
+        // OVERSAMPLING - filter and overdrive only
+        makeChoice(Index::Oversampling, IDs::OVERSAMPLING, "Oversampling", Group::Oversampling, OVERSAMPLING_CHOICES, 0),
+        makeChoice(Index::OversamplingFilter, IDs::OVERSAMPLING_FILTER, "OS Filter", Group::Oversampling, OVERSAMPLING_FILTER_CHOICES, 0),
+
+        // OVERDRIVE - antiderivative anti-aliasing, also used by the output clipper
+        makeChoice(Index::DriveAntialiasing, IDs::DRIVE_ANTIALIASING, "Drive AA", Group::Overdrive, ANTIALIASING_CHOICES, 1),
+
+        // FILTER - ladder topology and solver tier
+        makeChoice(Index::FilterModel, IDs::FILTER_MODEL, "Filter Model", Group::Filter, FILTER_MODEL_CHOICES, 0),
+        makeChoice(Index::FilterQuality, IDs::FILTER_QUALITY, "Filter Quality", Group::Filter, FILTER_QUALITY_CHOICES, 1),
+
+        // SEQUENCER - the pattern itself is saved as a state property
+        { Index::SeqEnabled, IDs::SEQ_ENABLED, "Seq On",    Group::Sequencer,   Kind::Bool,  Unit::None,      0.0f,    1.0f, 1.0f,   1.0f, 0.0f },
+        { Index::SeqShuffle, IDs::SEQ_SHUFFLE, "Shuffle",   Group::Sequencer,   Kind::Float, Unit::Percent,   0.0f,    1.0f, 0.01f,  1.0f, 0.0f },
+
+        // EFFECTS RACK - slot 1 bypass, then slots 2-4 (bypassed by default)
+        { Index::FxBypass,    IDs::FX_BYPASS,    "FX Bypass",     Group::Effects, Kind::Bool,  Unit::None,      0.0f,    1.0f, 1.0f,   1.0f, 0.0f },
+        makeChoice(Index::Fx2Type, IDs::FX2_TYPE, "FX 2 Type", Group::Effects, FX_SLOT_TYPE_CHOICES, 4),  // Chorus
+        { Index::Fx2Time,     IDs::FX2_TIME,     "FX 2 Time",     Group::Effects, Kind::Float, Unit::Milliseconds, 10.0f, 2000.0f, 1.0f, 0.3f, 250.0f },
+        { Index::Fx2Feedback, IDs::FX2_FEEDBACK, "FX 2 Feedback", Group::Effects, Kind::Float, Unit::Percent,   0.0f,   0.95f, 0.01f,  1.0f, 0.5f },
+        { Index::Fx2Mix,      IDs::FX2_MIX,      "FX 2 Mix",      Group::Effects, Kind::Float, Unit::Percent,   0.0f,    1.0f, 0.01f,  1.0f, 0.3f },
+        { Index::Fx2Bypass,   IDs::FX2_BYPASS,   "FX 2 Bypass",   Group::Effects, Kind::Bool,  Unit::None,      0.0f,    1.0f, 1.0f,   1.0f, 1.0f },
+        makeChoice(Index::Fx3Type, IDs::FX3_TYPE, "FX 3 Type", Group::Effects, FX_SLOT_TYPE_CHOICES, 1),  // Digital delay
+        { Index::Fx3Time,     IDs::FX3_TIME,     "FX 3 Time",     Group::Effects, Kind::Float, Unit::Milliseconds, 10.0f, 2000.0f, 1.0f, 0.3f, 250.0f },
+        { Index::Fx3Feedback, IDs::FX3_FEEDBACK, "FX 3 Feedback", Group::Effects, Kind::Float, Unit::Percent,   0.0f,   0.95f, 0.01f,  1.0f, 0.5f },
+        { Index::Fx3Mix,      IDs::FX3_MIX,      "FX 3 Mix",      Group::Effects, Kind::Float, Unit::Percent,   0.0f,    1.0f, 0.01f,  1.0f, 0.3f },
+        { Index::Fx3Bypass,   IDs::FX3_BYPASS,   "FX 3 Bypass",   Group::Effects, Kind::Bool,  Unit::None,      0.0f,    1.0f, 1.0f,   1.0f, 1.0f },
+        makeChoice(Index::Fx4Type, IDs::FX4_TYPE, "FX 4 Type", Group::Effects, FX_SLOT_TYPE_CHOICES, 3),  // Reverb
+        { Index::Fx4Time,     IDs::FX4_TIME,     "FX 4 Time",     Group::Effects, Kind::Float, Unit::Milliseconds, 10.0f, 2000.0f, 1.0f, 0.3f, 250.0f },
+        { Index::Fx4Feedback, IDs::FX4_FEEDBACK, "FX 4 Feedback", Group::Effects, Kind::Float, Unit::Percent,   0.0f,   0.95f, 0.01f,  1.0f, 0.5f },
+        { Index::Fx4Mix,      IDs::FX4_MIX,      "FX 4 Mix",      Group::Effects, Kind::Float, Unit::Percent,   0.0f,    1.0f, 0.01f,  1.0f, 0.3f },
+        { Index::Fx4Bypass,   IDs::FX4_BYPASS,   "FX 4 Bypass",   Group::Effects, Kind::Bool,  Unit::None,      0.0f,    1.0f, 1.0f,   1.0f, 1.0f },
+    }};
+
+    /** Parameters of one serial effects rack slot. */
+    struct FxSlot
+    {
+        Index type;
+        Index time;
+        Index feedback;
+        Index mix;
+        Index bypass;
+    };
+
+    inline constexpr size_t NUM_FX_SLOTS = 4;
+
+    inline constexpr std::array<FxSlot, NUM_FX_SLOTS> FX_SLOTS {{
+        { Index::FxType,  Index::FxTime,  Index::FxFeedback,  Index::FxMix,  Index::FxBypass },
+        { Index::Fx2Type, Index::Fx2Time, Index::Fx2Feedback, Index::Fx2Mix, Index::Fx2Bypass },
+        { Index::Fx3Type, Index::Fx3Time, Index::Fx3Feedback, Index::Fx3Mix, Index::Fx3Bypass },
+        { Index::Fx4Type, Index::Fx4Time, Index::Fx4Feedback, Index::Fx4Mix, Index::Fx4Bypass },
+    }};
+
+    constexpr bool isRegistryOrdered()
+    {
+        for (size_t i = 0; i < NUM_PARAMETERS; ++i)
+            if (toIndex(REGISTRY[i].index) != i)
+                return false;
+
+        return true;
+    }
+
+    static_assert(isRegistryOrdered(), "REGISTRY entries must be listed in Index order");
+
+    constexpr const Info& getInfo(Index index) { return REGISTRY[toIndex(index)]; }
+
+    inline juce::String formatValue(Unit unit, float value)
+    {
+        switch (unit)
+        {
+            case Unit::Cents:                 return juce::String(value, 1) + " ct";
+            case Unit::Hertz:                 return juce::String(value, 0) + " Hz";
+            case Unit::Percent:               return juce::String(int(value * 100)) + "%";
+            case Unit::Seconds:               return juce::String(value, 2) + " s";
+            case Unit::SecondsAsMilliseconds: return juce::String(int(value * 1000)) + " ms";
+            case Unit::Milliseconds:          return juce::String(value, 0) + " ms";
+            case Unit::Multiplier:            return juce::String(value, 1) + "x";
+            case Unit::Decibels:              return juce::String(value, 1) + " dB";
+            case Unit::None:
+            default:                          return juce::String(value);
+        }
+    }
+
+    inline juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
+    {
+        std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+
+        for (const auto& info : REGISTRY)
+        {
+            switch (info.kind)
+            {
+                case Kind::Float:
+                {
+                    const auto unit = info.unit;
+                    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+                        info.id,
+                        info.name,
+                        juce::NormalisableRange<float>(info.minValue, info.maxValue, info.interval, info.skew),
+                        info.defaultValue,
+                        juce::String(),
+                        juce::AudioProcessorParameter::genericParameter,
+                        [unit](float value, int) { return formatValue(unit, value); }
+                    ));
+                    break;
+                }
+
+                case Kind::Choice:
+                {
+                    juce::StringArray choices;
+                    for (int i = 0; i < info.numChoices; ++i)
+                        choices.add(info.choices[i]);
+
+                    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+                        info.id,
+                        info.name,
+                        choices,
+                        static_cast<int>(info.defaultValue)
+                    ));
+                    break;
+                }
+
+                case Kind::Bool:
+                    params.push_back(std::make_unique<juce::AudioParameterBool>(
+                        info.id,
+                        info.name,
+                        info.defaultValue >= 0.5f
+                    ));
+                    break;
+
+                case Kind::Int:
+                    params.push_back(std::make_unique<juce::AudioParameterInt>(
+                        info.id,
+                        info.name,
+                        static_cast<int>(info.minValue),
+                        static_cast<int>(info.maxValue),
+                        static_cast<int>(info.defaultValue)
+                    ));
+                    break;
+            }
+        }
 
         return { params.begin(), params.end() };
     }
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Small, deterministic PRNG for the DSP modules.
+ *
+ * xoshiro128+ with NUM_STREAMS independent streams. The state is stored word by
+ * stream, so the block fill applies the same uint32 operations to every stream
+ * and the compiler can vectorize the inner loop (SSE2/NEON). The whole generator
+ * is 64 bytes, compared with about 5 KB for std::mt19937.
+ *
+ * Nothing is taken from std::random_device: the same seed always produces the
+ * same sequence, which keeps offline renders reproducible. Scalar draws (per
+ * step or per event) come from stream 0.
+ */
+class RandomGenerator
+{
+public:
+    static constexpr int NUM_STREAMS = 4;
+
+    explicit RandomGenerator(uint64_t seed = 0) noexcept { setSeed(seed); }
+
+    /** Restarts every stream from a seed (expanded with splitmix64). */
+    void setSeed(uint64_t seed) noexcept
+    {
+        m_seed = seed;
+
+        uint64_t x = seed;
+        for (int stream = 0; stream < NUM_STREAMS; ++stream)
+        {
+            for (int word = 0; word < 4; word += 2)
+            {
+                const uint64_t value = splitMix64(x);
+                m_state[word][stream] = static_cast<uint32_t>(value);
+                m_state[word + 1][stream] = static_cast<uint32_t>(value >> 32);
+            }
+        }
+    }
+
+    /** Restarts the sequence from the current seed. */
+    void reset() noexcept { setSeed(m_seed); }
+
+    uint64_t getSeed() const noexcept { return m_seed; }
+
+    /** Derives an independent seed for a sub-generator (one per module, channel...). */
+    static uint64_t deriveSeed(uint64_t seed, uint64_t index) noexcept
+    {
+        uint64_t x = seed ^ (index * 0xD1B54A32D192ED03ull);
+        return splitMix64(x);
+    }
+
+    /** Uniform in [0, 1). */
+    float nextFloat() noexcept { return toUnitFloat(next(0)); }
+
+    /** Uniform in [minValue, maxValue). */
+    float nextFloat(float minValue, float maxValue) noexcept
+    {
+        return minValue + nextFloat() * (maxValue - minValue);
+    }
+
+    /** Uniform integer in [0, bound), bound > 0. */
+    int nextInt(int bound) noexcept
+    {
+        return static_cast<int>((static_cast<uint64_t>(next(0)) * static_cast<uint64_t>(bound)) >> 32);
+    }
+
+    /** Fills dest with uniform floats in [minValue, maxValue), NUM_STREAMS at a time. */
+    void fillUniform(float* dest, int numSamples, float minValue, float maxValue) noexcept
+    {
+        const float scale = (maxValue - minValue) * UNIT_SCALE;
+
+        int i = 0;
+        for (; i + NUM_STREAMS <= numSamples; i += NUM_STREAMS)
+            for (int stream = 0; stream < NUM_STREAMS; ++stream)
+                dest[i + stream] = minValue + static_cast<float>(next(stream) >> 8) * scale;
+
+        for (; i < numSamples; ++i)
+            dest[i] = minValue + static_cast<float>(next(0) >> 8) * scale;
+    }
+
+private:
+    static constexpr float UNIT_SCALE = 1.0f / 16777216.0f;   // 2^-24, one step per float mantissa bit
+
+    uint32_t next(int stream) noexcept
+    {
+        uint32_t& s0 = m_state[0][stream];
+        uint32_t& s1 = m_state[1][stream];
+        uint32_t& s2 = m_state[2][stream];
+        uint32_t& s3 = m_state[3][stream];
+
+        const uint32_t result = s0 + s3;
+        const uint32_t t = s1 << 9;
+
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = (s3 << 11) | (s3 >> 21);
+
+        return result;
+    }
+
+    static float toUnitFloat(uint32_t value) noexcept
+    {
+        // Top 24 bits, so the result is exactly representable and never reaches 1
+        return static_cast<float>(value >> 8) * UNIT_SCALE;
+    }
+
+    static uint64_t splitMix64(uint64_t& x) noexcept
+    {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint32_t m_state[4][NUM_STREAMS] = {};
+    uint64_t m_seed = 0;
+};
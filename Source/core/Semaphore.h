@@ -0,0 +1,56 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#if JUCE_MAC || JUCE_IOS
+ #include <dispatch/dispatch.h>
+#elif JUCE_WINDOWS
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#else
+ #include <semaphore.h>
+#endif
+
+/**
+ * Counting semaphore for waking a background thread from the audio thread
+ *
+ * post() is a single system call that takes no lock the waiting thread also
+ * holds (unlike juce::WaitableEvent, which signals under a mutex), so a
+ * low-priority waiter can never hold up the audio thread. Every post() wakes
+ * one wait(); posts made while nobody waits are counted.
+ */
+class Semaphore {
+public:
+   #if JUCE_MAC || JUCE_IOS
+    Semaphore() : m_handle(dispatch_semaphore_create(0)) {}
+    ~Semaphore() { dispatch_release(m_handle); }
+
+    void post() noexcept { dispatch_semaphore_signal(m_handle); }
+    void wait() noexcept { dispatch_semaphore_wait(m_handle, DISPATCH_TIME_FOREVER); }
+
+private:
+    dispatch_semaphore_t m_handle;
+   #elif JUCE_WINDOWS
+    Semaphore() : m_handle(CreateSemaphoreW(nullptr, 0, LONG_MAX, nullptr)) {}
+    ~Semaphore() { CloseHandle(m_handle); }
+
+    void post() noexcept { ReleaseSemaphore(m_handle, 1, nullptr); }
+    void wait() noexcept { WaitForSingleObject(m_handle, INFINITE); }
+
+private:
+    HANDLE m_handle;
+   #else
+    Semaphore() { sem_init(&m_handle, 0, 0); }
+    ~Semaphore() { sem_destroy(&m_handle); }
+
+    void post() noexcept { sem_post(&m_handle); }
+    void wait() noexcept { while (sem_wait(&m_handle) != 0) {} }   // Retried after signals
+
+private:
+    sem_t m_handle;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (Semaphore)
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Statically composed chain of DSP modules.
+ *
+ * Stages are stored inline, in order, inside one object and are called directly
+ * through their concrete type - no heap allocation, no null checks and, because
+ * the DSP modules are declared final, no virtual dispatch on the render path.
+ * Each stage can be bypassed per block.
+ *
+ * Usage:
+ *   SignalChain<LadderFilter, Overdrive, Effects> chain;
+ *   chain.get<LadderFilter>().setCutoff(800.0f);
+ *   chain.setBypassed<Overdrive>(true);
+ *   chain.process(data, numSamples);
+ */
+template <typename... Modules>
+class SignalChain
+{
+public:
+    static constexpr size_t NUM_STAGES = sizeof...(Modules);
+
+    /** Returns the stage at the given position. */
+    template <size_t Index>
+    auto& get() noexcept { return std::get<Index>(m_modules); }
+
+    template <size_t Index>
+    const auto& get() const noexcept { return std::get<Index>(m_modules); }
+
+    /** Returns the stage of the given type (each type may only appear once). */
+    template <typename Module>
+    Module& get() noexcept { return std::get<Module>(m_modules); }
+
+    template <typename Module>
+    const Module& get() const noexcept { return std::get<Module>(m_modules); }
+
+    /** Prepares every stage, including bypassed ones. */
+    void prepare(double sampleRate, int samplesPerBlock)
+    {
+        std::apply([=](auto&... module) { (module.prepare(sampleRate, samplesPerBlock), ...); }, m_modules);
+    }
+
+    /**
+     * Moves every stage to another sample rate on the audio thread, keeping
+     * its state. Each stage must provide setSampleRate() and have been
+     * prepared for the new rate in advance.
+     */
+    void setSampleRate(double sampleRate)
+    {
+        std::apply([=](auto&... module) { (module.setSampleRate(sampleRate), ...); }, m_modules);
+    }
+
+    /** Resets every stage, including bypassed ones. */
+    void reset()
+    {
+        std::apply([](auto&... module) { (module.reset(), ...); }, m_modules);
+    }
+
+    /** Runs all active stages over the buffer in place, in order. */
+    void process(float* data, int numSamples)
+    {
+        processStages(data, numSamples, std::index_sequence_for<Modules...>{});
+    }
+
+    /**
+     * True when every active stage reports silence (see DSPModule::isSilent),
+     * so the chain can be skipped until its input is non-silent again.
+     */
+    bool isSilent() const
+    {
+        return isSilent(std::index_sequence_for<Modules...>{});
+    }
+
+    /** Bypassed stages are skipped entirely and keep their state. */
+    template <typename Module>
+    void setBypassed(bool shouldBeBypassed) noexcept { m_bypassed[indexOf<Module>()] = shouldBeBypassed; }
+
+    template <typename Module>
+    bool isBypassed() const noexcept { return m_bypassed[indexOf<Module>()]; }
+
+private:
+    template <typename Module>
+    static constexpr size_t indexOf()
+    {
+        constexpr std::array<bool, NUM_STAGES> matches { std::is_same_v<Module, Modules>... };
+        static_assert((std::is_same_v<Module, Modules> || ...), "Module is not a stage of this chain");
+
+        for (size_t i = 0; i < NUM_STAGES; ++i)
+            if (matches[i])
+                return i;
+
+        return NUM_STAGES;
+    }
+
+    template <size_t... Indices>
+    void processStages(float* data, int numSamples, std::index_sequence<Indices...>)
+    {
+        (processStage<Indices>(data, numSamples), ...);
+    }
+
+    template <size_t... Indices>
+    bool isSilent(std::index_sequence<Indices...>) const
+    {
+        return ((m_bypassed[Indices] || std::get<Indices>(m_modules).isSilent()) && ...);
+    }
+
+    template <size_t Index>
+    void processStage(float* data, int numSamples)
+    {
+        if (!m_bypassed[Index])
+            std::get<Index>(m_modules).process(data, numSamples);
+    }
+
+    std::tuple<Modules...> m_modules;
+    std::array<bool, NUM_STAGES> m_bypassed{};
+};
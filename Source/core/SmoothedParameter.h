@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <juce_core/juce_core.h>
+
+/**
+ * Block-rendered parameter ramp shared by all DSP modules.
+ *
+ * setTarget() starts a ramp of fixed length towards the new value; render()
+ * writes the next numSamples values into an internal buffer that modules read
+ * sample by sample. All transcendental math happens once per target change:
+ * linear ramps add a constant step, multiplicative ramps (for frequencies and
+ * gains) multiply by a constant ratio.
+ *
+ * Once a ramp has finished the buffer already holds the target value, so
+ * render() returns without touching memory - steady parameters cost nothing.
+ *
+ * Thread Safety: audio thread only. Modules keep their atomics and forward the
+ * latest value with setTarget() at the start of each block.
+ */
+class SmoothedParameter
+{
+public:
+    enum class Curve {
+        Linear,           // Constant increment (levels, mix, time)
+        Multiplicative    // Constant ratio (frequency, gain) - values must be > 0
+    };
+
+    explicit SmoothedParameter(Curve curve = Curve::Linear) : m_curve(curve) {}
+
+    /**
+     * Allocates the ramp buffer and sets the ramp length.
+     * Call from prepare() - never on the audio thread during processing.
+     */
+    void prepare(double sampleRate, int maxBlockSize, float rampSeconds)
+    {
+        m_buffer.assign(static_cast<size_t>(std::max(1, maxBlockSize)), m_target);
+        m_sampleRate = sampleRate;
+        setRampTime(rampSeconds);
+        reset(m_target);
+    }
+
+    /** Sets the ramp length for future target changes. */
+    void setRampTime(float rampSeconds)
+    {
+        m_rampSeconds = rampSeconds;
+        m_rampLengthSamples = std::max(0, static_cast<int>(std::round(rampSeconds * m_sampleRate)));
+    }
+
+    /**
+     * Moves to another sample rate without allocating or jumping: the ramp
+     * length follows the rate, and a ramp in progress finishes in the same time.
+     */
+    void setSampleRate(double sampleRate)
+    {
+        const double ratio = sampleRate / m_sampleRate;
+        m_sampleRate = sampleRate;
+        setRampTime(m_rampSeconds);
+
+        if (m_countdown > 0)
+        {
+            m_countdown = std::max(1, static_cast<int>(std::round(m_countdown * ratio)));
+
+            if (m_isRampMultiplicative)
+                m_step = std::exp(std::log(m_target / m_current) / static_cast<float>(m_countdown));
+            else
+                m_step = (m_target - m_current) / static_cast<float>(m_countdown);
+        }
+    }
+
+    /** Jumps straight to a value without ramping. */
+    void reset(float value)
+    {
+        m_current = value;
+        m_target = value;
+        m_countdown = 0;
+        m_constantSamples = 0;
+    }
+
+    /** Starts a ramp from the current value towards the new target. */
+    void setTarget(float target)
+    {
+        if (target == m_target)
+            return;
+
+        m_target = target;
+        m_constantSamples = 0;
+
+        if (m_rampLengthSamples <= 0)
+        {
+            m_current = target;
+            m_countdown = 0;
+            return;
+        }
+
+        m_countdown = m_rampLengthSamples;
+        m_isRampMultiplicative = m_curve == Curve::Multiplicative && m_current > 0.0f && target > 0.0f;
+
+        if (m_isRampMultiplicative)
+            m_step = std::exp(std::log(target / m_current) / static_cast<float>(m_rampLengthSamples));
+        else
+            m_step = (target - m_current) / static_cast<float>(m_rampLengthSamples);
+    }
+
+    float getTarget() const noexcept { return m_target; }
+    float getCurrentValue() const noexcept { return m_current; }
+    bool isSmoothing() const noexcept { return m_countdown > 0; }
+
+    /**
+     * Renders the next numSamples values and returns them.
+     * numSamples must not exceed the block size passed to prepare().
+     */
+    const float* render(int numSamples)
+    {
+        jassert(numSamples <= static_cast<int>(m_buffer.size()));
+        float* buffer = m_buffer.data();
+
+        // Fast path: ramp finished, buffer already holds the target
+        if (m_countdown == 0)
+        {
+            if (m_constantSamples < numSamples)
+            {
+                std::fill(buffer + m_constantSamples, buffer + numSamples, m_target);
+                m_constantSamples = numSamples;
+            }
+            return buffer;
+        }
+
+        const int rampSamples = std::min(numSamples, m_countdown);
+        float value = m_current;
+
+        if (m_isRampMultiplicative)
+        {
+            for (int i = 0; i < rampSamples; ++i)
+            {
+                value *= m_step;
+                buffer[i] = value;
+            }
+        }
+        else
+        {
+            for (int i = 0; i < rampSamples; ++i)
+            {
+                value += m_step;
+                buffer[i] = value;
+            }
+        }
+
+        m_countdown -= rampSamples;
+
+        // Snap to the exact target to remove accumulated rounding error
+        if (m_countdown == 0)
+        {
+            value = m_target;
+            buffer[rampSamples - 1] = value;
+        }
+
+        m_current = value;
+        std::fill(buffer + rampSamples, buffer + numSamples, m_target);
+        return buffer;
+    }
+
+private:
+    Curve m_curve;
+    std::vector<float> m_buffer;
+    double m_sampleRate = 44100.0;
+    float m_rampSeconds = 0.0f;
+
+    float m_current = 0.0f;
+    float m_target = 0.0f;
+    float m_step = 0.0f;
+    int m_countdown = 0;
+    int m_rampLengthSamples = 0;
+    int m_constantSamples = 0;       // Leading buffer samples known to hold m_target
+    bool m_isRampMultiplicative = false;
+};
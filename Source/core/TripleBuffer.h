@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * Wait-free single-writer, single-reader hand-off of a plain value.
+ *
+ * Three copies of T rotate between the roles below; the writer and the reader
+ * each own one outright and swap it with the shared middle slot in a single
+ * atomic exchange, so neither side ever waits or sees a half-written value:
+ *
+ *   back    - written by the writer (e.g. the editor)
+ *   middle  - the latest published value, flagged until the reader takes it
+ *   front   - read by the reader (the audio thread)
+ *
+ * Intermediate values published between two update() calls are skipped.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    static_assert(std::is_trivially_copyable<T>::value, "TripleBuffer values are copied as plain data");
+
+    explicit TripleBuffer(const T& initial = T{}) noexcept
+    {
+        m_buffers.fill(initial);
+    }
+
+    /** Writer: the value to fill before publish(). */
+    T& getWriteBuffer() noexcept { return m_buffers[static_cast<size_t>(m_back)]; }
+
+    /** Writer: hands the write buffer to the reader. */
+    void publish() noexcept
+    {
+        m_back = m_middle.exchange(m_back | DIRTY, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /** Writer: copies a value in and publishes it. */
+    void write(const T& value) noexcept
+    {
+        getWriteBuffer() = value;
+        publish();
+    }
+
+    /** Reader: adopts the latest published value. Returns true if there was one. */
+    bool update() noexcept
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & DIRTY) == 0)
+            return false;
+
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /** Reader: the value adopted by the last update(). */
+    const T& read() const noexcept { return m_buffers[static_cast<size_t>(m_front)]; }
+
+private:
+    static constexpr int INDEX_MASK = 3;
+    static constexpr int DIRTY = 4;
+
+    std::array<T, 3> m_buffers;
+    std::atomic<int> m_middle{1};
+    int m_back = 2;         // Writer thread only
+    int m_front = 0;        // Reader thread only
+};
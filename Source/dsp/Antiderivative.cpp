@@ -0,0 +1,82 @@
+#include "Antiderivative.h"
+#include <array>
+
+namespace
+{
+    // The integral of log(cosh(t)) has no elementary closed form (it needs the
+    // dilogarithm), so it is tabulated on [0, TABLE_RANGE] and read back with
+    // cubic Hermite interpolation, using log(cosh(t)) itself as the slope.
+    // Beyond the table log(cosh(t)) = t - log(2) to double precision.
+    constexpr double TABLE_RANGE = 16.0;
+    constexpr int TABLE_STEPS_PER_UNIT = 64;
+    constexpr int TABLE_SIZE = static_cast<int>(TABLE_RANGE) * TABLE_STEPS_PER_UNIT + 1;
+    constexpr double TABLE_STEP = 1.0 / TABLE_STEPS_PER_UNIT;
+    constexpr double LOG_TWO = 0.6931471805599453;
+
+    struct LogCoshIntegralTable
+    {
+        std::array<double, TABLE_SIZE> values{};
+        std::array<double, TABLE_SIZE> slopes{};
+
+        LogCoshIntegralTable()
+        {
+            // Composite Simpson over each table step
+            constexpr int SUBDIVISIONS = 8;
+            const double h = TABLE_STEP / SUBDIVISIONS;
+
+            for (int k = 0; k < TABLE_SIZE; ++k)
+            {
+                const double t = k * TABLE_STEP;
+                slopes[static_cast<size_t>(k)] = Antiderivative::logCosh(t);
+
+                if (k == 0)
+                    continue;
+
+                const double start = t - TABLE_STEP;
+                double sum = Antiderivative::logCosh(start) + Antiderivative::logCosh(t);
+                for (int j = 1; j < SUBDIVISIONS; ++j)
+                    sum += Antiderivative::logCosh(start + j * h) * (j % 2 == 1 ? 4.0 : 2.0);
+
+                values[static_cast<size_t>(k)] = values[static_cast<size_t>(k - 1)] + sum * h / 3.0;
+            }
+        }
+    };
+
+    const LogCoshIntegralTable& getTable()
+    {
+        static const LogCoshIntegralTable table;
+        return table;
+    }
+}
+
+double Antiderivative::logCoshIntegral(double x) noexcept
+{
+    const auto& table = getTable();
+    const double a = std::abs(x);
+
+    double value;
+    if (a >= TABLE_RANGE)
+    {
+        const double d = a - TABLE_RANGE;
+        value = table.values[TABLE_SIZE - 1] + (TABLE_RANGE - LOG_TWO) * d + 0.5 * d * d;
+    }
+    else
+    {
+        const double position = a * TABLE_STEPS_PER_UNIT;
+        const int k = static_cast<int>(position);
+        const double t = position - k;
+
+        const double y0 = table.values[static_cast<size_t>(k)];
+        const double y1 = table.values[static_cast<size_t>(k + 1)];
+        const double m0 = table.slopes[static_cast<size_t>(k)] * TABLE_STEP;
+        const double m1 = table.slopes[static_cast<size_t>(k + 1)] * TABLE_STEP;
+
+        // Cubic Hermite basis
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        value = (2.0 * t3 - 3.0 * t2 + 1.0) * y0 + (t3 - 2.0 * t2 + t) * m0
+              + (-2.0 * t3 + 3.0 * t2) * y1 + (t3 - t2) * m1;
+    }
+
+    return x < 0.0 ? -value : value;
+}
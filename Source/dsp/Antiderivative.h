@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Antiderivative anti-aliasing (ADAA) for memoryless waveshapers
+ *
+ * Instead of evaluating a curve f(u) per sample, ADAA outputs the average of f
+ * over the segment between consecutive inputs, computed from its antiderivative:
+ *
+ *   1st order: y[n] = (F1(u[n]) - F1(u[n-1])) / (u[n] - u[n-1])
+ *   2nd order: the same divided difference applied twice, using F2
+ *
+ * which suppresses aliasing roughly as well as 4-8x oversampling on a 303-style
+ * signal, at the cost of a half (1st) or one (2nd) sample delay. When the
+ * divided difference becomes ill-conditioned (inputs too close together) the
+ * curve is evaluated at the midpoint instead.
+ *
+ * Each curve provides f, its first antiderivative F1 and its second
+ * antiderivative F2. Polynomial and piecewise-linear curves have closed forms;
+ * the second antiderivative of tanh is tabulated (see logCoshIntegral()).
+ * Antiderivatives are evaluated in double precision - the differences between
+ * neighbouring samples would otherwise be lost to float rounding.
+ */
+namespace Antiderivative
+{
+    enum class Order {
+        Off = 0,
+        First,
+        Second
+    };
+
+    /** log(cosh(x)), stable for large |x|. */
+    inline double logCosh(double x) noexcept
+    {
+        const double a = std::abs(x);
+        return a + std::log1p(std::exp(-2.0 * a)) - 0.6931471805599453;
+    }
+
+    /** Integral of logCosh from 0 to x (odd), from a cubic Hermite table. */
+    double logCoshIntegral(double x) noexcept;
+
+    inline double sign(double x) noexcept { return x < 0.0 ? -1.0 : 1.0; }
+
+    /** tanh - Soft mode and the output clipper */
+    struct Tanh
+    {
+        template <typename T>
+        static T f(T u) noexcept { return std::tanh(u); }
+        static double F1(double u) noexcept { return logCosh(u); }
+        static double F2(double u) noexcept { return logCoshIntegral(u); }
+    };
+
+    /** Asymmetric tanh: 0.9 tanh(1.2u) above zero, 1.1 tanh(0.8u) below - Classic mode */
+    struct AsymmetricTanh
+    {
+        template <typename T>
+        static T f(T u) noexcept
+        {
+            return u > T(0) ? std::tanh(u * T(1.2)) * T(0.9) : std::tanh(u * T(0.8)) * T(1.1);
+        }
+
+        static double F1(double u) noexcept
+        {
+            return u > 0.0 ? logCosh(1.2 * u) * (0.9 / 1.2) : logCosh(0.8 * u) * (1.1 / 0.8);
+        }
+
+        static double F2(double u) noexcept
+        {
+            return u > 0.0 ? logCoshIntegral(1.2 * u) * (0.9 / 1.44) : logCoshIntegral(0.8 * u) * (1.1 / 0.64);
+        }
+    };
+
+    /** u - u^3/3 on |u| <= 1.5, held at +-0.375 beyond - Saturated mode */
+    struct CubicSaturation
+    {
+        static constexpr double LIMIT = 1.5;
+        static constexpr double F1_LIMIT = 0.703125;     // F1(1.5)
+        static constexpr double F2_LIMIT = 0.4359375;    // F2(1.5)
+
+        template <typename T>
+        static T f(T u) noexcept
+        {
+            const T x = std::max(T(-LIMIT), std::min(T(LIMIT), u));
+            return x - (x * x * x) / T(3);
+        }
+
+        static double F1(double u) noexcept
+        {
+            const double a = std::abs(u);
+            if (a <= LIMIT)
+                return a * a * 0.5 - a * a * a * a / 12.0;
+            return F1_LIMIT + 0.375 * (a - LIMIT);
+        }
+
+        static double F2(double u) noexcept
+        {
+            const double a = std::abs(u);
+            if (a <= LIMIT)
+                return u * u * u / 6.0 - u * u * u * u * u / 60.0;
+
+            const double d = a - LIMIT;
+            return sign(u) * (F2_LIMIT + F1_LIMIT * d + 0.1875 * d * d);
+        }
+    };
+
+    /** 0.7 clip(u) + 0.3 u - Fuzz mode (hard clip blended with the rectified, sign-restored input) */
+    struct Fuzz
+    {
+        template <typename T>
+        static T f(T u) noexcept
+        {
+            return std::max(T(-1), std::min(T(1), u)) * T(0.7) + u * T(0.3);
+        }
+
+        static double F1(double u) noexcept
+        {
+            const double a = std::abs(u);
+            const double clipped = a <= 1.0 ? a * a * 0.5 : a - 0.5;
+            return 0.7 * clipped + 0.15 * u * u;
+        }
+
+        static double F2(double u) noexcept
+        {
+            const double a = std::abs(u);
+            const double clipped = a <= 1.0 ? a * a * a / 6.0
+                                            : 1.0 / 6.0 + (a * a - 1.0) * 0.5 - (a - 1.0) * 0.5;
+            return sign(u) * 0.7 * clipped + 0.05 * u * u * u;
+        }
+    };
+
+    /** Three-segment soft knee: slope 1 below 0.5, 0.5 up to 1, 0.1 beyond - Tape mode */
+    struct TapeKnee
+    {
+        template <typename T>
+        static T f(T u) noexcept
+        {
+            const T a = std::abs(u);
+            const T s = u >= T(0) ? T(1) : T(-1);
+
+            if (a < T(0.5))
+                return u;
+            if (a < T(1))
+                return s * (T(0.5) + (a - T(0.5)) * T(0.5));
+            return s * (T(0.75) + (a - T(1)) * T(0.1));
+        }
+
+        static double F1(double u) noexcept
+        {
+            const double a = std::abs(u);
+            if (a < 0.5)
+                return a * a * 0.5;
+            if (a < 1.0)
+                return 0.25 * a * a + 0.25 * a - 0.0625;
+            return 0.05 * a * a + 0.65 * a - 0.2625;
+        }
+
+        static double F2(double u) noexcept
+        {
+            const double a = std::abs(u);
+            double value;
+
+            if (a < 0.5)
+                value = a * a * a / 6.0;
+            else if (a < 1.0)
+                value = a * a * a / 12.0 + a * a / 8.0 - 0.0625 * a + 0.0104166666666666667;
+            else
+                value = a * a * a / 60.0 + 0.325 * a * a - 0.2625 * a + 0.0770833333333333333;
+
+            return sign(u) * value;
+        }
+    };
+
+    /**
+     * Per-channel ADAA state. A curve is anything with f, F1 and F2 - one of the
+     * structs above or a WaveshaperTable. The curve must stay the same between
+     * calls; prime() or reset() when switching curve or order.
+     */
+    class State
+    {
+    public:
+        void reset() noexcept
+        {
+            m_x1 = m_x2 = 0.0;
+            m_F1 = m_F2 = 0.0;
+            m_D1 = 0.0;
+        }
+
+        /** Sets the history as if input had been held constant, so a new curve starts without a jump. */
+        template <typename Curve>
+        void prime(const Curve& curve, float input) noexcept
+        {
+            m_x1 = m_x2 = input;
+            m_F1 = curve.F1(m_x1);
+            m_F2 = curve.F2(m_x1);
+            m_D1 = m_F1;
+        }
+
+        /** First-order ADAA (half a sample of delay). */
+        template <typename Curve>
+        float first(const Curve& curve, float input) noexcept
+        {
+            const double x = input;
+            const double F1 = curve.F1(x);
+            const double dx = x - m_x1;
+
+            const double y = std::abs(dx) > FIRST_ORDER_TOLERANCE ? (F1 - m_F1) / dx
+                                                                  : curve.f(0.5 * (x + m_x1));
+            m_x1 = x;
+            m_F1 = F1;
+            return static_cast<float>(y);
+        }
+
+        /** Second-order ADAA (one sample of delay). */
+        template <typename Curve>
+        float second(const Curve& curve, float input) noexcept
+        {
+            const double x = input;
+            const double F2 = curve.F2(x);
+            const double dx = x - m_x1;
+
+            // First divided difference of F2 between this and the previous input
+            const double D0 = std::abs(dx) > SECOND_ORDER_TOLERANCE ? (F2 - m_F2) / dx
+                                                                    : curve.F1(0.5 * (x + m_x1));
+
+            double y;
+            const double dx2 = x - m_x2;
+            if (std::abs(dx2) > SECOND_ORDER_TOLERANCE)
+            {
+                y = 2.0 * (D0 - m_D1) / dx2;
+            }
+            else
+            {
+                // x[n] ~ x[n-2]: expand around their midpoint
+                const double mid = 0.5 * (x + m_x2);
+                const double delta = mid - m_x1;
+
+                y = std::abs(delta) > SECOND_ORDER_TOLERANCE
+                        ? 2.0 / delta * (curve.F1(mid) + (m_F2 - curve.F2(mid)) / delta)
+                        : curve.f(0.5 * (mid + m_x1));
+            }
+
+            m_x2 = m_x1;
+            m_x1 = x;
+            m_F2 = F2;
+            m_D1 = D0;
+            return static_cast<float>(y);
+        }
+
+    private:
+        static constexpr double FIRST_ORDER_TOLERANCE = 1.0e-5;
+        static constexpr double SECOND_ORDER_TOLERANCE = 1.0e-4;
+
+        double m_x1 = 0.0;      // Previous inputs
+        double m_x2 = 0.0;
+        double m_F1 = 0.0;      // F1(m_x1)
+        double m_F2 = 0.0;      // F2(m_x1)
+        double m_D1 = 0.0;      // Previous first divided difference of F2
+    };
+}
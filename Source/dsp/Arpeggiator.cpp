@@ -1,13 +1,15 @@
 #include "Arpeggiator.h"
 #include <algorithm>
+#include <cmath>
 
-Arpeggiator::Arpeggiator() : m_rng(std::random_device{}())
+Arpeggiator::Arpeggiator()
 {
 }
 
 void Arpeggiator::prepare(double sampleRate)
 {
     m_sampleRate = sampleRate;
+    m_events.reserve(MAX_EVENTS);
     reset();
 }
 
@@ -16,73 +18,146 @@ void Arpeggiator::reset()
     m_currentStep = 0;
     m_currentOctave = 0;
     m_ascending = true;
-    m_sampleCounter = 0.0;
+    m_nextStepPpq = -1.0;
+    m_triggerPending = !m_heldNotes.empty();
+    m_random.reset();
     m_gateOpen = false;
-    m_shouldTrigger = false;
     m_currentNote = -1;
     m_currentVelocity = 0.0f;
+    m_events.clear();
 }
 
-bool Arpeggiator::process(double bpm, int64_t samplePosition)
+const std::vector<Arpeggiator::Event>& Arpeggiator::process(double bpm, double ppqPosition, int numSamples)
 {
-    m_shouldTrigger = false;
+    m_events.clear();
 
-    if (!m_enabled.load() || m_heldNotes.empty())
+    if (!m_enabled.load(std::memory_order_relaxed) || m_heldNotes.empty())
     {
+        // Release the last step when the notes are let go
+        if (m_gateOpen)
+            addEvent(Event::Type::NoteOff, 0);
+
         m_gateOpen = false;
         m_currentNote = -1;
-        return false;
+        m_nextStepPpq = -1.0;
+        return m_events;
     }
 
-    // Calculate timing
-    m_samplesPerBeat = m_sampleRate * 60.0 / bpm;
+    if (numSamples <= 0 || bpm <= 0.0)
+        return m_events;
 
-    Division div = m_division.load();
-    double beatsPerNote = getDivisionInBeats(div);
-    m_noteLengthSamples = m_samplesPerBeat * beatsPerNote;
+    // Timing - evaluated once per span
+    const double samplesPerBeat = m_sampleRate * 60.0 / bpm;
+    const double stepBeats = getDivisionInBeats(m_division.load(std::memory_order_relaxed));
+    const double swingBeats = stepBeats * MAX_SWING * m_swing.load(std::memory_order_relaxed);
+    const double gate = m_gate.load(std::memory_order_relaxed);
 
-    // Apply swing to even steps
-    float swing = m_swing.load();
-    if (m_currentStep % 2 == 1 && swing > 0.0f)
+    // First sample at or after a grid position
+    const auto toOffset = [&](double ppq)
+    {
+        return static_cast<int>(std::ceil((ppq - ppqPosition) * samplesPerBeat - 1.0e-6));
+    };
+
+    // Resync after a transport jump or loop (the next step is more than a sample
+    // behind us or far ahead)
+    const double sampleBeats = 1.0 / samplesPerBeat;
+    if (m_nextStepPpq >= 0.0
+        && (m_nextStepPpq < ppqPosition - sampleBeats || m_nextStepPpq > ppqPosition + 3.0 * stepBeats))
     {
-        m_noteLengthSamples *= (1.0 + swing * 0.5);
+        m_nextStepPpq = -1.0;
+        if (m_gateOpen)
+        {
+            addEvent(Event::Type::NoteOff, 0);
+            m_gateOpen = false;
+        }
     }
 
-    float gate = m_gate.load();
-    m_gateLengthSamples = m_noteLengthSamples * gate;
-
-    m_sampleCounter += 1.0;
-
-    // Check if we need to close the gate
-    if (m_gateOpen && m_sampleCounter >= m_gateLengthSamples)
+    if (m_triggerPending)
     {
-        m_gateOpen = false;
+        // The first note sounds straight away, then the pattern follows the grid
+        m_triggerPending = false;
+        advanceStep();
+        addEvent(Event::Type::NoteOn, 0);
+        m_gateOpen = true;
+        m_gateOffPpq = ppqPosition + gate * stepBeats;
+        m_nextStepPpq = findNextStep(ppqPosition + 1.0e-6, stepBeats, swingBeats);
+    }
+    else if (m_nextStepPpq < 0.0)
+    {
+        m_nextStepPpq = findNextStep(ppqPosition, stepBeats, swingBeats);
     }
 
-    // Check if we need to trigger a new note
-    if (m_sampleCounter >= m_noteLengthSamples)
+    while (true)
     {
-        m_sampleCounter = 0.0;
+        // Gate-offs come first when they coincide with the next step
+        if (m_gateOpen && m_gateOffPpq <= m_nextStepPpq)
+        {
+            const int offset = std::max(0, toOffset(m_gateOffPpq));
+            if (offset >= numSamples)
+                break;
+
+            addEvent(Event::Type::NoteOff, offset);
+            m_gateOpen = false;
+            continue;
+        }
+
+        // Events rounding past the end of the span fall at the start of the next
+        const int offset = std::max(0, toOffset(m_nextStepPpq));
+        if (offset >= numSamples)
+            break;
+
         advanceStep();
+        addEvent(Event::Type::NoteOn, offset);
         m_gateOpen = true;
-        m_shouldTrigger = true;
-        return true;
+
+        // Step length from the grid, so swing shortens odd steps as it lengthens even ones
+        const auto index = static_cast<int64_t>(std::floor(m_nextStepPpq / stepBeats + 1.0e-6));
+        const double start = m_nextStepPpq;
+        const double next = getStepStart(index + 1, stepBeats, swingBeats);
+
+        m_gateOffPpq = start + gate * (next - start);
+        m_nextStepPpq = next;
     }
 
-    return false;
+    return m_events;
+}
+
+double Arpeggiator::getStepStart(int64_t index, double stepBeats, double swingBeats) const
+{
+    return static_cast<double>(index) * stepBeats + ((index & 1) != 0 ? swingBeats : 0.0);
+}
+
+double Arpeggiator::findNextStep(double ppq, double stepBeats, double swingBeats) const
+{
+    auto index = static_cast<int64_t>(std::floor(ppq / stepBeats)) - 1;
+    while (getStepStart(index, stepBeats, swingBeats) < ppq - 1.0e-9)
+        ++index;
+
+    return getStepStart(index, stepBeats, swingBeats);
+}
+
+void Arpeggiator::addEvent(Event::Type type, int offset)
+{
+    // Never grows past the capacity reserved in prepare()
+    if (static_cast<int>(m_events.size()) >= MAX_EVENTS)
+        return;
+
+    Event event;
+    event.type = type;
+    event.offset = offset;
+    event.note = m_currentNote;
+    event.velocity = m_currentVelocity;
+    m_events.push_back(event);
 }
 
 void Arpeggiator::advanceStep()
 {
-    if (m_sortedNotes.empty())
-    {
-        sortNotes();
-        if (m_sortedNotes.empty()) return;
-    }
+    if (m_heldNotes.empty())
+        return;
 
     Mode mode = m_mode.load();
     int octaves = m_octaves.load();
-    int numNotes = static_cast<int>(m_sortedNotes.size());
+    int numNotes = m_heldNotes.size();
     int totalSteps = numNotes * octaves;
 
     // Get base note index based on mode
@@ -155,23 +230,21 @@ void Arpeggiator::advanceStep()
 
         case Mode::Random:
         {
-            std::uniform_int_distribution<int> noteDist(0, numNotes - 1);
-            std::uniform_int_distribution<int> octDist(0, octaves - 1);
-            noteIndex = noteDist(m_rng);
-            m_currentOctave = octDist(m_rng);
+            noteIndex = m_random.nextInt(numNotes);
+            m_currentOctave = m_random.nextInt(octaves);
             m_currentStep++;
             break;
         }
 
         case Mode::Order:
-            // Play in order notes were pressed (use heldNotes directly)
-            if (!m_heldNotes.empty())
+            // Play in order notes were pressed
             {
-                int idx = m_currentStep % static_cast<int>(m_heldNotes.size());
-                m_currentNote = m_heldNotes[idx].first + m_currentOctave * 12;
-                m_currentVelocity = m_heldNotes[idx].second;
-                m_currentOctave = (m_currentStep / static_cast<int>(m_heldNotes.size())) % octaves;
-                m_currentStep = (m_currentStep + 1) % (static_cast<int>(m_heldNotes.size()) * octaves);
+                int idx = m_currentStep % numNotes;
+                int note = m_heldNotes.getInOrder(idx);
+                m_currentNote = note + m_currentOctave * 12;
+                m_currentVelocity = m_heldNotes.getVelocity(note);
+                m_currentOctave = (m_currentStep / numNotes) % octaves;
+                m_currentStep = (m_currentStep + 1) % totalSteps;
             }
             return;
 
@@ -185,30 +258,12 @@ void Arpeggiator::advanceStep()
     // Set current note
     if (noteIndex >= 0 && noteIndex < numNotes)
     {
-        m_currentNote = m_sortedNotes[noteIndex] + m_currentOctave * 12;
-
-        // Find velocity for this note
-        for (const auto& pair : m_heldNotes)
-        {
-            if (pair.first == m_sortedNotes[noteIndex])
-            {
-                m_currentVelocity = pair.second;
-                break;
-            }
-        }
+        const int note = m_heldNotes.getSorted(noteIndex);
+        m_currentNote = note + m_currentOctave * 12;
+        m_currentVelocity = m_heldNotes.getVelocity(note);
     }
 }
 
-void Arpeggiator::sortNotes()
-{
-    m_sortedNotes.clear();
-    for (const auto& pair : m_heldNotes)
-    {
-        m_sortedNotes.push_back(pair.first);
-    }
-    std::sort(m_sortedNotes.begin(), m_sortedNotes.end());
-}
-
 double Arpeggiator::getDivisionInBeats(Division div)
 {
     switch (div)
@@ -231,49 +286,32 @@ double Arpeggiator::getDivisionInBeats(Division div)
 
 void Arpeggiator::noteOn(int midiNote, float velocity)
 {
-    // Check if note already held
-    for (auto& pair : m_heldNotes)
-    {
-        if (pair.first == midiNote)
-        {
-            pair.second = velocity;
-            return;
-        }
-    }
-
-    m_heldNotes.push_back({midiNote, velocity});
-    sortNotes();
+    // A note already held only updates its velocity
+    if (!m_heldNotes.insert(midiNote, velocity))
+        return;
 
     // If this is the first note, start immediately
     if (m_heldNotes.size() == 1)
     {
         m_currentStep = 0;
         m_currentOctave = 0;
-        m_sampleCounter = m_noteLengthSamples; // Trigger immediately
+        m_triggerPending = true;
     }
 }
 
 void Arpeggiator::noteOff(int midiNote)
 {
-    m_heldNotes.erase(
-        std::remove_if(m_heldNotes.begin(), m_heldNotes.end(),
-            [midiNote](const std::pair<int, float>& p) { return p.first == midiNote; }),
-        m_heldNotes.end());
-
-    sortNotes();
+    m_heldNotes.remove(midiNote);
 
+    // The gate closes at the start of the next process() call
     if (m_heldNotes.empty())
-    {
-        m_gateOpen = false;
-        m_currentNote = -1;
-    }
+        m_triggerPending = false;
 }
 
 void Arpeggiator::allNotesOff()
 {
     m_heldNotes.clear();
-    m_sortedNotes.clear();
-    m_gateOpen = false;
+    m_triggerPending = false;
     m_currentNote = -1;
     m_currentStep = 0;
     m_currentOctave = 0;
@@ -284,10 +322,6 @@ void Arpeggiator::allNotesOff()
 void Arpeggiator::setEnabled(bool enabled)
 {
     m_enabled.store(enabled, std::memory_order_relaxed);
-    if (!enabled)
-    {
-        m_gateOpen = false;
-    }
 }
 
 void Arpeggiator::setMode(Mode mode)
@@ -1,12 +1,18 @@
 #pragma once
 
 #include <juce_audio_basics/juce_audio_basics.h>
+#include "../core/HeldNoteSet.h"
+#include "../core/RandomGenerator.h"
 #include <atomic>
 #include <vector>
-#include <random>
 
 /**
  * Arpeggiator with multiple modes, tempo sync, and gate control
+ *
+ * Steps are locked to the host's musical position: for each span of samples
+ * process() works out where the next steps and gate-offs fall on the ppq grid
+ * and returns them as sample-accurate events, so the cost scales with notes
+ * rather than samples and the pattern never drifts against the host.
  */
 class Arpeggiator {
 public:
@@ -33,15 +39,30 @@ public:
         TripletEighth
     };
 
+    /** A step starting (NoteOn) or its gate closing (NoteOff) at a sample offset. */
+    struct Event {
+        enum class Type { NoteOn, NoteOff };
+
+        Type type = Type::NoteOn;
+        int offset = 0;
+        int note = -1;
+        float velocity = 0.0f;
+    };
+
+    static constexpr int MAX_EVENTS = 256;   // Per process() call
+
     Arpeggiator();
     ~Arpeggiator() = default;
 
     void prepare(double sampleRate);
     void reset();
 
-    // Process one sample's worth of timing
-    // Returns true if a new note should trigger
-    bool process(double bpm, int64_t samplePosition);
+    /**
+     * Schedules the steps and gate-offs for numSamples samples starting at
+     * ppqPosition (quarter notes). Offsets in the returned events are relative
+     * to the start of the span, in time order.
+     */
+    const std::vector<Event>& process(double bpm, double ppqPosition, int numSamples);
 
     // Note management
     void noteOn(int midiNote, float velocity);
@@ -52,7 +73,9 @@ public:
     int getCurrentNote() const { return m_currentNote; }
     float getCurrentVelocity() const { return m_currentVelocity; }
     bool isNoteActive() const { return m_gateOpen && !m_heldNotes.empty(); }
-    bool shouldTrigger() const { return m_shouldTrigger; }
+
+    /** No notes held and no gate left to close: process() has nothing to schedule. */
+    bool isIdle() const { return !m_gateOpen && m_heldNotes.empty(); }
 
     // Parameters
     void setEnabled(bool enabled);
@@ -66,16 +89,25 @@ public:
 
     bool isEnabled() const { return m_enabled.load(); }
 
+    // Random mode seed - not thread safe, set before prepare(); reset() restarts the sequence
+    void setRandomSeed(uint64_t seed) { m_random.setSeed(seed); }
+
 private:
     void advanceStep();
-    void sortNotes();
     double getDivisionInBeats(Division div);
 
+    // Start of grid step index, with odd steps delayed by swing
+    double getStepStart(int64_t index, double stepBeats, double swingBeats) const;
+
+    // First step starting at or after ppq
+    double findNextStep(double ppq, double stepBeats, double swingBeats) const;
+
+    void addEvent(Event::Type type, int offset);
+
     double m_sampleRate = 44100.0;
 
     // Note storage
-    std::vector<std::pair<int, float>> m_heldNotes;  // note, velocity pairs
-    std::vector<int> m_sortedNotes;
+    HeldNoteSet m_heldNotes;
     int m_currentStep = 0;
     int m_currentOctave = 0;
     bool m_ascending = true;  // For up/down mode
@@ -84,17 +116,17 @@ private:
     int m_currentNote = -1;
     float m_currentVelocity = 0.0f;
     bool m_gateOpen = false;
-    bool m_shouldTrigger = false;
 
-    // Timing
-    double m_samplesPerBeat = 22050.0;
-    double m_sampleCounter = 0.0;
-    double m_noteLengthSamples = 0.0;
-    double m_gateLengthSamples = 0.0;
-    bool m_noteJustTriggered = false;
+    // Timing, in quarter notes on the host grid
+    double m_nextStepPpq = -1.0;       // Negative until synced to the grid
+    double m_gateOffPpq = 0.0;
+    bool m_triggerPending = false;     // First held note starts without waiting for the grid
+    std::vector<Event> m_events;
+
+    static constexpr double MAX_SWING = 0.5;     // Odd steps delayed by up to half a step
 
     // Random
-    std::mt19937 m_rng;
+    RandomGenerator m_random;
 
     // Parameters
     std::atomic<bool> m_enabled{false};
@@ -0,0 +1,545 @@
+#include "Convolver.h"
+#include <algorithm>
+
+// === WORKSPACE ===
+
+void Convolver::Workspace::prepare(int blockSize, int numChannels)
+{
+    const int fftSize = 2 * blockSize;
+    m_fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(fftSize)));
+    m_blockSize = blockSize;
+
+    for (int c = 0; c < MAX_CHANNELS; ++c)
+        m_output[c].assign(c < numChannels ? static_cast<size_t>(2 * fftSize) : 0, 0.0f);
+}
+
+void Convolver::Workspace::clear()
+{
+    for (auto& output : m_output)
+        std::fill(output.begin(), output.end(), 0.0f);
+}
+
+// === SEGMENT ===
+
+void Convolver::Segment::prepare(int blockSize, const std::vector<float>* responses, int numPartitions,
+                                 int numChannels, int historySlots)
+{
+    const int fftSize = 2 * blockSize;
+    m_fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(fftSize)));
+
+    m_blockSize = blockSize;
+    m_numBins = blockSize + 1;
+    m_numPartitions = numPartitions;
+    m_numChannels = numChannels;
+    m_responses = responses;
+    m_historySlots = std::max(numPartitions, historySlots);
+
+    m_history.assign(static_cast<size_t>(2 * m_numBins * m_historySlots), 0.0f);
+    m_spectrum.assign(static_cast<size_t>(2 * fftSize), 0.0f);
+    m_historyPos = 0;
+    m_numFilled = 0;
+}
+
+void Convolver::Segment::transformPartitions(std::vector<float>& spectra, const float* response, int start, int end, int blockSize)
+{
+    const int fftSize = 2 * blockSize;
+    const int spectrumSize = 2 * (blockSize + 1);
+    const int numPartitions = (end - start + blockSize - 1) / blockSize;
+
+    juce::dsp::FFT fft(juce::roundToInt(std::log2(fftSize)));
+    std::vector<float> scratch(static_cast<size_t>(2 * fftSize));
+    spectra.assign(static_cast<size_t>(spectrumSize * numPartitions), 0.0f);
+
+    for (int p = 0; p < numPartitions; ++p)
+    {
+        const int partitionStart = start + p * blockSize;
+        const int numSamples = std::min(blockSize, end - partitionStart);
+
+        std::fill(scratch.begin(), scratch.end(), 0.0f);
+        std::copy(response + partitionStart, response + partitionStart + numSamples, scratch.begin());
+        fft.performRealOnlyForwardTransform(scratch.data(), true);
+
+        std::copy(scratch.begin(), scratch.begin() + spectrumSize,
+                  spectra.begin() + static_cast<std::ptrdiff_t>(p * spectrumSize));
+    }
+}
+
+int Convolver::Segment::push(const float* input) noexcept
+{
+    const int spectrumSize = 2 * m_numBins;
+    const int slot = m_historyPos;
+
+    // Spectrum of the last two blocks, pushed onto the history ring
+    std::copy(input, input + 2 * m_blockSize, m_spectrum.begin());
+    std::fill(m_spectrum.begin() + 2 * m_blockSize, m_spectrum.end(), 0.0f);
+    m_fft->performRealOnlyForwardTransform(m_spectrum.data(), true);
+
+    std::copy(m_spectrum.begin(), m_spectrum.begin() + spectrumSize,
+              m_history.begin() + static_cast<std::ptrdiff_t>(slot * spectrumSize));
+
+    m_historyPos = (m_historyPos + 1) % m_historySlots;
+    m_numFilled = std::min(m_numFilled + 1, m_numPartitions);
+    return slot;
+}
+
+bool Convolver::Segment::convolve(int newest, int numFilled, Workspace& workspace, const std::atomic<int>* jobState) const noexcept
+{
+    const int spectrumSize = 2 * m_numBins;
+
+    for (int c = 0; c < m_numChannels; ++c)
+    {
+        float* accumulator = workspace.m_output[c].data();
+        std::fill(accumulator, accumulator + workspace.m_output[c].size(), 0.0f);
+
+        // Partition p meets the input spectrum from p blocks ago; slots from
+        // before the last clear() count as silence
+        for (int p = 0; p < numFilled; ++p)
+        {
+            // A cancelled job's result is thrown away - stop reading the history
+            if (jobState != nullptr && jobState->load(std::memory_order_relaxed) == Cancelled)
+                return false;
+
+            const int slot = (newest - p + m_historySlots) % m_historySlots;
+            const float* x = m_history.data() + slot * spectrumSize;
+            const float* h = m_responses[c].data() + p * spectrumSize;
+
+            for (int b = 0; b < spectrumSize; b += 2)
+            {
+                accumulator[b]     += x[b] * h[b]     - x[b + 1] * h[b + 1];
+                accumulator[b + 1] += x[b] * h[b + 1] + x[b + 1] * h[b];
+            }
+        }
+
+        // Only the second half is free of wrap-around
+        workspace.m_fft->performRealOnlyInverseTransform(accumulator);
+    }
+
+    return true;
+}
+
+// === CONVOLVER ===
+
+std::shared_ptr<const Convolver::Response> Convolver::createResponse(const juce::AudioBuffer<float>& impulseResponse)
+{
+    auto response = std::make_shared<Response>();
+
+    response->numChannels = std::min(MAX_CHANNELS, impulseResponse.getNumChannels());
+    response->length = response->numChannels > 0 ? impulseResponse.getNumSamples() : 0;
+    if (response->length == 0)
+    {
+        response->numChannels = 0;
+        return response;
+    }
+
+    const int length = response->length;
+    const int midEnd = std::min(length, 2 * TAIL_SIZE);
+    response->numMid = std::max(0, (midEnd - HEAD_SIZE + HEAD_SIZE - 1) / HEAD_SIZE);
+    response->numTail = std::max(0, (length - 2 * TAIL_SIZE + TAIL_SIZE - 1) / TAIL_SIZE);
+
+    for (int c = 0; c < response->numChannels; ++c)
+    {
+        const float* samples = impulseResponse.getReadPointer(c);
+
+        // Head taps reversed to line up with the history window, oldest first
+        for (int k = 0; k < HEAD_SIZE; ++k)
+            response->headTaps[c][HEAD_SIZE - 1 - k] = k < length ? samples[k] : 0.0f;
+
+        if (response->numMid > 0)
+            Segment::transformPartitions(response->mid[c], samples, HEAD_SIZE, midEnd, HEAD_SIZE);
+
+        if (response->numTail > 0)
+            Segment::transformPartitions(response->tail[c], samples, 2 * TAIL_SIZE, length, TAIL_SIZE);
+    }
+
+    return response;
+}
+
+Convolver::Convolver(bool useWorker)
+    : m_useWorker(useWorker),
+      m_state(std::make_unique<State>())
+{
+}
+
+Convolver::~Convolver()
+{
+    detachWorker();
+}
+
+void Convolver::setWorker(std::shared_ptr<Worker> worker)
+{
+    detachWorker();
+    m_worker = std::move(worker);
+    attachWorker();
+}
+
+void Convolver::attachWorker()
+{
+    if (!m_state->m_hasTail)
+        return;
+
+    // Started with the first response that reaches the tail, and kept
+    if (m_worker == nullptr)
+    {
+        if (!m_useWorker)
+            return;
+
+        m_worker = std::make_shared<Worker>();
+    }
+
+    m_worker->attach(*this);
+
+    const juce::SpinLock::ScopedLockType lock(m_lock);
+    m_workerAttached = true;
+}
+
+void Convolver::detachWorker()
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(m_lock);
+        if (!m_workerAttached)
+            return;
+
+        m_workerAttached = false;
+    }
+
+    // A job still posted to it is taken back at its deadline, and one it had
+    // cancelled will not be acknowledged now
+    m_worker->detach(*this);
+
+    int state = Cancelled;
+    m_state->m_jobState.compare_exchange_strong(state, Idle, std::memory_order_acq_rel);
+}
+
+void Convolver::setImpulseResponse(const juce::AudioBuffer<float>& impulseResponse)
+{
+    setImpulseResponse(createResponse(impulseResponse));
+}
+
+void Convolver::setImpulseResponse(std::shared_ptr<const Response> response)
+{
+    jassert(response != nullptr);
+
+    // FFTs and buffers are built before taking the lock
+    auto state = std::make_unique<State>(std::move(response));
+
+    detachWorker();
+
+    {
+        const juce::SpinLock::ScopedLockType lock(m_lock);
+        std::swap(m_state, state);
+        m_length = m_state->m_response->length;
+    }
+
+    attachWorker();
+
+    // The old state is released here, off the audio thread
+}
+
+void Convolver::reset()
+{
+    m_state->reset();
+}
+
+// === STATE ===
+
+Convolver::State::State(std::shared_ptr<const Response> response)
+    : m_response(std::move(response))
+{
+    m_numChannels = m_response->numChannels;
+    m_hasMid = m_response->numMid > 0;
+    m_hasTail = m_response->numTail > 0;
+
+    if (m_hasMid)
+    {
+        m_mid.prepare(HEAD_SIZE, m_response->mid, m_response->numMid, m_numChannels, m_response->numMid);
+        m_midWorkspace.prepare(HEAD_SIZE, m_numChannels);
+    }
+
+    if (m_hasTail)
+    {
+        // Two spare slots: a job cancelled at its deadline may still be
+        // reading its oldest spectra while the next two blocks are pushed
+        m_tail.prepare(TAIL_SIZE, m_response->tail, m_response->numTail, m_numChannels, m_response->numTail + 2);
+        m_tailWorkspace.prepare(TAIL_SIZE, m_numChannels);
+    }
+
+    m_midInput.assign(2 * HEAD_SIZE, 0.0f);
+    m_tailInput.assign(2 * TAIL_SIZE, 0.0f);
+    m_silence.assign(TAIL_SIZE, 0.0f);
+    for (int c = 0; c < MAX_CHANNELS; ++c)
+    {
+        m_tailOutput[c].assign(TAIL_SIZE, 0.0f);
+        m_jobOutput[c].assign(TAIL_SIZE, 0.0f);
+    }
+}
+
+void Convolver::State::reset() noexcept
+{
+    // Drops a posted job: taken back if the worker has not started it,
+    // otherwise cancelled. A cancelled job reads the tail history until the
+    // worker acknowledges it, so the segments only forget their spectra
+    // rather than zeroing them (the spare slots cover what is pushed meanwhile).
+    if (m_tailJobPosted && !m_tailJobInline)
+    {
+        int state = Pending;
+        if (!m_jobState.compare_exchange_strong(state, Idle, std::memory_order_acq_rel))
+        {
+            if (state == Done)
+                m_jobState.store(Idle, std::memory_order_relaxed);
+            else if (state == Running)
+                m_jobState.compare_exchange_strong(state, Cancelled, std::memory_order_acq_rel);
+        }
+    }
+
+    m_tailJobPosted = false;
+
+    std::fill(std::begin(m_headHistory), std::end(m_headHistory), 0.0f);
+    m_headPos = 0;
+
+    std::fill(m_midInput.begin(), m_midInput.end(), 0.0f);
+    m_midPos = 0;
+    m_mid.clear();
+    m_midWorkspace.clear();
+
+    std::fill(m_tailInput.begin(), m_tailInput.end(), 0.0f);
+    for (auto& output : m_tailOutput)
+        std::fill(output.begin(), output.end(), 0.0f);
+    m_tailPos = 0;
+    m_tail.clear();
+}
+
+void Convolver::process(const float* input, float* left, float* right, int numSamples) noexcept
+{
+    // Never waits: a block that overlaps a response change renders silence
+    const juce::SpinLock::ScopedTryLockType lock(m_lock);
+
+    if (!lock.isLocked() || m_length == 0)
+    {
+        std::fill(left, left + numSamples, 0.0f);
+        if (right != nullptr)
+            std::fill(right, right + numSamples, 0.0f);
+        return;
+    }
+
+    Worker* worker = m_workerAttached ? m_worker.get() : nullptr;
+    if (right != nullptr)
+        m_state->render<true>(input, left, right, numSamples, worker);
+    else
+        m_state->render<false>(input, left, nullptr, numSamples, worker);
+}
+
+template <bool Stereo>
+void Convolver::State::render(const float* input, float* left, float* right, int numSamples, Worker* worker) noexcept
+{
+    const int numChannels = m_numChannels;
+
+    for (int i = 0; i < numSamples;)
+    {
+        // Run up to the next mid boundary (tail boundaries fall on mid boundaries)
+        const int n = std::min(numSamples - i, HEAD_SIZE - m_midPos);
+
+        const float* midOutput[MAX_CHANNELS];
+        const float* tailOutput[MAX_CHANNELS];
+        for (int c = 0; c < numChannels; ++c)
+        {
+            midOutput[c] = (m_hasMid ? m_midWorkspace.getOutput(c) : m_silence.data()) + m_midPos;
+            tailOutput[c] = m_tailOutput[c].data() + m_tailPos;
+        }
+
+        float* midInput = m_midInput.data() + HEAD_SIZE + m_midPos;
+        float* tailInput = m_tailInput.data() + TAIL_SIZE + m_tailPos;
+
+        for (int s = 0; s < n; ++s)
+        {
+            const float x = input[i + s];
+            midInput[s] = x;
+            tailInput[s] = x;
+
+            m_headHistory[m_headPos] = x;
+            m_headHistory[m_headPos + HEAD_SIZE] = x;
+            m_headPos = (m_headPos + 1) & (HEAD_SIZE - 1);
+
+            const float* window = m_headHistory + m_headPos;
+
+            float y[MAX_CHANNELS] = {};
+            for (int c = 0; c < numChannels; ++c)
+            {
+                // Four partial sums keep the FIR out of one long dependency chain
+                const float* taps = m_response->headTaps[c];
+                float sums[4] = {};
+                for (int k = 0; k < HEAD_SIZE; k += 4)
+                {
+                    sums[0] += window[k] * taps[k];
+                    sums[1] += window[k + 1] * taps[k + 1];
+                    sums[2] += window[k + 2] * taps[k + 2];
+                    sums[3] += window[k + 3] * taps[k + 3];
+                }
+
+                y[c] = (sums[0] + sums[1]) + (sums[2] + sums[3]) + midOutput[c][s] + tailOutput[c][s];
+            }
+
+            if constexpr (Stereo)
+            {
+                left[i + s] = y[0];
+                right[i + s] = numChannels > 1 ? y[1] : y[0];
+            }
+            else
+            {
+                left[i + s] = numChannels > 1 ? 0.5f * (y[0] + y[1]) : y[0];
+            }
+        }
+
+        i += n;
+        m_midPos += n;
+        m_tailPos += n;
+
+        if (m_midPos == HEAD_SIZE)
+        {
+            runMid();
+            m_midPos = 0;
+        }
+
+        if (m_tailPos == TAIL_SIZE)
+        {
+            runTail(worker);
+            m_tailPos = 0;
+        }
+    }
+}
+
+void Convolver::State::runMid() noexcept
+{
+    if (m_hasMid)
+    {
+        const int slot = m_mid.push(m_midInput.data());
+        m_mid.convolve(slot, m_mid.m_numFilled, m_midWorkspace);
+    }
+
+    std::copy(m_midInput.begin() + HEAD_SIZE, m_midInput.end(), m_midInput.begin());
+}
+
+void Convolver::State::runTail(Worker* worker) noexcept
+{
+    if (!m_hasTail)
+        return;
+
+    // The job posted a block ago is due now - it plays over the next block
+    if (m_tailJobPosted)
+        finishTailJob();
+
+    // Transform the block that just completed; summing the partitions is not
+    // needed for another block, so that is posted to the worker
+    m_tailJobSlot = m_tail.push(m_tailInput.data());
+    m_tailJobFilled = m_tail.m_numFilled;
+    std::copy(m_tailInput.begin() + TAIL_SIZE, m_tailInput.end(), m_tailInput.begin());
+
+    m_tailJobPosted = true;
+    m_tailJobInline = true;
+
+    // Until the worker has acknowledged a cancelled job, this one stays here
+    if (worker != nullptr && m_jobState.load(std::memory_order_acquire) == Idle)
+    {
+        m_jobSlot = m_tailJobSlot;
+        m_jobFilled = m_tailJobFilled;
+        m_jobState.store(Pending, std::memory_order_release);
+        m_tailJobInline = false;
+        worker->post();
+    }
+}
+
+void Convolver::State::finishTailJob() noexcept
+{
+    m_tailJobPosted = false;
+
+    if (!m_tailJobInline)
+    {
+        int state = Pending;
+        if (!m_jobState.compare_exchange_strong(state, Idle, std::memory_order_acq_rel))
+        {
+            // Running past its deadline: cancel it rather than wait, and run it
+            // here into separate buffers. Otherwise it has just finished.
+            if (state != Running || !m_jobState.compare_exchange_strong(state, Cancelled, std::memory_order_acq_rel))
+            {
+                jassert(state == Done);
+                for (int c = 0; c < m_numChannels; ++c)
+                    std::copy(m_jobOutput[c].begin(), m_jobOutput[c].end(), m_tailOutput[c].begin());
+
+                m_jobState.store(Idle, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    m_tail.convolve(m_tailJobSlot, m_tailJobFilled, m_tailWorkspace);
+    for (int c = 0; c < m_numChannels; ++c)
+        std::copy(m_tailWorkspace.getOutput(c), m_tailWorkspace.getOutput(c) + TAIL_SIZE, m_tailOutput[c].begin());
+}
+
+void Convolver::State::runWorkerJob(Workspace& workspace) noexcept
+{
+    int state = Pending;
+    if (!m_jobState.compare_exchange_strong(state, Running, std::memory_order_acq_rel))
+        return;
+
+    if (m_tail.convolve(m_jobSlot, m_jobFilled, workspace, &m_jobState))
+        for (int c = 0; c < m_numChannels; ++c)
+            std::copy(workspace.getOutput(c), workspace.getOutput(c) + TAIL_SIZE, m_jobOutput[c].begin());
+
+    // Cancelled meanwhile: the audio thread has rendered it itself
+    state = Running;
+    if (!m_jobState.compare_exchange_strong(state, Done, std::memory_order_acq_rel))
+        m_jobState.store(Idle, std::memory_order_release);
+}
+
+// === WORKER ===
+
+Convolver::Worker::Worker()
+    : juce::Thread("Convolution tail")
+{
+    m_workspace.prepare(TAIL_SIZE, MAX_CHANNELS);
+
+    // Below the audio thread, above everything else
+    startThread(juce::Thread::Priority::highest);
+}
+
+Convolver::Worker::~Worker()
+{
+    jassert(m_convolvers.empty());
+
+    signalThreadShouldExit();
+    m_semaphore.post();
+    stopThread(-1);
+}
+
+void Convolver::Worker::attach(Convolver& convolver)
+{
+    const juce::ScopedLock lock(m_lock);
+    m_convolvers.push_back(&convolver);
+}
+
+void Convolver::Worker::detach(Convolver& convolver)
+{
+    const juce::ScopedLock lock(m_lock);
+    m_convolvers.erase(std::remove(m_convolvers.begin(), m_convolvers.end(), &convolver), m_convolvers.end());
+}
+
+void Convolver::Worker::post() noexcept
+{
+    m_semaphore.post();
+}
+
+void Convolver::Worker::run()
+{
+    while (!threadShouldExit())
+    {
+        m_semaphore.wait();
+
+        if (threadShouldExit())
+            break;
+
+        // One post per job, but a pass runs whatever is pending
+        const juce::ScopedLock lock(m_lock);
+        for (auto* convolver : m_convolvers)
+            convolver->runWorkerJob(m_workspace);
+    }
+}
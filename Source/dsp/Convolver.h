@@ -0,0 +1,256 @@
+#pragma once
+
+#include "../core/Semaphore.h"
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * Zero-latency, non-uniformly partitioned convolution of a mono input with a
+ * mono or stereo impulse response
+ *
+ * The impulse response is split into three segments:
+ *
+ *   head  [0, HEAD_SIZE)              - direct-form FIR, sample by sample
+ *   mid   [HEAD_SIZE, 2 * TAIL_SIZE)  - uniform FFT partitions of HEAD_SIZE,
+ *                                       run on the audio thread every HEAD_SIZE samples
+ *   tail  [2 * TAIL_SIZE, length)     - uniform FFT partitions of TAIL_SIZE,
+ *                                       summed on a background worker
+ *
+ * Each FFT segment starts one of its own blocks into the response, which
+ * hides the block it has to buffer, so the sum has no latency. When a tail
+ * block completes the audio thread transforms it onto the spectrum history
+ * and posts the job of summing the partitions, which is not needed until a
+ * whole TAIL_SIZE later. The worker sleeps on a semaphore and runs above
+ * normal priority. The audio thread never waits for it: a job the worker has
+ * not started by its deadline is run inline, and one it is still running is
+ * cancelled and run inline into separate buffers. Short responses such as
+ * speaker cabinets never reach the tail and cost only the head and mid
+ * segments.
+ *
+ * Input spectra are computed once and shared by both output channels. The
+ * response spectra are built once into an immutable Response, which any
+ * number of convolvers can share, and the worker can serve several
+ * convolvers (see EffectsRack).
+ *
+ * setImpulseResponse() allocates and is called from the message thread. It
+ * builds the new state outside the lock and only swaps a pointer under a
+ * SpinLock the audio thread try-locks, so the audio thread renders silence
+ * for at most the block that overlaps the swap rather than waiting.
+ */
+class Convolver {
+public:
+    static constexpr int HEAD_SIZE = 64;
+    static constexpr int TAIL_SIZE = 1024;
+    static constexpr int MAX_CHANNELS = 2;
+
+    /** Response spectra and head taps, immutable once built. */
+    struct Response {
+        int length = 0;
+        int numChannels = 0;
+        int numMid = 0;                                 // Partitions per segment
+        int numTail = 0;
+
+        alignas(16) float headTaps[MAX_CHANNELS][HEAD_SIZE] = {};   // Reversed, oldest first
+        std::vector<float> mid[MAX_CHANNELS];           // Partition spectra, interleaved complex
+        std::vector<float> tail[MAX_CHANNELS];
+    };
+
+    /** Message thread: builds the response (1 or 2 channels); an empty buffer builds an empty one. */
+    static std::shared_ptr<const Response> createResponse(const juce::AudioBuffer<float>& impulseResponse);
+
+    /** Tail job thread, which can be shared by several convolvers. */
+    class Worker;
+
+    explicit Convolver(bool useWorker = true);
+    ~Convolver();
+
+    /** Message thread: replaces the response (1 or 2 channels) and clears the state. An empty buffer unloads it. */
+    void setImpulseResponse(const juce::AudioBuffer<float>& impulseResponse);
+    void setImpulseResponse(std::shared_ptr<const Response> response);
+
+    /**
+     * Message thread: runs the tail jobs on a worker shared with other
+     * convolvers. Without one (nullptr), a convolver built with useWorker
+     * starts its own for the first response that reaches the tail.
+     */
+    void setWorker(std::shared_ptr<Worker> worker);
+
+    bool hasImpulseResponse() const { return m_length > 0; }
+    int getLength() const { return m_length; }
+
+    /** Clears the convolution state, keeping the response. Not thread safe. */
+    void reset();
+
+    /**
+     * Convolves numSamples of input. right may be nullptr to render a mono
+     * (L+R)/2 downmix of a stereo response into left.
+     */
+    void process(const float* input, float* left, float* right, int numSamples) noexcept;
+
+private:
+    /**
+     * FFT and accumulators for one thread summing partitions. Each thread has
+     * its own, as JUCE's fallback FFT engine locks per instance.
+     */
+    struct Workspace {
+        void prepare(int blockSize, int numChannels);
+        void clear();
+
+        const float* getOutput(int channel) const { return m_output[channel].data() + m_blockSize; }
+
+        std::unique_ptr<juce::dsp::FFT> m_fft;
+        int m_blockSize = 0;
+        std::vector<float> m_output[MAX_CHANNELS];      // Accumulated spectrum, then output block
+    };
+
+    /** One uniformly partitioned FFT segment: block size, input spectrum history and the response spectra it uses. */
+    struct Segment {
+        // historySlots beyond numPartitions keep spectra a late job still reads
+        void prepare(int blockSize, const std::vector<float>* responses, int numPartitions, int numChannels, int historySlots);
+
+        // Forgets the history without writing to it, so a cancelled job
+        // still reading its spectra is not disturbed
+        void clear() noexcept { m_numFilled = 0; }
+
+        // Spectra of each blockSize partition of the response, zero padded to
+        // the FFT size so the circular convolution is linear over the valid half
+        static void transformPartitions(std::vector<float>& spectra, const float* response, int start, int end, int blockSize);
+
+        // Transforms the last two blocks of input (overlap-save) onto the
+        // history ring and returns the slot it was written to
+        int push(const float* input) noexcept;
+
+        // Sums the first numFilled partitions against the spectra up to the
+        // newest slot, leaving the next block of output per channel in the
+        // workspace. Returns false if abandoned because the job was cancelled.
+        bool convolve(int newest, int numFilled, Workspace& workspace, const std::atomic<int>* jobState = nullptr) const noexcept;
+
+        std::unique_ptr<juce::dsp::FFT> m_fft;          // Forward transforms of push()
+        int m_blockSize = 0;
+        int m_numBins = 0;
+        int m_numPartitions = 0;
+        int m_numChannels = 0;
+
+        const std::vector<float>* m_responses = nullptr;    // Per channel, in the Response
+        std::vector<float> m_history;                   // Input spectra ring
+        int m_historySlots = 0;
+        int m_historyPos = 0;
+        int m_numFilled = 0;                            // Slots pushed since clear(), up to m_numPartitions
+
+        std::vector<float> m_spectrum;                  // push() scratch, 2 * fft size
+    };
+
+    // Tail job hand-off. The audio thread posts (Idle -> Pending) and either
+    // takes the job back (Pending -> Idle) or cancels it (Running -> Cancelled).
+    // The worker runs it (Pending -> Running -> Done) and acknowledges a
+    // cancellation (Cancelled -> Idle); the next job is only posted once Idle.
+    enum JobState { Idle, Pending, Running, Done, Cancelled };
+
+    /**
+     * Everything built for one response: segments, FFTs, buffers and the job
+     * shared with the worker. setImpulseResponse() builds a new one outside
+     * the lock and only swaps the pointer under it.
+     */
+    struct State {
+        State() = default;
+        explicit State(std::shared_ptr<const Response> response);
+
+        // Clears the convolution, dropping a posted job
+        void reset() noexcept;
+
+        // worker is nullptr while no worker is attached
+        template <bool Stereo>
+        void render(const float* input, float* left, float* right, int numSamples, Worker* worker) noexcept;
+
+        // Block boundaries of the mid and tail segments
+        void runMid() noexcept;
+        void runTail(Worker* worker) noexcept;
+
+        // Collects the tail job due now into m_tailOutput, running it here if the worker has not delivered it
+        void finishTailJob() noexcept;
+
+        // Worker thread: runs the posted job, if it is still pending
+        void runWorkerJob(Workspace& workspace) noexcept;
+
+        std::shared_ptr<const Response> m_response;
+        int m_numChannels = 0;
+        bool m_hasMid = false;
+        bool m_hasTail = false;
+
+        // Head: a doubled input history, so the FIR always reads one contiguous
+        // window against the reversed taps
+        alignas(16) float m_headHistory[2 * HEAD_SIZE] = {};
+        int m_headPos = 0;
+
+        // Mid segment, fed every HEAD_SIZE samples
+        Segment m_mid;
+        Workspace m_midWorkspace;
+        std::vector<float> m_midInput;          // Previous block, then the one arriving
+        int m_midPos = 0;
+
+        // Tail segment, fed every TAIL_SIZE samples
+        Segment m_tail;
+        Workspace m_tailWorkspace;              // Jobs run inline on the audio thread
+        std::vector<float> m_tailInput;         // Previous block, then the one arriving
+        std::vector<float> m_tailOutput[MAX_CHANNELS];
+        int m_tailPos = 0;
+        int m_tailJobSlot = 0;                  // History slot of the job due next
+        int m_tailJobFilled = 0;                // ...and its partitions with input
+        bool m_tailJobPosted = false;           // A job is due at the next tail boundary
+        bool m_tailJobInline = false;           // ...and was not handed to the worker
+
+        std::vector<float> m_silence;           // Output of segments the response does not reach
+
+        // Shared with the worker
+        std::atomic<int> m_jobState{Idle};
+        int m_jobSlot = 0;                      // Published by the Pending store
+        int m_jobFilled = 0;
+        std::vector<float> m_jobOutput[MAX_CHANNELS];
+    };
+
+    // Starts or stops handing tail jobs to the worker. Once detached the
+    // worker is done with this convolver, so its state can be replaced.
+    void attachWorker();
+    void detachWorker();
+
+    // Worker thread: runs the posted job of the current state
+    void runWorkerJob(Workspace& workspace) noexcept { m_state->runWorkerJob(workspace); }
+
+    const bool m_useWorker;
+    std::shared_ptr<Worker> m_worker;
+    bool m_workerAttached = false;          // Tail jobs are posted to m_worker
+
+    juce::SpinLock m_lock;
+    std::unique_ptr<State> m_state;         // Never nullptr; swapped under m_lock
+    int m_length = 0;
+};
+
+/**
+ * Background thread for the tail jobs of every attached convolver. It blocks
+ * on a semaphore the audio threads post without taking a lock, so it costs
+ * nothing between jobs, and runs above normal priority.
+ */
+class Convolver::Worker : private juce::Thread {
+public:
+    Worker();
+    ~Worker() override;
+
+private:
+    friend class Convolver;
+
+    // Message thread: detach() waits out a pass in progress
+    void attach(Convolver& convolver);
+    void detach(Convolver& convolver);
+
+    /** Audio thread: wakes the worker for a posted job. */
+    void post() noexcept;
+
+    void run() override;
+
+    juce::CriticalSection m_lock;           // Guards m_convolvers, held for each pass over them
+    std::vector<Convolver*> m_convolvers;
+    Semaphore m_semaphore;
+    Workspace m_workspace;
+};
@@ -0,0 +1,117 @@
+#include "DelayLine.h"
+
+DelayLine::DelayLine()
+{
+    setInterpolation(m_interpolation);
+    prepare(static_cast<int>(MIN_DELAY));
+}
+
+void DelayLine::prepare(int maxDelaySamples)
+{
+    m_maxDelay = std::max(MIN_DELAY, static_cast<float>(maxDelaySamples));
+
+    // Room for the oldest tap two samples past the longest delay
+    int size = 1;
+    while (size < static_cast<int>(m_maxDelay) + 3)
+        size <<= 1;
+
+    m_mask = size - 1;
+    m_buffer.assign(static_cast<size_t>(size + GUARD), 0.0f);
+
+    reset();
+}
+
+void DelayLine::reset()
+{
+    std::fill(m_buffer.begin(), m_buffer.end(), 0.0f);
+    m_writePos = 0;
+    m_allpassState = 0.0f;
+}
+
+void DelayLine::setInterpolation(Interpolation type)
+{
+    m_interpolation = type;
+    m_allpassState = 0.0f;
+
+    const auto& polynomials = getTapPolynomials(type);
+    for (int power = 0; power < 4; ++power)
+        for (int tap = 0; tap < GUARD; ++tap)
+            m_weights[power][tap] = polynomials[tap][power];
+}
+
+const float (&DelayLine::getTapPolynomials(Interpolation type))[4][4]
+{
+    // Per tap (oldest first): coefficients of t^0, t^1, t^2, t^3
+    static constexpr float linear[4][4] = {
+        { 0.0f,  0.0f,  0.0f, 0.0f },
+        { 1.0f, -1.0f,  0.0f, 0.0f },
+        { 0.0f,  1.0f,  0.0f, 0.0f },
+        { 0.0f,  0.0f,  0.0f, 0.0f }
+    };
+
+    // Lagrange through taps at t = -1, 0, 1, 2
+    static constexpr float lagrange[4][4] = {
+        { 0.0f, -1.0f / 3.0f,  0.5f, -1.0f / 6.0f },
+        { 1.0f, -0.5f,        -1.0f,  0.5f },
+        { 0.0f,  1.0f,         0.5f, -0.5f },
+        { 0.0f, -1.0f / 6.0f,  0.0f,  1.0f / 6.0f }
+    };
+
+    // Catmull-Rom
+    static constexpr float hermite[4][4] = {
+        { 0.0f, -0.5f,  1.0f, -0.5f },
+        { 1.0f,  0.0f, -2.5f,  1.5f },
+        { 0.0f,  0.5f,  2.0f, -1.5f },
+        { 0.0f,  0.0f, -0.5f,  0.5f }
+    };
+
+    switch (type)
+    {
+        case Interpolation::Linear:  return linear;
+        case Interpolation::Hermite: return hermite;
+        case Interpolation::Lagrange:
+        case Interpolation::Allpass:
+        default:                     return lagrange;
+    }
+}
+
+// === STEREO ===
+
+StereoDelayLine::StereoDelayLine()
+{
+    setInterpolation(m_interpolation);
+    prepare(static_cast<int>(MIN_DELAY));
+}
+
+void StereoDelayLine::prepare(int maxDelaySamples)
+{
+    m_maxDelay = std::max(MIN_DELAY, static_cast<float>(maxDelaySamples));
+
+    int size = 1;
+    while (size < static_cast<int>(m_maxDelay) + 3)
+        size <<= 1;
+
+    m_mask = size - 1;
+    m_buffer.assign(static_cast<size_t>((size + GUARD) * 2), 0.0f);
+
+    reset();
+}
+
+void StereoDelayLine::reset()
+{
+    std::fill(m_buffer.begin(), m_buffer.end(), 0.0f);
+    m_writePos = 0;
+    m_allpassState = {};
+}
+
+void StereoDelayLine::setInterpolation(Interpolation type)
+{
+    m_interpolation = type;
+    m_allpassState = {};
+
+    // Each register covers two taps of both channels: {t0, t0, t1, t1}, {t2, t2, t3, t3}
+    const auto& polynomials = DelayLine::getTapPolynomials(type);
+    for (int power = 0; power < 4; ++power)
+        for (int lane = 0; lane < 2 * GUARD; ++lane)
+            m_weights[power][lane] = polynomials[lane / 2][power];
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+/**
+ * Fractional delay line on a power-of-two ring buffer
+ *
+ * Positions wrap with a bitmask, and the first GUARD samples are mirrored past
+ * the end of the buffer, so the four taps around any read position are always
+ * contiguous and reading never branches on the wrap. The tap weights of every
+ * polynomial interpolator are one cubic per SIMDRegister lane, so all four are
+ * evaluated at once and applied with one multiply and a horizontal sum:
+ *
+ *   Linear   - cheapest; dulls the highs, most at half-sample positions
+ *   Lagrange - 4-point, 3rd order; flat well into the top octave, for sweeps
+ *   Hermite  - 4-point Catmull-Rom; smoothest under fast modulation
+ *   Allpass  - first-order Thiran; flat magnitude, for static or slow delays
+ *
+ * read() comes before write() for the same sample: a delay of D returns the
+ * input D samples before the one about to be written.
+ */
+class DelayLine {
+public:
+    enum class Interpolation {
+        Linear = 0,
+        Lagrange,
+        Hermite,
+        Allpass
+    };
+
+    static constexpr float MIN_DELAY = 2.0f;   // Samples - leaves room for the tap after the read position
+
+    DelayLine();
+
+    /** Allocates for delays up to maxDelaySamples - never on the audio thread. */
+    void prepare(int maxDelaySamples);
+    void reset();
+
+    void setInterpolation(Interpolation type);
+    Interpolation getInterpolation() const { return m_interpolation; }
+    float getMaxDelay() const { return m_maxDelay; }
+
+    /** Tap weight cubics of a polynomial interpolator, [tap][power of t]. */
+    static const float (&getTapPolynomials(Interpolation type))[4][4];
+
+    void write(float sample) noexcept
+    {
+        m_buffer[static_cast<size_t>(m_writePos)] = sample;
+        if (m_writePos < GUARD)
+            m_buffer[static_cast<size_t>(m_writePos + m_mask + 1)] = sample;
+
+        m_writePos = (m_writePos + 1) & m_mask;
+    }
+
+    /** Reads delaySamples back, clamped to [MIN_DELAY, getMaxDelay()]. */
+    float read(float delaySamples) noexcept
+    {
+        const float delay = std::max(MIN_DELAY, std::min(delaySamples, m_maxDelay));
+        const int whole = static_cast<int>(delay);
+        const float fraction = delay - static_cast<float>(whole);
+
+        if (m_interpolation == Interpolation::Allpass)
+            return readAllpass(whole, fraction);
+
+        // Taps from D+2 down to D-1 samples back, oldest first; the read
+        // position sits between taps 1 and 2
+        alignas(Vec::SIMDRegisterSize) float taps[GUARD];
+        std::memcpy(taps, m_buffer.data() + ((m_writePos - whole - 2) & m_mask), sizeof(taps));
+
+        const Vec t = Vec::expand(1.0f - fraction);
+        const Vec weights = ((Vec::fromRawArray(m_weights[3]) * t + Vec::fromRawArray(m_weights[2])) * t
+                             + Vec::fromRawArray(m_weights[1])) * t + Vec::fromRawArray(m_weights[0]);
+
+        return (Vec::fromRawArray(taps) * weights).sum();
+    }
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int GUARD = 4;
+    static_assert(Vec::SIMDNumElements == GUARD, "One register holds the four taps");
+
+    float readAllpass(int whole, float fraction) noexcept
+    {
+        // Fractions in [0.618, 1.618) keep the coefficient small, so the
+        // allpass settles quickly when the delay moves
+        if (fraction < 0.618f)
+        {
+            fraction += 1.0f;
+            --whole;
+        }
+
+        const float coeff = (1.0f - fraction) / (1.0f + fraction);
+        const float newer = m_buffer[static_cast<size_t>((m_writePos - whole) & m_mask)];
+        const float older = m_buffer[static_cast<size_t>((m_writePos - whole - 1) & m_mask)];
+
+        m_allpassState = older + coeff * (newer - m_allpassState);
+        return m_allpassState;
+    }
+
+    std::vector<float> m_buffer;    // Power-of-two ring plus GUARD mirrored samples
+    int m_mask = 0;
+    int m_writePos = 0;
+    float m_maxDelay = MIN_DELAY;
+
+    Interpolation m_interpolation = Interpolation::Lagrange;
+    float m_allpassState = 0.0f;
+
+    // Tap weights as cubics in the position t between taps 1 and 2:
+    // weight = ((w[3] * t + w[2]) * t + w[1]) * t + w[0], one lane per tap
+    alignas(Vec::SIMDRegisterSize) float m_weights[4][GUARD] = {};
+};
+
+/**
+ * Two-channel DelayLine with interleaved left/right frames
+ *
+ * A frame holds one sample of each channel, so the four taps of both channels
+ * sit in two adjacent SIMDRegisters ({L0, R0, L1, R1}, {L2, R2, L3, R3}) and
+ * one pass of the interpolator filters the pair - stereo costs little more
+ * than mono. The channels may read at different delays (a stereo chorus), in
+ * which case the taps are gathered from two frame positions.
+ */
+class StereoDelayLine {
+public:
+    using Interpolation = DelayLine::Interpolation;
+
+    struct Frame {
+        float left = 0.0f;
+        float right = 0.0f;
+    };
+
+    static constexpr float MIN_DELAY = DelayLine::MIN_DELAY;
+
+    StereoDelayLine();
+
+    /** Allocates for delays up to maxDelaySamples - never on the audio thread. */
+    void prepare(int maxDelaySamples);
+    void reset();
+
+    void setInterpolation(Interpolation type);
+    Interpolation getInterpolation() const { return m_interpolation; }
+    float getMaxDelay() const { return m_maxDelay; }
+
+    void write(Frame frame) noexcept
+    {
+        float* slot = m_buffer.data() + 2 * m_writePos;
+        slot[0] = frame.left;
+        slot[1] = frame.right;
+
+        if (m_writePos < GUARD)
+        {
+            slot[2 * (m_mask + 1)] = frame.left;
+            slot[2 * (m_mask + 1) + 1] = frame.right;
+        }
+
+        m_writePos = (m_writePos + 1) & m_mask;
+    }
+
+    Frame read(float delaySamples) noexcept { return read(delaySamples, delaySamples); }
+
+    /** Reads each channel at its own delay, clamped as in DelayLine::read(). */
+    Frame read(float delayLeft, float delayRight) noexcept
+    {
+        delayLeft = std::max(MIN_DELAY, std::min(delayLeft, m_maxDelay));
+        delayRight = std::max(MIN_DELAY, std::min(delayRight, m_maxDelay));
+
+        const int wholeLeft = static_cast<int>(delayLeft);
+        const int wholeRight = static_cast<int>(delayRight);
+        const float fractionLeft = delayLeft - static_cast<float>(wholeLeft);
+        const float fractionRight = delayRight - static_cast<float>(wholeRight);
+
+        if (m_interpolation == Interpolation::Allpass)
+            return { readAllpass(0, wholeLeft, fractionLeft), readAllpass(1, wholeRight, fractionRight) };
+
+        const float* left = m_buffer.data() + 2 * ((m_writePos - wholeLeft - 2) & m_mask);
+        const float* right = m_buffer.data() + 2 * ((m_writePos - wholeRight - 2) & m_mask) + 1;
+
+        alignas(Vec::SIMDRegisterSize) float taps[2 * GUARD];
+        for (int tap = 0; tap < GUARD; ++tap)
+        {
+            taps[2 * tap] = left[2 * tap];
+            taps[2 * tap + 1] = right[2 * tap];
+        }
+
+        const float positionLeft = 1.0f - fractionLeft;
+        const float positionRight = 1.0f - fractionRight;
+        alignas(Vec::SIMDRegisterSize) const float positions[GUARD] = { positionLeft, positionRight, positionLeft, positionRight };
+        const Vec t = Vec::fromRawArray(positions);
+
+        const Vec early = weightsAt(t, 0);
+        const Vec late = weightsAt(t, GUARD);
+        const Vec sum = Vec::fromRawArray(taps) * early + Vec::fromRawArray(taps + GUARD) * late;
+
+        alignas(Vec::SIMDRegisterSize) float lanes[GUARD];
+        sum.copyToRawArray(lanes);
+        return { lanes[0] + lanes[2], lanes[1] + lanes[3] };
+    }
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int GUARD = 4;     // Frames mirrored past the end
+    static_assert(Vec::SIMDNumElements == GUARD, "One register holds two taps of both channels");
+
+    Vec weightsAt(Vec t, int offset) const noexcept
+    {
+        return ((Vec::fromRawArray(m_weights[3] + offset) * t + Vec::fromRawArray(m_weights[2] + offset)) * t
+                + Vec::fromRawArray(m_weights[1] + offset)) * t + Vec::fromRawArray(m_weights[0] + offset);
+    }
+
+    float readAllpass(int channel, int whole, float fraction) noexcept
+    {
+        if (fraction < 0.618f)
+        {
+            fraction += 1.0f;
+            --whole;
+        }
+
+        const float coeff = (1.0f - fraction) / (1.0f + fraction);
+        const float newer = m_buffer[static_cast<size_t>(2 * ((m_writePos - whole) & m_mask) + channel)];
+        const float older = m_buffer[static_cast<size_t>(2 * ((m_writePos - whole - 1) & m_mask) + channel)];
+
+        float& state = channel == 0 ? m_allpassState.left : m_allpassState.right;
+        state = older + coeff * (newer - state);
+        return state;
+    }
+
+    std::vector<float> m_buffer;    // Interleaved power-of-two ring plus GUARD mirrored frames
+    int m_mask = 0;                 // Frames - 1
+    int m_writePos = 0;
+    float m_maxDelay = MIN_DELAY;
+
+    Interpolation m_interpolation = Interpolation::Lagrange;
+    Frame m_allpassState;
+
+    // As DelayLine, with every tap's weight duplicated for both channels
+    alignas(Vec::SIMDRegisterSize) float m_weights[4][2 * GUARD] = {};
+};
@@ -1,255 +1,320 @@
 #include "Effects.h"
 #include <algorithm>
 
-Effects::Effects() : m_rng(std::random_device{}())
+Effects::Effects()
 {
+    enterType(m_activeType);
 }
 
 void Effects::prepare(double sampleRate, int samplesPerBlock)
 {
     m_sampleRate = static_cast<float>(sampleRate);
 
-    // Allocate delay buffer (max 2 seconds)
-    m_maxDelaySamples = static_cast<int>(m_sampleRate * 2.0f);
-    m_delayBuffer.resize(m_maxDelaySamples, 0.0f);
-    m_delayBufferR.resize(m_maxDelaySamples, 0.0f);
+    // Delay lines (with headroom for the tape delay's wow and flutter)
+    m_delay.prepare(static_cast<int>(m_sampleRate * MAX_DELAY_TIME * 1.01f));
+    m_modDelay.prepare(static_cast<int>(m_sampleRate * MAX_MOD_DELAY_TIME));
 
-    // Allocate reverb comb filters
-    for (int i = 0; i < NUM_COMBS; ++i)
-    {
-        int scaledLength = static_cast<int>(m_combLengths[i] * m_sampleRate / 44100.0f);
-        m_combBuffers[i].resize(scaledLength, 0.0f);
-    }
+    m_reverb.prepare(sampleRate, getReverbDownsampling(sampleRate));
+    m_reverb.setDamping(REVERB_DAMPING);
 
-    // Allocate reverb allpass filters
-    for (int i = 0; i < NUM_ALLPASS; ++i)
-    {
-        int scaledLength = static_cast<int>(m_allpassLengths[i] * m_sampleRate / 44100.0f);
-        m_allpassBuffers[i].resize(scaledLength, 0.0f);
-    }
+    // Scratch buffers for the wet path
+    m_wetBuffer.assign(static_cast<size_t>(samplesPerBlock), 0.0f);
+    m_wetBufferRight.assign(static_cast<size_t>(samplesPerBlock), 0.0f);
+    m_midBuffer.assign(static_cast<size_t>(samplesPerBlock), 0.0f);
+    m_flutterBuffer.assign(static_cast<size_t>(samplesPerBlock), 0.0f);
+
+    m_timeSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+    m_feedbackSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+    m_mixSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+    m_modDepthSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+    m_modRateSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
 
     reset();
 }
 
 void Effects::reset()
 {
-    std::fill(m_delayBuffer.begin(), m_delayBuffer.end(), 0.0f);
-    std::fill(m_delayBufferR.begin(), m_delayBufferR.end(), 0.0f);
-    m_delayWritePos = 0;
-    m_delayWritePosR = 0;
+    // The other line is cleared when its type is selected
+    m_activeType = m_type.load();
+    enterType(m_activeType);
     m_lfoPhase = 0.0f;
     m_wowPhase = 0.0f;
+    m_random.reset();
+    m_crushHeld = 0.0f;
+    m_crushCounter = 0;
 
-    for (int i = 0; i < NUM_COMBS; ++i)
-    {
-        std::fill(m_combBuffers[i].begin(), m_combBuffers[i].end(), 0.0f);
-        m_combWritePos[i] = 0;
-    }
-
-    for (int i = 0; i < NUM_ALLPASS; ++i)
-    {
-        std::fill(m_allpassBuffers[i].begin(), m_allpassBuffers[i].end(), 0.0f);
-        m_allpassWritePos[i] = 0;
-    }
+    m_reverb.reset();
+    m_convolver.reset();
 
     for (int i = 0; i < NUM_PHASER_STAGES; ++i)
         m_phaserStages[i] = 0.0f;
+    m_phaserCoeff.reset(calculatePhaserCoefficient(m_modDepth.load()));
+
+    // Parameter ramps jump to the current values
+    m_timeSmoother.reset(m_time.load());
+    m_feedbackSmoother.reset(m_feedback.load());
+    m_mixSmoother.reset(m_mix.load());
+    m_modDepthSmoother.reset(m_modDepth.load());
+    m_modRateSmoother.reset(m_modRate.load());
 }
 
 float Effects::processSample(float input)
 {
+    float output = input;
+    process(&output, 1);
+    return output;
+}
+
+void Effects::process(float* data, int numSamples)
+{
+    process(data, nullptr, numSamples);
+}
+
+void Effects::process(float* left, float* right, int numSamples)
+{
+    jassert(numSamples <= static_cast<int>(m_wetBuffer.size()));
+
     Type type = m_type.load(std::memory_order_relaxed);
-    float mix = m_mix.load(std::memory_order_relaxed);
+    if (type != m_activeType)
+    {
+        m_activeType = type;
+        enterType(type);
+    }
 
-    float wet = 0.0f;
+    m_timeSmoother.setTarget(m_time.load(std::memory_order_relaxed));
+    m_feedbackSmoother.setTarget(m_feedback.load(std::memory_order_relaxed));
+    m_mixSmoother.setTarget(m_mix.load(std::memory_order_relaxed));
+    m_modDepthSmoother.setTarget(m_modDepth.load(std::memory_order_relaxed));
+    m_modRateSmoother.setTarget(m_modRate.load(std::memory_order_relaxed));
+
+    const float* time = m_timeSmoother.render(numSamples);
+    const float* feedback = m_feedbackSmoother.render(numSamples);
+    const float* mix = m_mixSmoother.render(numSamples);
+    const float* depth = m_modDepthSmoother.render(numSamples);
+    const float* rate = m_modRateSmoother.render(numSamples);
+
+    // Mono effects are fed the mid signal while the dry path keeps its width
+    const float* inputRight = right != nullptr ? right : left;
+    const float* mid = left;
+    if (right != nullptr)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            m_midBuffer[static_cast<size_t>(i)] = 0.5f * (left[i] + right[i]);
+        mid = m_midBuffer.data();
+    }
+
+    float* wet = m_wetBuffer.data();
+    float* wetRight = wet;
 
     switch (type)
     {
-        case Type::TapeDelay:    wet = processTapeDelay(input); break;
-        case Type::DigitalDelay: wet = processDigitalDelay(input); break;
-        case Type::PingPong:     wet = processPingPong(input); break;
-        case Type::Reverb:       wet = processReverb(input); break;
-        case Type::Chorus:       wet = processChorus(input); break;
-        case Type::Flanger:      wet = processFlanger(input); break;
-        case Type::Phaser:       wet = processPhaser(input); break;
-        case Type::Bitcrush:     wet = processBitcrush(input); break;
-        default:                 wet = processDigitalDelay(input); break;
+        case Type::TapeDelay:
+        {
+            // Flutter noise is drawn for the whole block up front
+            const float* flutter = m_flutterBuffer.data();
+            m_random.fillUniform(m_flutterBuffer.data(), numSamples, -FLUTTER_DEPTH, FLUTTER_DEPTH);
+            wetRight = m_wetBufferRight.data();
+            renderWetStereo(left, inputRight, wet, wetRight, numSamples, [&](Frame x, int i) { return processTapeDelay(x, time[i], feedback[i], flutter[i]); });
+            break;
+        }
+        case Type::DigitalDelay:
+        default:
+            wetRight = m_wetBufferRight.data();
+            renderWetStereo(left, inputRight, wet, wetRight, numSamples, [&](Frame x, int i) { return processDigitalDelay(x, time[i], feedback[i]); });
+            break;
+        case Type::PingPong:
+            wetRight = m_wetBufferRight.data();
+            renderWetStereo(mid, mid, wet, wetRight, numSamples, [&](Frame x, int i) { return processPingPong(x, time[i], feedback[i]); });
+            break;
+        case Type::Reverb:
+        {
+            // Decay follows the feedback ramp at block rate
+            if (numSamples > 0)
+                m_reverb.setDecay(REVERB_MIN_DECAY * std::pow(REVERB_MAX_DECAY / REVERB_MIN_DECAY, feedback[numSamples - 1] / 0.95f));
+
+            if (right != nullptr)
+                wetRight = m_wetBufferRight.data();
+
+            m_reverb.process(left, right, wet, right != nullptr ? wetRight : nullptr, numSamples);
+            break;
+        }
+        case Type::Convolution:
+        {
+            if (right != nullptr)
+                wetRight = m_wetBufferRight.data();
+
+            m_convolver.process(mid, wet, right != nullptr ? wetRight : nullptr, numSamples);
+            break;
+        }
+        case Type::Chorus:
+            wetRight = m_wetBufferRight.data();
+            renderWetStereo(left, inputRight, wet, wetRight, numSamples, [&](Frame x, int i) { return processChorus(x, depth[i], rate[i]); });
+            break;
+        case Type::Flanger:
+            wetRight = m_wetBufferRight.data();
+            renderWetStereo(left, inputRight, wet, wetRight, numSamples, [&](Frame x, int i) { return processFlanger(x, depth[i], rate[i], feedback[i]); });
+            break;
+        case Type::Phaser:       renderPhaser(mid, wet, numSamples, depth, rate, feedback); break;
+        case Type::Bitcrush:     renderWet(mid, wet, numSamples, [&](float x, int i) { return processBitcrush(x, depth[i], rate[i]); }); break;
     }
 
-    return input * (1.0f - mix) + wet * mix;
+    // A mono stream takes the downmix of a stereo wet signal
+    if (right == nullptr && wetRight != wet)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            wet[i] = 0.5f * (wet[i] + wetRight[i]);
+    }
+
+    // Dry/wet mix
+    for (int i = 0; i < numSamples; ++i)
+        left[i] = left[i] * (1.0f - mix[i]) + wet[i] * mix[i];
+
+    if (right != nullptr)
+        for (int i = 0; i < numSamples; ++i)
+            right[i] = right[i] * (1.0f - mix[i]) + wetRight[i] * mix[i];
+}
+
+template <typename Processor>
+void Effects::renderWet(const float* input, float* wet, int numSamples, Processor&& processWet)
+{
+    for (int i = 0; i < numSamples; ++i)
+        wet[i] = processWet(input[i], i);
+}
+
+template <typename Processor>
+void Effects::renderWetStereo(const float* inputLeft, const float* inputRight, float* wetLeft, float* wetRight,
+                              int numSamples, Processor&& processWet)
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const Frame output = processWet(Frame { inputLeft[i], inputRight[i] }, i);
+        wetLeft[i] = output.left;
+        wetRight[i] = output.right;
+    }
 }
 
-float Effects::processTapeDelay(float input)
+void Effects::renderPhaser(const float* input, float* wet, int numSamples, const float* depth,
+                           const float* rate, const float* feedback)
 {
-    float time = m_time.load(std::memory_order_relaxed);
-    float feedback = m_feedback.load(std::memory_order_relaxed);
+    const float inverseSampleRate = 1.0f / m_sampleRate;
 
+    // The allpass coefficient is evaluated at the last sample of each control
+    // segment and interpolated across it
+    for (int start = 0; start < numSamples; start += m_controlInterval)
+    {
+        const int end = std::min(start + m_controlInterval, numSamples);
+
+        // Advance the LFO to the end of the segment
+        for (int i = start; i < end; ++i)
+        {
+            m_lfoPhase += rate[i] * inverseSampleRate;
+            if (m_lfoPhase >= 1.0f) m_lfoPhase -= 1.0f;
+        }
+
+        m_phaserCoeff.setTarget(calculatePhaserCoefficient(depth[end - 1]), end - start);
+
+        for (int i = start; i < end; ++i)
+            wet[i] = processPhaser(input[i], m_phaserCoeff.next(), feedback[i]);
+    }
+}
+
+Effects::Frame Effects::processTapeDelay(Frame input, float time, float feedback, float flutter)
+{
     // Add wow and flutter
     m_wowPhase += 0.3f / m_sampleRate;
     if (m_wowPhase >= 1.0f) m_wowPhase -= 1.0f;
 
     float wow = std::sin(m_wowPhase * TWO_PI) * 0.002f;
-    float flutter = m_wowDist(m_rng);
     float timeModulation = 1.0f + wow + flutter;
 
     float delaySamples = (time / 1000.0f) * m_sampleRate * timeModulation;
-    delaySamples = std::max(1.0f, std::min(delaySamples, static_cast<float>(m_maxDelaySamples - 1)));
-
-    float delayed = readDelay(delaySamples);
+    Frame delayed = m_delay.read(delaySamples);
 
     // Soft saturation on feedback (tape character)
-    float feedbackSignal = std::tanh(delayed * 1.5f) * 0.9f;
+    float feedbackLeft = std::tanh(delayed.left * 1.5f) * 0.9f;
+    float feedbackRight = std::tanh(delayed.right * 1.5f) * 0.9f;
 
-    writeDelay(input + feedbackSignal * feedback);
+    m_delay.write({ input.left + feedbackLeft * feedback, input.right + feedbackRight * feedback });
 
     return delayed;
 }
 
-float Effects::processDigitalDelay(float input)
+Effects::Frame Effects::processDigitalDelay(Frame input, float time, float feedback)
 {
-    float time = m_time.load(std::memory_order_relaxed);
-    float feedback = m_feedback.load(std::memory_order_relaxed);
-
     float delaySamples = (time / 1000.0f) * m_sampleRate;
-    delaySamples = std::max(1.0f, std::min(delaySamples, static_cast<float>(m_maxDelaySamples - 1)));
-
-    float delayed = readDelay(delaySamples);
-    writeDelay(input + delayed * feedback);
+    Frame delayed = m_delay.read(delaySamples);
+    m_delay.write({ input.left + delayed.left * feedback, input.right + delayed.right * feedback });
 
     return delayed;
 }
 
-float Effects::processPingPong(float input)
+Effects::Frame Effects::processPingPong(Frame input, float time, float feedback)
 {
-    float time = m_time.load(std::memory_order_relaxed);
-    float feedback = m_feedback.load(std::memory_order_relaxed);
-
     float delaySamples = (time / 1000.0f) * m_sampleRate;
-    delaySamples = std::max(1.0f, std::min(delaySamples, static_cast<float>(m_maxDelaySamples - 1)));
-
-    // Read from both channels
-    int readPos = m_delayWritePos - static_cast<int>(delaySamples);
-    if (readPos < 0) readPos += m_maxDelaySamples;
-
-    int readPosR = m_delayWritePosR - static_cast<int>(delaySamples);
-    if (readPosR < 0) readPosR += m_maxDelaySamples;
-
-    float delayedL = m_delayBuffer[readPos];
-    float delayedR = m_delayBufferR[readPosR];
-
-    // Cross-feed (ping pong)
-    m_delayBuffer[m_delayWritePos] = input + delayedR * feedback;
-    m_delayBufferR[m_delayWritePosR] = delayedL * feedback;
-
-    m_delayWritePos = (m_delayWritePos + 1) % m_maxDelaySamples;
-    m_delayWritePosR = (m_delayWritePosR + 1) % m_maxDelaySamples;
+    Frame delayed = m_delay.read(delaySamples);
 
-    return (delayedL + delayedR) * 0.5f;
-}
-
-float Effects::processReverb(float input)
-{
-    float feedback = m_feedback.load(std::memory_order_relaxed);
-    m_combFeedback = 0.7f + feedback * 0.25f;
-
-    // Parallel comb filters
-    float combSum = 0.0f;
-    for (int i = 0; i < NUM_COMBS; ++i)
-    {
-        int bufferSize = static_cast<int>(m_combBuffers[i].size());
-        if (bufferSize == 0) continue;
-
-        float delayed = m_combBuffers[i][m_combWritePos[i]];
-        float newSample = input + delayed * m_combFeedback;
-        m_combBuffers[i][m_combWritePos[i]] = newSample;
-        m_combWritePos[i] = (m_combWritePos[i] + 1) % bufferSize;
-        combSum += delayed;
-    }
-    combSum *= 0.25f;
+    // Cross-feed: the input enters on the left and each repeat swaps sides
+    m_delay.write({ input.left + delayed.right * feedback, delayed.left * feedback });
 
-    // Series allpass filters
-    float allpassOut = combSum;
-    for (int i = 0; i < NUM_ALLPASS; ++i)
-    {
-        int bufferSize = static_cast<int>(m_allpassBuffers[i].size());
-        if (bufferSize == 0) continue;
-
-        float delayed = m_allpassBuffers[i][m_allpassWritePos[i]];
-        float temp = allpassOut + delayed * 0.5f;
-        m_allpassBuffers[i][m_allpassWritePos[i]] = temp;
-        m_allpassWritePos[i] = (m_allpassWritePos[i] + 1) % bufferSize;
-        allpassOut = delayed - allpassOut * 0.5f;
-    }
-
-    return allpassOut;
+    return delayed;
 }
 
-float Effects::processChorus(float input)
+Effects::Frame Effects::processChorus(Frame input, float depth, float rate)
 {
-    float depth = m_modDepth.load(std::memory_order_relaxed);
-    float rate = m_modRate.load(std::memory_order_relaxed);
-
     // LFO
     m_lfoPhase += rate / m_sampleRate;
     if (m_lfoPhase >= 1.0f) m_lfoPhase -= 1.0f;
 
-    float lfo = std::sin(m_lfoPhase * TWO_PI);
+    float lfoLeft = std::sin(m_lfoPhase * TWO_PI);
+    float lfoRight = std::sin((m_lfoPhase + STEREO_LFO_OFFSET) * TWO_PI);
 
     // Modulated delay time (10-30ms range)
     float baseDelay = 20.0f;
     float modDelay = depth * 10.0f;
-    float delaySamples = ((baseDelay + lfo * modDelay) / 1000.0f) * m_sampleRate;
-    delaySamples = std::max(1.0f, std::min(delaySamples, static_cast<float>(m_maxDelaySamples - 1)));
+    float msToSamples = m_sampleRate / 1000.0f;
 
-    float delayed = readDelay(delaySamples);
-    writeDelay(input);
+    Frame delayed = m_modDelay.read((baseDelay + lfoLeft * modDelay) * msToSamples,
+                                       (baseDelay + lfoRight * modDelay) * msToSamples);
+    m_modDelay.write(input);
 
-    return (input + delayed) * 0.7f;
+    return { (input.left + delayed.left) * 0.7f, (input.right + delayed.right) * 0.7f };
 }
 
-float Effects::processFlanger(float input)
+Effects::Frame Effects::processFlanger(Frame input, float depth, float rate, float feedback)
 {
-    float depth = m_modDepth.load(std::memory_order_relaxed);
-    float rate = m_modRate.load(std::memory_order_relaxed);
-    float feedback = m_feedback.load(std::memory_order_relaxed);
-
     // LFO
     m_lfoPhase += rate / m_sampleRate;
     if (m_lfoPhase >= 1.0f) m_lfoPhase -= 1.0f;
 
-    float lfo = std::sin(m_lfoPhase * TWO_PI);
+    float lfoLeft = std::sin(m_lfoPhase * TWO_PI);
+    float lfoRight = std::sin((m_lfoPhase + STEREO_LFO_OFFSET) * TWO_PI);
 
     // Very short modulated delay (0.1-10ms)
     float baseDelay = 2.0f;
     float modDelay = depth * 5.0f;
-    float delaySamples = ((baseDelay + lfo * modDelay) / 1000.0f) * m_sampleRate;
-    delaySamples = std::max(1.0f, std::min(delaySamples, static_cast<float>(m_maxDelaySamples - 1)));
+    float msToSamples = m_sampleRate / 1000.0f;
 
-    float delayed = readDelay(delaySamples);
-    writeDelay(input + delayed * feedback * 0.7f);
+    Frame delayed = m_modDelay.read((baseDelay + lfoLeft * modDelay) * msToSamples,
+                                        (baseDelay + lfoRight * modDelay) * msToSamples);
+    m_modDelay.write({ input.left + delayed.left * feedback * 0.7f, input.right + delayed.right * feedback * 0.7f });
 
-    return (input + delayed) * 0.7f;
+    return { (input.left + delayed.left) * 0.7f, (input.right + delayed.right) * 0.7f };
 }
 
-float Effects::processPhaser(float input)
+float Effects::calculatePhaserCoefficient(float depth) const
 {
-    float depth = m_modDepth.load(std::memory_order_relaxed);
-    float rate = m_modRate.load(std::memory_order_relaxed);
-    float feedback = m_feedback.load(std::memory_order_relaxed);
-
-    // LFO
-    m_lfoPhase += rate / m_sampleRate;
-    if (m_lfoPhase >= 1.0f) m_lfoPhase -= 1.0f;
-
     float lfo = (std::sin(m_lfoPhase * TWO_PI) + 1.0f) * 0.5f; // 0 to 1
 
     // Calculate allpass coefficient from LFO
     float minFreq = 200.0f;
     float maxFreq = 1600.0f;
     float freq = minFreq + lfo * (maxFreq - minFreq) * depth;
-    float coeff = (1.0f - std::tan(3.14159f * freq / m_sampleRate)) /
-                  (1.0f + std::tan(3.14159f * freq / m_sampleRate));
+    float t = std::tan(3.14159f * freq / m_sampleRate);
+    return (1.0f - t) / (1.0f + t);
+}
 
+float Effects::processPhaser(float input, float coeff, float feedback)
+{
     // Cascade of allpass filters
     float signal = input + m_phaserStages[NUM_PHASER_STAGES - 1] * feedback * 0.5f;
 
@@ -263,10 +328,8 @@ float Effects::processPhaser(float input)
     return (input + signal) * 0.5f;
 }
 
-float Effects::processBitcrush(float input)
+float Effects::processBitcrush(float input, float depth, float rate)
 {
-    float depth = m_modDepth.load(std::memory_order_relaxed);
-
     // Bit depth reduction (16 to 2 bits based on depth)
     int bits = static_cast<int>(16 - depth * 14);
     bits = std::max(2, std::min(16, bits));
@@ -275,43 +338,116 @@ float Effects::processBitcrush(float input)
     float crushed = std::round(input * levels) / levels;
 
     // Sample rate reduction
-    float rate = m_modRate.load(std::memory_order_relaxed);
-    static float held = 0.0f;
-    static int counter = 0;
-
     int holdSamples = static_cast<int>(1.0f + rate * 20.0f);
-    if (++counter >= holdSamples)
+    if (++m_crushCounter >= holdSamples)
     {
-        held = crushed;
-        counter = 0;
+        m_crushHeld = crushed;
+        m_crushCounter = 0;
     }
 
-    return held;
+    return m_crushHeld;
 }
 
 // === UTILITY FUNCTIONS ===
 
-float Effects::readDelay(float delaySamples)
+float Effects::getTailLengthSeconds() const
+{
+    const Type type = m_type.load(std::memory_order_relaxed);
+    const float time = m_time.load(std::memory_order_relaxed) / 1000.0f;
+    const float feedback = m_feedback.load(std::memory_order_relaxed);
+
+    switch (type)
+    {
+        case Type::TapeDelay:
+            // Wow and flutter stretch each repeat; the saturating feedback path
+            // has more than unity gain at low levels
+            return time * 1.004f * (1.0f + getRepeatsToSilence(feedback * TAPE_FEEDBACK_SLOPE));
+        case Type::DigitalDelay:
+        case Type::PingPong:
+            return time * (1.0f + getRepeatsToSilence(feedback));
+        case Type::Reverb:
+        {
+            // RT60 scaled to the threshold, plus the longest line (45ms)
+            const float decay = REVERB_MIN_DECAY * std::pow(REVERB_MAX_DECAY / REVERB_MIN_DECAY, feedback / 0.95f);
+            return decay * -TAIL_THRESHOLD_DB / 60.0f + 0.05f;
+        }
+        case Type::Chorus:
+            return MAX_MOD_DELAY_TIME;
+        case Type::Flanger:
+            return MAX_MOD_DELAY_TIME * (1.0f + getRepeatsToSilence(feedback * 0.7f));
+        case Type::Phaser:
+            return MAX_MOD_DELAY_TIME * (1.0f + getRepeatsToSilence(feedback * 0.5f));
+        case Type::Bitcrush:
+            return 0.0f;
+        case Type::Convolution:
+            return static_cast<float>(m_impulseResponseLength.load(std::memory_order_relaxed)) / m_sampleRate;
+        default:
+            return 0.0f;
+    }
+}
+
+float Effects::getRepeatsToSilence(float loopGain)
 {
-    // Linear interpolation for smooth delay
-    int indexA = m_delayWritePos - static_cast<int>(delaySamples);
-    int indexB = indexA - 1;
+    if (loopGain <= 0.0f)
+        return 0.0f;
 
-    if (indexA < 0) indexA += m_maxDelaySamples;
-    if (indexB < 0) indexB += m_maxDelaySamples;
+    if (loopGain >= 1.0f)
+        return std::numeric_limits<float>::infinity();
 
-    float frac = delaySamples - std::floor(delaySamples);
-    return m_delayBuffer[indexA] * (1.0f - frac) + m_delayBuffer[indexB] * frac;
+    return std::ceil(TAIL_THRESHOLD_DB / (20.0f * std::log10(loopGain)));
 }
 
-void Effects::writeDelay(float sample)
+void Effects::enterType(Type type)
 {
-    m_delayBuffer[m_delayWritePos] = sample;
-    m_delayWritePos = (m_delayWritePos + 1) % m_maxDelaySamples;
+    // Swept delays get 4-point interpolation: linear dulls the highs as the
+    // read position crosses half-sample offsets
+    switch (type)
+    {
+        case Type::TapeDelay:
+            m_delay.setInterpolation(DelayLine::Interpolation::Hermite);
+            m_delay.reset();
+            break;
+        case Type::DigitalDelay:
+        case Type::PingPong:
+            m_delay.setInterpolation(DelayLine::Interpolation::Lagrange);
+            m_delay.reset();
+            break;
+        case Type::Chorus:
+            m_modDelay.setInterpolation(DelayLine::Interpolation::Hermite);
+            m_modDelay.reset();
+            break;
+        case Type::Flanger:
+            m_modDelay.setInterpolation(DelayLine::Interpolation::Lagrange);
+            m_modDelay.reset();
+            break;
+        default:
+            break;
+    }
+}
+
+int Effects::getReverbDownsampling(double sampleRate) const
+{
+    switch (m_reverbRate)
+    {
+        case ReverbRate::Full:    return 1;
+        case ReverbRate::Half:    return 2;
+        case ReverbRate::Quarter: return 4;
+        case ReverbRate::Auto:
+        default:
+            // 88.2/96kHz run at half rate, 176.4/192kHz at quarter rate
+            if (sampleRate >= 4.0 * REVERB_MIN_CORE_RATE) return 4;
+            if (sampleRate >= 2.0 * REVERB_MIN_CORE_RATE) return 2;
+            return 1;
+    }
 }
 
 // === PARAMETER SETTERS ===
 
+void Effects::setControlInterval(int samples)
+{
+    m_controlInterval = ControlRate::clampInterval(samples);
+}
+
 void Effects::setType(Type type)
 {
     m_type.store(type, std::memory_order_relaxed);
@@ -319,7 +455,7 @@ void Effects::setType(Type type)
 
 void Effects::setType(int index)
 {
-    if (index >= 0 && index <= 7)
+    if (index >= 0 && index <= static_cast<int>(Type::Convolution))
         m_type.store(static_cast<Type>(index), std::memory_order_relaxed);
 }
 
@@ -1,15 +1,21 @@
 #pragma once
 
+#include "../core/ControlRate.h"
 #include "../core/DSPModule.h"
+#include "../core/RandomGenerator.h"
+#include "../core/SmoothedParameter.h"
+#include "Convolver.h"
+#include "DelayLine.h"
+#include "FdnReverb.h"
 #include <atomic>
 #include <cmath>
+#include <limits>
 #include <vector>
-#include <random>
 
 /**
  * Multi-effects processor with Delay, Reverb, Chorus, Flanger, Phaser
  */
-class Effects : public DSPModule {
+class Effects final : public DSPModule {
 public:
     enum class Type {
         TapeDelay = 0,
@@ -19,7 +25,16 @@ public:
         Chorus,
         Flanger,
         Phaser,
-        Bitcrush
+        Bitcrush,
+        Convolution
+    };
+
+    /** Rate the reverb network runs at, relative to the host rate. */
+    enum class ReverbRate {
+        Auto = 0,   // Halved until it is no higher than 2 * REVERB_MIN_CORE_RATE
+        Full,
+        Half,
+        Quarter
     };
 
     Effects();
@@ -28,6 +43,17 @@ public:
     void prepare(double sampleRate, int samplesPerBlock) override;
     void reset() override;
     float processSample(float input) override;
+    void process(float* data, int numSamples) override;
+
+    /**
+     * Stereo processing. The delays, chorus, flanger and reverb run true stereo,
+     * each channel through its own half of a StereoDelayLine (or its own FDN
+     * input pattern); ping-pong feeds the mid signal into the left line and
+     * bounces it between the channels. Phaser, bitcrush and convolution are fed
+     * the mid signal and mixed into both channels, keeping the dry width.
+     * right may be nullptr for a mono stream.
+     */
+    void process(float* left, float* right, int numSamples);
 
     void setType(Type type);
     void setType(int index);
@@ -37,57 +63,129 @@ public:
     void setModDepth(float depth);    // For chorus/flanger
     void setModRate(float hz);        // For chorus/flanger
 
+    // Samples between phaser coefficient updates (see ControlRate)
+    void setControlInterval(int samples);
+
+    /** Level below which a decaying tail counts as silent. */
+    static constexpr float TAIL_THRESHOLD_DB = -100.0f;
+
+    /**
+     * Time the wet signal takes to fall below TAIL_THRESHOLD_DB once the input
+     * stops, from the current type, time and feedback. Infinite when the
+     * feedback loop sustains itself (tape delay saturating at high feedback).
+     */
+    float getTailLengthSeconds() const;
+
+    /**
+     * Message thread: the response the Convolution type renders (1 or 2
+     * channels, at the session sample rate). An empty buffer unloads it.
+     */
+    void setImpulseResponse(const juce::AudioBuffer<float>& impulseResponse)
+    {
+        setImpulseResponse(Convolver::createResponse(impulseResponse));
+    }
+
+    /** Message thread: as above, sharing a response already built. */
+    void setImpulseResponse(std::shared_ptr<const Convolver::Response> response)
+    {
+        m_impulseResponseLength.store(response->length, std::memory_order_relaxed);
+        m_convolver.setImpulseResponse(std::move(response));
+    }
+
+    /** Message thread: the thread convolution tails run on (see Convolver::setWorker). */
+    void setConvolutionWorker(std::shared_ptr<Convolver::Worker> worker) { m_convolver.setWorker(std::move(worker)); }
+
+    bool hasImpulseResponse() const { return m_convolver.hasImpulseResponse(); }
+
+    // Reverb network rate - not thread safe, set before prepare()
+    void setReverbRate(ReverbRate rate) { m_reverbRate = rate; }
+
+    // Flutter seed - not thread safe, set before prepare(); reset() restarts the sequence
+    void setRandomSeed(uint64_t seed) { m_random.setSeed(seed); }
+
 private:
-    // Effect processors
-    float processTapeDelay(float input);
-    float processDigitalDelay(float input);
-    float processPingPong(float input);
-    float processReverb(float input);
-    float processChorus(float input);
-    float processFlanger(float input);
-    float processPhaser(float input);
-    float processBitcrush(float input);
-
-    // Utility
-    float readDelay(float delaySamples);
-    void writeDelay(float sample);
-    float allpassFilter(float input, float* buffer, int& index, int length, float feedback);
+    // Renders the wet signal with the effect selection hoisted out of the loop
+    using Frame = StereoDelayLine::Frame;
+
+    template <typename Processor>
+    void renderWet(const float* input, float* wet, int numSamples, Processor&& processWet);
+
+    // As renderWet, for the effects that process both channels at once
+    template <typename Processor>
+    void renderWetStereo(const float* inputLeft, const float* inputRight, float* wetLeft, float* wetRight,
+                         int numSamples, Processor&& processWet);
+
+    // Phaser renders per control segment so its coefficient can be interpolated
+    void renderPhaser(const float* input, float* wet, int numSamples, const float* depth,
+                      const float* rate, const float* feedback);
+    float calculatePhaserCoefficient(float depth) const;
+
+    // Points the shared delay lines at a newly selected type, clearing the one it uses
+    void enterType(Type type);
+
+    // Reverb network rate divider for a host rate (see ReverbRate)
+    int getReverbDownsampling(double sampleRate) const;
+
+    // Passes through a loop of this gain until a signal is below TAIL_THRESHOLD_DB
+    static float getRepeatsToSilence(float loopGain);
+
+    // Effect processors (parameters come from the per-block ramps)
+    Frame processTapeDelay(Frame input, float time, float feedback, float flutter);
+    Frame processDigitalDelay(Frame input, float time, float feedback);
+    Frame processPingPong(Frame input, float time, float feedback);
+    Frame processChorus(Frame input, float depth, float rate);
+    Frame processFlanger(Frame input, float depth, float rate, float feedback);
+    float processPhaser(float input, float coeff, float feedback);
+    float processBitcrush(float input, float depth, float rate);
 
     float m_sampleRate = 44100.0f;
 
-    // Delay buffer
-    std::vector<float> m_delayBuffer;
-    int m_delayWritePos = 0;
-    int m_maxDelaySamples = 0;
-
-    // Ping pong
-    std::vector<float> m_delayBufferR;
-    int m_delayWritePosR = 0;
-    bool m_pingPongSide = false;
-
-    // Reverb (simple Schroeder)
-    static constexpr int NUM_COMBS = 4;
-    static constexpr int NUM_ALLPASS = 2;
-    std::vector<float> m_combBuffers[NUM_COMBS];
-    int m_combWritePos[NUM_COMBS] = {0};
-    int m_combLengths[NUM_COMBS] = {1557, 1617, 1491, 1422};
-    float m_combFeedback = 0.84f;
-
-    std::vector<float> m_allpassBuffers[NUM_ALLPASS];
-    int m_allpassWritePos[NUM_ALLPASS] = {0};
-    int m_allpassLengths[NUM_ALLPASS] = {225, 341};
-
-    // Chorus/Flanger LFO
+    // Wet path scratch buffers (sized in prepare)
+    std::vector<float> m_wetBuffer;
+    std::vector<float> m_wetBufferRight;
+    std::vector<float> m_midBuffer;
+    std::vector<float> m_flutterBuffer;
+
+    // One long line shared by the delay types and one short one by chorus and
+    // flanger, only one type being active. A line is cleared when a type that
+    // uses it is selected, so switching type never replays another's history.
+    static constexpr float MAX_DELAY_TIME = 2.0f;           // Seconds
+    static constexpr float MAX_MOD_DELAY_TIME = 0.05f;      // Seconds, chorus and flanger
+    StereoDelayLine m_delay;
+    StereoDelayLine m_modDelay;
+    Type m_activeType = Type::TapeDelay;    // Audio thread: the type the lines are set up for
+
+    // Reverb - decay follows the feedback amount
+    FdnReverb m_reverb;
+    static constexpr float REVERB_MIN_DECAY = 0.3f;     // Seconds at zero feedback
+    static constexpr float REVERB_MAX_DECAY = 6.0f;     // Seconds at full feedback
+    static constexpr float REVERB_DAMPING = 6000.0f;    // Hz
+    static constexpr double REVERB_MIN_CORE_RATE = 44100.0;
+    ReverbRate m_reverbRate = ReverbRate::Auto;
+
+    // Convolution with a user impulse response
+    Convolver m_convolver;
+    std::atomic<int> m_impulseResponseLength{0};   // Samples, for the tail length
+
+    // Chorus/Flanger LFO - the right channel runs a quarter cycle ahead
+    static constexpr float STEREO_LFO_OFFSET = 0.25f;
     float m_lfoPhase = 0.0f;
     float m_lfoRate = 0.5f;
 
     // Phaser allpass stages
     static constexpr int NUM_PHASER_STAGES = 6;
     float m_phaserStages[NUM_PHASER_STAGES] = {0};
+    InterpolatedCoefficient m_phaserCoeff;
+    int m_controlInterval = ControlRate::DEFAULT_INTERVAL;
+
+    // Bitcrush sample-and-hold
+    float m_crushHeld = 0.0f;
+    int m_crushCounter = 0;
 
     // Wow/flutter for tape delay
-    std::mt19937 m_rng;
-    std::uniform_real_distribution<float> m_wowDist{-0.002f, 0.002f};
+    static constexpr float FLUTTER_DEPTH = 0.002f;
+    static constexpr float TAPE_FEEDBACK_SLOPE = 1.35f;   // Small-signal gain of the feedback saturation
+    RandomGenerator m_random;
     float m_wowPhase = 0.0f;
 
     // Parameters
@@ -98,5 +196,13 @@ private:
     std::atomic<float> m_modDepth{0.5f};
     std::atomic<float> m_modRate{0.5f};
 
+    // Parameter ramps (rendered once per block)
+    SmoothedParameter m_timeSmoother;
+    SmoothedParameter m_feedbackSmoother;
+    SmoothedParameter m_mixSmoother;
+    SmoothedParameter m_modDepthSmoother;
+    SmoothedParameter m_modRateSmoother{SmoothedParameter::Curve::Multiplicative};
+    static constexpr float PARAMETER_RAMP_TIME = 0.05f;   // 50ms - slow enough for delay time changes
+
     static constexpr float TWO_PI = 6.283185307179586f;
 };
@@ -0,0 +1,172 @@
+#include "EffectsRack.h"
+#include <algorithm>
+
+EffectsRack::EffectsRack()
+{
+    m_silenceThreshold = juce::Decibels::decibelsToGain(Effects::TAIL_THRESHOLD_DB, -200.0f);
+}
+
+void EffectsRack::prepare(double sampleRate, int samplesPerBlock)
+{
+    m_sampleRate = sampleRate;
+
+    for (auto& slot : m_slots)
+        slot.effects.prepare(sampleRate, samplesPerBlock);
+
+    reset();
+}
+
+void EffectsRack::reset()
+{
+    for (auto& slot : m_slots)
+    {
+        slot.effects.reset();
+        slot.silentSamples = 0;
+        slot.asleep = false;
+        slot.wasBypassed = false;
+    }
+}
+
+float EffectsRack::processSample(float input)
+{
+    float output = input;
+    process(&output, 1);
+    return output;
+}
+
+void EffectsRack::process(float* data, int numSamples)
+{
+    process(data, nullptr, numSamples);
+}
+
+void EffectsRack::process(float* left, float* right, int numSamples)
+{
+    for (auto& slot : m_slots)
+    {
+        if (slot.bypassed.load(std::memory_order_relaxed))
+        {
+            slot.wasBypassed = true;
+            continue;
+        }
+
+        // Enabled again: start from silence rather than the frozen state
+        if (slot.wasBypassed)
+        {
+            slot.effects.reset();
+            slot.silentSamples = 0;
+            slot.asleep = false;
+            slot.wasBypassed = false;
+        }
+
+        // A slot's input is the previous slot's output, so a sleeping slot
+        // upstream keeps the ones after it asleep as well
+        if (getPeak(left, right, numSamples) > m_silenceThreshold)
+        {
+            slot.silentSamples = 0;
+            slot.asleep = false;
+        }
+        else
+        {
+            // Silent for longer than the tail: everything still in the
+            // effect is below the threshold
+            if (!slot.asleep && slot.silentSamples >= slot.effects.getTailLengthSeconds() * m_sampleRate)
+                slot.asleep = true;
+
+            slot.silentSamples = std::min(slot.silentSamples + numSamples, MAX_SILENT_SAMPLES);
+        }
+
+        if (!slot.asleep)
+            slot.effects.process(left, right, numSamples);
+    }
+}
+
+bool EffectsRack::isSilent() const
+{
+    return std::all_of(m_slots.begin(), m_slots.end(), [](const Slot& slot)
+    {
+        return slot.asleep || slot.bypassed.load(std::memory_order_relaxed);
+    });
+}
+
+double EffectsRack::getTailLengthSeconds() const
+{
+    double tail = 0.0;
+    for (const auto& slot : m_slots)
+        if (!slot.bypassed.load(std::memory_order_relaxed))
+            tail += slot.effects.getTailLengthSeconds();
+
+    return tail;
+}
+
+float EffectsRack::getPeak(const float* left, const float* right, int numSamples)
+{
+    auto range = juce::FloatVectorOperations::findMinAndMax(left, numSamples);
+    if (right != nullptr)
+        range = range.getUnionWith(juce::FloatVectorOperations::findMinAndMax(right, numSamples));
+
+    return std::max(range.getEnd(), -range.getStart());
+}
+
+// === PARAMETER SETTERS ===
+
+void EffectsRack::setBypassed(int index, bool bypassed)
+{
+    if (index >= 0 && index < NUM_SLOTS)
+        m_slots[static_cast<size_t>(index)].bypassed.store(bypassed, std::memory_order_relaxed);
+}
+
+bool EffectsRack::isBypassed(int index) const
+{
+    return index >= 0 && index < NUM_SLOTS
+        && m_slots[static_cast<size_t>(index)].bypassed.load(std::memory_order_relaxed);
+}
+
+void EffectsRack::setImpulseResponse(const juce::AudioBuffer<float>& impulseResponse)
+{
+    auto response = Convolver::createResponse(impulseResponse);
+    const bool needsWorker = response->numTail > 0;
+
+    if (needsWorker && m_convolutionWorker == nullptr)
+    {
+        m_convolutionWorker = std::make_shared<Convolver::Worker>();
+        for (auto& slot : m_slots)
+            slot.effects.setConvolutionWorker(m_convolutionWorker);
+    }
+
+    for (auto& slot : m_slots)
+        slot.effects.setImpulseResponse(response);
+
+    // Responses that stop short of the tail leave the thread stopped
+    if (!needsWorker && m_convolutionWorker != nullptr)
+    {
+        for (auto& slot : m_slots)
+            slot.effects.setConvolutionWorker(nullptr);
+        m_convolutionWorker.reset();
+    }
+}
+
+bool EffectsRack::hasImpulseResponse() const
+{
+    return m_slots.front().effects.hasImpulseResponse();
+}
+
+void EffectsRack::setReverbRate(Effects::ReverbRate rate)
+{
+    for (auto& slot : m_slots)
+        slot.effects.setReverbRate(rate);
+}
+
+void EffectsRack::setRandomSeed(uint64_t seed)
+{
+    // Slot 1 keeps the seed, so a single-slot patch renders as it always has
+    m_slots.front().effects.setRandomSeed(seed);
+
+    for (size_t s = 1; s < m_slots.size(); ++s)
+        m_slots[s].effects.setRandomSeed(RandomGenerator::deriveSeed(seed, s));
+}
+
+void EffectsRack::setControlInterval(int samples)
+{
+    for (auto& slot : m_slots)
+        slot.effects.setControlInterval(samples);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../core/DSPModule.h"
+#include "Effects.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Serial rack of Effects slots (for example chorus -> delay -> reverb)
+ *
+ * Each slot is a complete Effects unit with its own state, run in series on
+ * the stereo signal. Dispatch is per block: a bypassed slot is skipped
+ * outright, and a slot goes to sleep once its input has stayed below
+ * Effects::TAIL_THRESHOLD_DB for longer than its tail, by which time its wet
+ * output has decayed too. A sleeping slot wakes on the first block whose
+ * input crosses the threshold, so an idle rack costs one peak scan of the
+ * block per enabled slot.
+ *
+ * A bypassed slot is reset when it is enabled again, so echoes and reverb
+ * from before the bypass never play back.
+ *
+ * The slots share one impulse response and one convolution worker. The
+ * worker thread exists only while the response is long enough to need it,
+ * sleeps between jobs, and is only handed jobs by enabled, awake slots of
+ * the Convolution type.
+ */
+class EffectsRack final : public DSPModule {
+public:
+    static constexpr int NUM_SLOTS = 4;
+
+    EffectsRack();
+    ~EffectsRack() override = default;
+
+    void prepare(double sampleRate, int samplesPerBlock) override;
+    void reset() override;
+    float processSample(float input) override;
+    void process(float* data, int numSamples) override;
+
+    /** Runs the enabled slots in order; right may be nullptr for a mono stream. */
+    void process(float* left, float* right, int numSamples);
+
+    /** Slot parameters are set on the Effects unit directly. */
+    Effects& getSlot(int index) { return m_slots[static_cast<size_t>(index)].effects; }
+    const Effects& getSlot(int index) const { return m_slots[static_cast<size_t>(index)].effects; }
+
+    void setBypassed(int index, bool bypassed);
+    bool isBypassed(int index) const;
+
+    /** Audio thread only: whether the slot skipped its last block as silent. */
+    bool isAsleep(int index) const { return m_slots[static_cast<size_t>(index)].asleep; }
+
+    /** Audio thread only: true while every enabled slot is asleep. */
+    bool isSilent() const override;
+
+    /**
+     * Any thread: how long the rack keeps sounding after its input stops -
+     * the tails of the enabled slots add up, as each one rings out through
+     * the next. Infinite while any enabled slot sustains itself.
+     */
+    double getTailLengthSeconds() const;
+
+    // Forwarded to every slot (see Effects); the response is built once for all of them
+    void setImpulseResponse(const juce::AudioBuffer<float>& impulseResponse);
+    bool hasImpulseResponse() const;
+    void setReverbRate(Effects::ReverbRate rate);
+    void setRandomSeed(uint64_t seed);
+    void setControlInterval(int samples);
+
+private:
+    struct Slot {
+        Effects effects;
+        std::atomic<bool> bypassed{false};
+        int silentSamples = 0;      // Input below the threshold for this long
+        bool asleep = false;
+        bool wasBypassed = false;   // Audio thread: skipped a block since the last reset
+    };
+
+    // Largest magnitude in the block, across both channels
+    static float getPeak(const float* left, const float* right, int numSamples);
+
+    static constexpr int MAX_SILENT_SAMPLES = 1 << 30;   // Counter saturation
+
+    std::array<Slot, NUM_SLOTS> m_slots;
+    std::shared_ptr<Convolver::Worker> m_convolutionWorker;
+    double m_sampleRate = 44100.0;
+    float m_silenceThreshold = 1.0e-5f;
+};
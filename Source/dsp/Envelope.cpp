@@ -11,10 +11,8 @@ void Envelope::prepare(double sampleRate, int samplesPerBlock)
     (void)samplesPerBlock; // Unused for envelope
     m_sampleRate = static_cast<float>(sampleRate);
 
-    // Recalculate coefficients based on sample rate
-    m_attackCoeff = calculateCoefficient(m_attackTime.load());
-    m_decayCoeff = calculateCoefficient(m_decayTime.load());
-    m_releaseCoeff = calculateCoefficient(m_releaseTime.load());
+    // Recalculate curves based on sample rate
+    updateCurves();
 
     reset();
 }
@@ -22,89 +20,159 @@ void Envelope::prepare(double sampleRate, int samplesPerBlock)
 void Envelope::reset()
 {
     m_level = 0.0f;
+    m_stageRemaining = -1;
     m_stage.store(Stage::Idle, std::memory_order_relaxed);
 }
 
 float Envelope::processSample(float input)
 {
     (void)input; // Envelope doesn't process input signal
-    Stage currentStage = m_stage.load(std::memory_order_relaxed);
+    float output = 0.0f;
+    process(&output, 1);
+    return output;
+}
+
+void Envelope::process(float* data, int numSamples)
+{
+    process(data, numSamples, nullptr, 0);
+}
+
+void Envelope::process(float* data, int numSamples, const Trigger* triggers, int numTriggers)
+{
+    // Envelope doesn't process input signal - the buffer is overwritten
+    if (m_curvesChanged.exchange(false, std::memory_order_relaxed))
+        updateCurves();
+
+    Stage stage = m_stage.load(std::memory_order_relaxed);
+    int position = 0;
 
-    switch (currentStage)
+    for (int t = 0; t < numTriggers; ++t)
     {
-        case Stage::Idle:
-            m_level = 0.0f;
-            break;
+        const int offset = std::max(position, std::min(triggers[t].offset, numSamples));
+        renderStages(data + position, offset - position, stage);
+        position = offset;
+
+        // Retriggers restart from the current level
+        stage = triggers[t].type == TriggerType::NoteOn ? Stage::Attack : Stage::Release;
+        m_stageRemaining = -1;
+    }
+
+    renderStages(data + position, numSamples - position, stage);
 
-        case Stage::Attack:
+    m_stage.store(stage, std::memory_order_relaxed);
+}
+
+void Envelope::renderStages(float* data, int numSamples, Stage& stage)
+{
+    const float sustainLevel = m_sustainLevel.load(std::memory_order_relaxed);
+    float level = m_level;
+    int i = 0;
+
+    // Each stage renders as one segment until it finishes or the block ends
+    while (i < numSamples)
+    {
+        const Curve* curve = nullptr;
+        float target = 0.0f;
+        Stage next = Stage::Idle;
+
+        switch (stage)
         {
-            // Exponential approach to 1.0
-            m_level += m_attackCoeff * (1.0f - m_level);
-
-            // Check if attack is complete
-            if (m_level >= 1.0f - EPSILON)
-            {
-                m_level = 1.0f;
-                m_stage.store(Stage::Decay, std::memory_order_relaxed);
-            }
-            break;
+            case Stage::Idle:
+                level = 0.0f;
+                std::fill(data + i, data + numSamples, 0.0f);
+                i = numSamples;
+                continue;
+
+            case Stage::Sustain:
+                // Hold at sustain level
+                level = sustainLevel;
+                std::fill(data + i, data + numSamples, level);
+                i = numSamples;
+                continue;
+
+            case Stage::Attack:  curve = &m_attackCurve;  target = 1.0f;         next = Stage::Decay;   break;
+            case Stage::Decay:   curve = &m_decayCurve;   target = sustainLevel; next = Stage::Sustain; break;
+            case Stage::Release: curve = &m_releaseCurve; target = 0.0f;         next = Stage::Idle;    break;
         }
 
-        case Stage::Decay:
+        // Solve the segment length once per stage (again if the target moved)
+        if (m_stageRemaining < 0 || target != m_segmentTarget)
         {
-            float sustainLevel = m_sustainLevel.load(std::memory_order_relaxed);
-
-            // Exponential approach to sustain level
-            m_level += m_decayCoeff * (sustainLevel - m_level);
-
-            // Check if decay is complete
-            if (std::abs(m_level - sustainLevel) < EPSILON)
-            {
-                m_level = sustainLevel;
-                m_stage.store(Stage::Sustain, std::memory_order_relaxed);
-            }
-            break;
+            m_stageRemaining = samplesToTarget(std::abs(level - target), *curve);
+            m_segmentTarget = target;
         }
 
-        case Stage::Sustain:
+        const int count = std::min(m_stageRemaining, numSamples - i);
+        const float distance = renderExponential(data + i, count, target, level - target, *curve);
+
+        i += count;
+        m_stageRemaining -= count;
+
+        if (m_stageRemaining == 0)
         {
-            // Hold at sustain level
-            m_level = m_sustainLevel.load(std::memory_order_relaxed);
-            break;
+            // Stage complete - land exactly on the target
+            level = target;
+            data[i - 1] = level;
+            stage = next;
+            m_stageRemaining = -1;
         }
+        else
+        {
+            level = target + distance;
+        }
+    }
+
+    m_level = level;
+}
+
+int Envelope::samplesToTarget(float distance, const Curve& curve)
+{
+    if (distance < EPSILON || curve.ratio <= 0.0f)
+        return 1;
+
+    // First k with distance * ratio^k < EPSILON
+    const float k = std::log(EPSILON / distance) * curve.inverseLogRatio;
+    return std::max(1, static_cast<int>(k) + 1);
+}
+
+float Envelope::renderExponential(float* data, int numSamples, float target, float distance, const Curve& curve)
+{
+    if (numSamples <= 0)
+        return distance;
+
+    // Four interleaved recurrences, each stepping by ratio^4 - independent lanes vectorise
+    float lanes[4];
+    lanes[0] = distance * curve.ratio;
+    for (int lane = 1; lane < 4; ++lane)
+        lanes[lane] = lanes[lane - 1] * curve.ratio;
 
-        case Stage::Release:
+    int i = 0;
+    for (; i + 4 <= numSamples; i += 4)
+    {
+        for (int lane = 0; lane < 4; ++lane)
         {
-            // Exponential approach to 0
-            m_level += m_releaseCoeff * (0.0f - m_level);
-
-            // Check if release is complete
-            if (m_level < EPSILON)
-            {
-                m_level = 0.0f;
-                m_stage.store(Stage::Idle, std::memory_order_relaxed);
-            }
-            break;
+            data[i + lane] = target + lanes[lane];
+            lanes[lane] *= curve.ratio4;
         }
     }
 
-    return m_level;
+    for (int lane = 0; i < numSamples; ++i, ++lane)
+        data[i] = target + lanes[lane];
+
+    return data[numSamples - 1] - target;
 }
 
 void Envelope::noteOn()
 {
-    // Recalculate coefficients in case parameters changed
-    m_attackCoeff = calculateCoefficient(m_attackTime.load());
-    m_decayCoeff = calculateCoefficient(m_decayTime.load());
-    m_releaseCoeff = calculateCoefficient(m_releaseTime.load());
-
     // Start attack stage (even if already running - retrigger)
+    m_stageRemaining = -1;
     m_stage.store(Stage::Attack, std::memory_order_relaxed);
 }
 
 void Envelope::noteOff()
 {
     // Move to release stage
+    m_stageRemaining = -1;
     m_stage.store(Stage::Release, std::memory_order_relaxed);
 }
 
@@ -112,12 +180,14 @@ void Envelope::setAttack(float timeSeconds)
 {
     float clampedTime = std::max(MIN_TIME, std::min(timeSeconds, MAX_TIME));
     m_attackTime.store(clampedTime, std::memory_order_relaxed);
+    m_curvesChanged.store(true, std::memory_order_relaxed);
 }
 
 void Envelope::setDecay(float timeSeconds)
 {
     float clampedTime = std::max(MIN_TIME, std::min(timeSeconds, MAX_TIME));
     m_decayTime.store(clampedTime, std::memory_order_relaxed);
+    m_curvesChanged.store(true, std::memory_order_relaxed);
 }
 
 void Envelope::setSustain(float level)
@@ -130,17 +200,32 @@ void Envelope::setRelease(float timeSeconds)
 {
     float clampedTime = std::max(MIN_TIME, std::min(timeSeconds, MAX_TIME));
     m_releaseTime.store(clampedTime, std::memory_order_relaxed);
+    m_curvesChanged.store(true, std::memory_order_relaxed);
 }
 
-float Envelope::calculateCoefficient(float timeSeconds) const
+Envelope::Curve Envelope::calculateCurve(float timeSeconds) const
 {
+    Curve curve;
     if (timeSeconds <= 0.0f || m_sampleRate <= 0.0f)
-        return 1.0f;
+        return curve;   // Jump straight to the target
 
-    // Calculate coefficient for exponential curve
-    // Using: coeff = 1 - exp(-5 / (time * sampleRate))
+    // Calculate ratio for exponential curve
+    // Using: ratio = exp(-5 / (time * sampleRate))
     // This gives approximately 99% completion in the specified time
     // (5 time constants = 99.3% completion)
     float samples = timeSeconds * m_sampleRate;
-    return 1.0f - std::exp(-5.0f / samples);
+    curve.ratio = std::exp(-5.0f / samples);
+    curve.ratio4 = curve.ratio * curve.ratio * curve.ratio * curve.ratio;
+    curve.inverseLogRatio = -samples / 5.0f;
+    return curve;
+}
+
+void Envelope::updateCurves()
+{
+    m_attackCurve = calculateCurve(m_attackTime.load(std::memory_order_relaxed));
+    m_decayCurve = calculateCurve(m_decayTime.load(std::memory_order_relaxed));
+    m_releaseCurve = calculateCurve(m_releaseTime.load(std::memory_order_relaxed));
+
+    // Segment lengths are re-solved with the new curves
+    m_stageRemaining = -1;
 }
@@ -10,8 +10,14 @@
  * - Attack, Decay, Sustain, Release (ADSR)
  * - Exponential curves for natural sound
  * - Retrigger support for fast note sequences
+ *
+ * Stages are rendered a segment at a time. The length of each exponential
+ * segment is solved for when the stage starts, so stage changes land mid-block
+ * without per-sample checks, and the curve itself is a four-lane
+ * multiplicative recurrence. Triggers can be passed with sample offsets to
+ * render a whole block in one call.
  */
-class Envelope : public DSPModule {
+class Envelope final : public DSPModule {
 public:
     enum class Stage {
         Idle,
@@ -21,6 +27,17 @@ public:
         Release
     };
 
+    enum class TriggerType {
+        NoteOn,
+        NoteOff
+    };
+
+    /** A note on/off at a sample offset within the block passed to process(). */
+    struct Trigger {
+        int offset = 0;
+        TriggerType type = TriggerType::NoteOn;
+    };
+
     Envelope();
     ~Envelope() override = default;
 
@@ -28,6 +45,10 @@ public:
     void prepare(double sampleRate, int samplesPerBlock) override;
     void reset() override;
     float processSample(float input) override;
+    void process(float* data, int numSamples) override;
+
+    /** Renders a block, applying triggers (sorted by offset) at their sample positions. */
+    void process(float* data, int numSamples, const Trigger* triggers, int numTriggers);
 
     // Envelope control
     void noteOn();
@@ -43,14 +64,35 @@ public:
     Stage getCurrentStage() const { return m_stage.load(std::memory_order_relaxed); }
     float getCurrentLevel() const { return m_level; }
     bool isActive() const { return m_stage.load(std::memory_order_relaxed) != Stage::Idle; }
+    bool isSilent() const override { return !isActive(); }
+
+    /** Release time in seconds, as clamped by setRelease() (any thread). */
+    float getReleaseTime() const { return m_releaseTime.load(std::memory_order_relaxed); }
 
 private:
-    float calculateCoefficient(float timeSeconds) const;
+    // Per-sample ratio of an exponential approach: distance *= ratio each sample
+    struct Curve {
+        float ratio = 0.0f;
+        float ratio4 = 0.0f;            // ratio^4, the step of each recurrence lane
+        float inverseLogRatio = 0.0f;   // For solving segment lengths
+    };
+
+    Curve calculateCurve(float timeSeconds) const;
+    void updateCurves();
+    void renderStages(float* data, int numSamples, Stage& stage);
+
+    // Samples until the distance to the target falls below EPSILON (at least 1)
+    static int samplesToTarget(float distance, const Curve& curve);
+
+    // Writes target + distance * ratio^k for k = 1..numSamples; returns the last distance
+    static float renderExponential(float* data, int numSamples, float target, float distance, const Curve& curve);
 
     // State
     float m_sampleRate = 44100.0f;
     float m_level = 0.0f;
     std::atomic<Stage> m_stage{Stage::Idle};
+    int m_stageRemaining = -1;          // Samples left in the current segment, -1 until solved
+    float m_segmentTarget = 0.0f;       // Target the remaining count was solved for
 
     // Parameters (atomic for thread safety)
     std::atomic<float> m_attackTime{0.001f};   // 1ms default
@@ -58,10 +100,12 @@ private:
     std::atomic<float> m_sustainLevel{0.7f};   // 70% default
     std::atomic<float> m_releaseTime{0.3f};    // 300ms default
 
-    // Coefficients for exponential curves
-    float m_attackCoeff = 0.0f;
-    float m_decayCoeff = 0.0f;
-    float m_releaseCoeff = 0.0f;
+    std::atomic<bool> m_curvesChanged{true};
+
+    // Exponential curves, recomputed on the audio thread after a time change
+    Curve m_attackCurve;
+    Curve m_decayCurve;
+    Curve m_releaseCurve;
 
     // Constants
     static constexpr float MIN_TIME = 0.001f;  // 1ms minimum
@@ -0,0 +1,290 @@
+#include "FdnReverb.h"
+#include <algorithm>
+#include <cmath>
+
+FdnReverb::FdnReverb()
+{
+    // Rows of an 8x8 Hadamard matrix - mutually orthogonal, so the input
+    // excites the lines evenly and the two outputs are uncorrelated
+    static constexpr float inputSigns[NUM_LINES] = {1, -1, -1, 1, 1, -1, -1, 1};
+    static constexpr float inputRightSigns[NUM_LINES] = {1, 1, 1, 1, -1, -1, -1, -1};
+    static constexpr float leftSigns[NUM_LINES] = {1, -1, 1, -1, 1, -1, 1, -1};
+    static constexpr float rightSigns[NUM_LINES] = {1, 1, -1, -1, 1, 1, -1, -1};
+
+    const float scale = 1.0f / std::sqrt(static_cast<float>(NUM_LINES));
+
+    // A stereo input shares the mono input's energy between its two patterns
+    const float stereoScale = scale / std::sqrt(2.0f);
+
+    for (int l = 0; l < NUM_LINES; ++l)
+    {
+        m_inputGains[l] = inputSigns[l] * scale;
+        m_stereoInputLeft[l] = inputSigns[l] * stereoScale;
+        m_stereoInputRight[l] = inputRightSigns[l] * stereoScale;
+        m_outputLeft[l] = leftSigns[l] * scale;
+        m_outputRight[l] = rightSigns[l] * scale;
+        m_outputMono[l] = 0.5f * (m_outputLeft[l] + m_outputRight[l]);
+    }
+
+    prepare(m_sampleRate);
+}
+
+void FdnReverb::prepare(double sampleRate, int downsampling)
+{
+    m_downsampling = downsampling >= 4 ? 4 : (downsampling >= 2 ? 2 : 1);
+    m_numStages = m_downsampling == 4 ? 2 : (m_downsampling == 2 ? 1 : 0);
+    m_sampleRate = sampleRate / m_downsampling;
+
+    for (int stage = 0; stage < m_numStages; ++stage)
+    {
+        for (auto& decimators : m_decimators)
+            decimators[static_cast<size_t>(stage)].prepare();
+        for (auto& interpolators : m_interpolators)
+            interpolators[static_cast<size_t>(stage)].prepare();
+    }
+
+    m_stageBuffer.assign(CHUNK_SIZE, 0.0f);
+    for (int c = 0; c < 2; ++c)
+    {
+        m_coreInput[c].assign(CHUNK_SIZE, 0.0f);
+        m_coreOutput[c].assign(CHUNK_SIZE, 0.0f);
+        m_outputQueue[c].assign(CHUNK_SIZE + MAX_DOWNSAMPLING, 0.0f);
+    }
+
+    int longest = 0;
+    for (int l = 0; l < NUM_LINES; ++l)
+    {
+        m_lengths[l] = std::max(1, static_cast<int>(std::round(BASE_LENGTHS[l] * m_sampleRate / 44100.0)));
+        longest = std::max(longest, m_lengths[l]);
+    }
+
+    // Power-of-two frame count so positions wrap with a mask
+    int frames = 1;
+    while (frames <= longest)
+        frames <<= 1;
+
+    m_mask = frames - 1;
+    m_buffer.assign(static_cast<size_t>(frames * NUM_GROUPS), Vec::expand(0.0f));
+
+    updateGains();
+    updateDamping();
+    reset();
+}
+
+void FdnReverb::reset()
+{
+    std::fill(m_buffer.begin(), m_buffer.end(), Vec::expand(0.0f));
+    std::fill(std::begin(m_lowpass), std::end(m_lowpass), 0.0f);
+    m_writePos = 0;
+
+    for (int stage = 0; stage < m_numStages; ++stage)
+    {
+        for (auto& decimators : m_decimators)
+            decimators[static_cast<size_t>(stage)].reset();
+        for (auto& interpolators : m_interpolators)
+            interpolators[static_cast<size_t>(stage)].reset();
+    }
+
+    // Primed so a whole block can be handed out while the decimators hold
+    // back the samples of an unfinished core sample
+    for (auto& queue : m_outputQueue)
+        std::fill(queue.begin(), queue.end(), 0.0f);
+    m_queued = m_downsampling - 1;
+}
+
+void FdnReverb::setDecay(float seconds)
+{
+    seconds = std::max(MIN_DECAY, std::min(MAX_DECAY, seconds));
+    if (seconds == m_decay)
+        return;
+
+    m_decay = seconds;
+    updateGains();
+}
+
+void FdnReverb::setDamping(float hz)
+{
+    hz = std::max(20.0f, hz);
+    if (hz == m_dampingHz)
+        return;
+
+    m_dampingHz = hz;
+    updateDamping();
+}
+
+void FdnReverb::updateGains()
+{
+    // Each pass through a line loses its share of 60dB over the decay time
+    const double decaySamples = static_cast<double>(m_decay) * m_sampleRate;
+
+    for (int l = 0; l < NUM_LINES; ++l)
+        m_gains[l] = static_cast<float>(std::pow(10.0, -3.0 * m_lengths[l] / decaySamples));
+}
+
+void FdnReverb::updateDamping()
+{
+    // One-pole lowpass; a cutoff at Nyquist or above leaves the lines undamped
+    if (m_dampingHz >= 0.5 * m_sampleRate)
+    {
+        m_dampingCoeff = 1.0f;
+        return;
+    }
+
+    m_dampingCoeff = static_cast<float>(1.0 - std::exp(-2.0 * juce::MathConstants<double>::pi * m_dampingHz / m_sampleRate));
+}
+
+void FdnReverb::process(const float* inputLeft, const float* inputRight, float* left, float* right, int numSamples) noexcept
+{
+    if (m_downsampling > 1)
+        processDownsampled(inputLeft, inputRight, left, right, numSamples);
+    else
+        dispatchLines(inputLeft, inputRight, left, right, numSamples);
+}
+
+void FdnReverb::dispatchLines(const float* inputLeft, const float* inputRight, float* left, float* right, int numSamples) noexcept
+{
+    if (inputRight != nullptr)
+    {
+        if (right != nullptr)
+            renderLines<true, true>(inputLeft, inputRight, left, right, numSamples);
+        else
+            renderLines<true, false>(inputLeft, inputRight, left, nullptr, numSamples);
+    }
+    else
+    {
+        if (right != nullptr)
+            renderLines<false, true>(inputLeft, nullptr, left, right, numSamples);
+        else
+            renderLines<false, false>(inputLeft, nullptr, left, nullptr, numSamples);
+    }
+}
+
+void FdnReverb::processDownsampled(const float* inputLeft, const float* inputRight, float* left, float* right, int numSamples) noexcept
+{
+    const int numInputs = inputRight != nullptr ? 2 : 1;
+    const int numChannels = right != nullptr ? 2 : 1;
+    const float* inputs[2] = { inputLeft, inputRight };
+
+    for (int start = 0; start < numSamples; start += CHUNK_SIZE)
+    {
+        const int numHost = std::min(CHUNK_SIZE, numSamples - start);
+
+        // Down to the core rate, one halving per stage
+        int count = numHost;
+        for (int c = 0; c < numInputs; ++c)
+        {
+            const float* stageInput = inputs[c] + start;
+            count = numHost;
+            for (int stage = 0; stage < m_numStages; ++stage)
+            {
+                float* stageOutput = stage == m_numStages - 1 ? m_coreInput[c].data() : m_stageBuffer.data();
+                count = m_decimators[static_cast<size_t>(c)][static_cast<size_t>(stage)].decimate(stageInput, stageOutput, count);
+                stageInput = stageOutput;
+            }
+        }
+
+        dispatchLines(m_coreInput[0].data(), numInputs == 2 ? m_coreInput[1].data() : nullptr,
+                      m_coreOutput[0].data(), numChannels == 2 ? m_coreOutput[1].data() : nullptr, count);
+
+        // Back up to the host rate, onto the end of the output queue
+        for (int c = 0; c < numChannels; ++c)
+        {
+            const float* interpolatorInput = m_coreOutput[c].data();
+            int interpolatorCount = count;
+            for (int stage = m_numStages - 1; stage >= 0; --stage)
+            {
+                float* stageOutput = stage == 0 ? m_outputQueue[c].data() + m_queued : m_stageBuffer.data();
+                m_interpolators[static_cast<size_t>(c)][static_cast<size_t>(stage)].interpolate(interpolatorInput, stageOutput, interpolatorCount);
+                interpolatorInput = stageOutput;
+                interpolatorCount *= 2;
+            }
+        }
+
+        m_queued += count * m_downsampling;
+        jassert(m_queued >= numHost);
+
+        float* outputs[2] = { left + start, right != nullptr ? right + start : nullptr };
+        for (int c = 0; c < numChannels; ++c)
+        {
+            auto& queue = m_outputQueue[c];
+            std::copy(queue.begin(), queue.begin() + numHost, outputs[c]);
+            std::copy(queue.begin() + numHost, queue.begin() + m_queued, queue.begin());
+        }
+
+        m_queued -= numHost;
+    }
+}
+
+template <bool StereoInput, bool StereoOutput>
+void FdnReverb::renderLines(const float* inputLeft, const float* inputRight, float* left, float* right, int numSamples) noexcept
+{
+    const Vec damping = Vec::expand(m_dampingCoeff);
+    const float householderScale = 2.0f / static_cast<float>(NUM_LINES);
+
+    // Load the per-line state into registers once per block
+    Vec gains[NUM_GROUPS], lowpass[NUM_GROUPS], inputGains[NUM_GROUPS], inputGainsRight[NUM_GROUPS];
+    Vec outputLeft[NUM_GROUPS], outputRight[NUM_GROUPS];
+
+    for (int g = 0; g < NUM_GROUPS; ++g)
+    {
+        gains[g] = Vec::fromRawArray(m_gains + g * LANES);
+        lowpass[g] = Vec::fromRawArray(m_lowpass + g * LANES);
+        inputGains[g] = Vec::fromRawArray((StereoInput ? m_stereoInputLeft : m_inputGains) + g * LANES);
+        inputGainsRight[g] = Vec::fromRawArray(m_stereoInputRight + g * LANES);
+        outputLeft[g] = Vec::fromRawArray((StereoOutput ? m_outputLeft : m_outputMono) + g * LANES);
+        outputRight[g] = Vec::fromRawArray(m_outputRight + g * LANES);
+    }
+
+    const float* frames = reinterpret_cast<const float*>(m_buffer.data());
+    int writePos = m_writePos;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Gather the delayed sample of every line
+        alignas(Vec::SIMDRegisterSize) float delayed[NUM_LINES];
+        for (int l = 0; l < NUM_LINES; ++l)
+            delayed[l] = frames[((writePos - m_lengths[l]) & m_mask) * NUM_LINES + l];
+
+        Vec sumLeft = Vec::expand(0.0f);
+        Vec sumRight = Vec::expand(0.0f);
+        Vec sumFeedback = Vec::expand(0.0f);
+        Vec feedback[NUM_GROUPS];
+
+        for (int g = 0; g < NUM_GROUPS; ++g)
+        {
+            const Vec line = Vec::fromRawArray(delayed + g * LANES);
+
+            sumLeft += line * outputLeft[g];
+            if constexpr (StereoOutput)
+                sumRight += line * outputRight[g];
+
+            // Damping lowpass, then the decay gain
+            lowpass[g] += (line - lowpass[g]) * damping;
+            feedback[g] = lowpass[g] * gains[g];
+            sumFeedback += feedback[g];
+        }
+
+        // Householder mix: reflect about the all-ones vector
+        const Vec reflection = Vec::expand(sumFeedback.sum() * householderScale);
+        const float x = inputLeft[i];
+
+        Vec* frame = m_buffer.data() + static_cast<size_t>(writePos * NUM_GROUPS);
+        for (int g = 0; g < NUM_GROUPS; ++g)
+        {
+            frame[g] = feedback[g] - reflection + inputGains[g] * x;
+            if constexpr (StereoInput)
+                frame[g] += inputGainsRight[g] * inputRight[i];
+        }
+
+        writePos = (writePos + 1) & m_mask;
+
+        left[i] = sumLeft.sum();
+        if constexpr (StereoOutput)
+            right[i] = sumRight.sum();
+    }
+
+    m_writePos = writePos;
+
+    for (int g = 0; g < NUM_GROUPS; ++g)
+        lowpass[g].copyToRawArray(m_lowpass + g * LANES);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "HalfBandResampler.h"
+#include <array>
+#include <vector>
+
+/**
+ * Eight line feedback delay network reverb
+ *
+ * Each line is a delay of 25-45 ms followed by a one-pole damping lowpass and
+ * a gain that sets its decay. The lines feed back into each other through a
+ * Householder matrix (x - 2/N * sum(x)), which is lossless and mixes every
+ * line into every other for the cost of one horizontal sum.
+ *
+ * The lines are stored interleaved in one power-of-two buffer, so a sample of
+ * every line is written as whole SIMDRegisters and reads wrap with a mask.
+ * Per-line state lives in aligned arrays processed SIMDRegister-wide, as in
+ * SuperSaw. Left and right tap the lines with orthogonal sign patterns, so the
+ * two outputs are decorrelated while sharing the same decay. A stereo input is
+ * injected the same way, each channel through its own orthogonal pattern.
+ *
+ * The network can run at 1/2 or 1/4 of the host rate behind half-band
+ * decimation and interpolation stages. Line lengths follow the core rate, so
+ * at high host rates CPU and memory stay those of a 44.1/48kHz network; the
+ * tail loses only the top octave(s), where reverbs carry little energy. The
+ * resampling adds up to downsampling - 1 samples of delay to the wet signal.
+ */
+class FdnReverb {
+public:
+    static constexpr int NUM_LINES = 8;
+    static constexpr float MIN_DECAY = 0.1f;            // Seconds
+    static constexpr float MAX_DECAY = 20.0f;
+    static constexpr int MAX_DOWNSAMPLING = 4;
+
+    FdnReverb();
+
+    /** Allocates for a host rate; the network runs at sampleRate / downsampling (1, 2 or 4). */
+    void prepare(double sampleRate, int downsampling = 1);
+    void reset();
+
+    int getDownsampling() const { return m_downsampling; }
+    double getCoreSampleRate() const { return m_sampleRate; }
+    int getLineLength(int line) const { return m_lengths[line]; }  // Core-rate samples
+
+    void setDecay(float seconds);   // RT60 below the damping cutoff, 0.1 - 20s
+    void setDamping(float hz);      // Cutoff of the per-line lowpass
+
+    /**
+     * Renders numSamples of the reverb of a stereo input.
+     * inputRight may be nullptr for a mono input; right may be nullptr to
+     * render a mono (L+R)/2 downmix into left.
+     */
+    void process(const float* inputLeft, const float* inputRight, float* left, float* right, int numSamples) noexcept;
+
+    void process(const float* input, float* left, float* right, int numSamples) noexcept
+    {
+        process(input, nullptr, left, right, numSamples);
+    }
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int LANES = static_cast<int>(Vec::SIMDNumElements);
+    static constexpr int NUM_GROUPS = NUM_LINES / LANES;
+    static_assert(NUM_LINES % LANES == 0, "Lines are processed in whole registers");
+
+    template <bool StereoInput, bool StereoOutput>
+    void renderLines(const float* inputLeft, const float* inputRight, float* left, float* right, int numSamples) noexcept;
+
+    // Picks the renderLines variant for the channels present
+    void dispatchLines(const float* inputLeft, const float* inputRight, float* left, float* right, int numSamples) noexcept;
+
+    // Decimates the input, runs the network at the core rate and interpolates back
+    void processDownsampled(const float* inputLeft, const float* inputRight, float* left, float* right, int numSamples) noexcept;
+
+    void updateGains();
+    void updateDamping();
+
+    // Line lengths at 44.1kHz - mutually prime so the echoes do not line up
+    static constexpr int BASE_LENGTHS[NUM_LINES] = {1123, 1277, 1381, 1499, 1607, 1733, 1861, 1999};
+
+    double m_sampleRate = 44100.0;   // Core rate the lines run at
+
+    // Multirate stages: one 2x stage per halving, for the input and each output
+    static constexpr int MAX_STAGES = 2;
+    static constexpr int CHUNK_SIZE = 256;          // Host-rate samples per pass
+    int m_downsampling = 1;
+    int m_numStages = 0;
+    std::array<std::array<HalfBandResampler, MAX_STAGES>, 2> m_decimators;
+    std::array<std::array<HalfBandResampler, MAX_STAGES>, 2> m_interpolators;
+    std::vector<float> m_coreInput[2];
+    std::vector<float> m_coreOutput[2];
+    std::vector<float> m_stageBuffer;
+    std::vector<float> m_outputQueue[2];            // Host-rate output not yet handed out
+    int m_queued = 0;
+
+    // Interleaved line buffer: frame n holds one sample of every line
+    std::vector<Vec> m_buffer;
+    int m_mask = 0;                 // Frames - 1
+    int m_writePos = 0;
+    int m_lengths[NUM_LINES] = {};
+
+    // Per-line state and taps (structure of arrays, whole registers)
+    alignas(Vec::SIMDRegisterSize) float m_gains[NUM_LINES] = {};
+    alignas(Vec::SIMDRegisterSize) float m_lowpass[NUM_LINES] = {};
+    alignas(Vec::SIMDRegisterSize) float m_inputGains[NUM_LINES] = {};
+    alignas(Vec::SIMDRegisterSize) float m_stereoInputLeft[NUM_LINES] = {};
+    alignas(Vec::SIMDRegisterSize) float m_stereoInputRight[NUM_LINES] = {};
+    alignas(Vec::SIMDRegisterSize) float m_outputLeft[NUM_LINES] = {};
+    alignas(Vec::SIMDRegisterSize) float m_outputRight[NUM_LINES] = {};
+    alignas(Vec::SIMDRegisterSize) float m_outputMono[NUM_LINES] = {};
+
+    float m_decay = 1.5f;
+    float m_dampingHz = 6000.0f;
+    float m_dampingCoeff = 1.0f;
+};
@@ -0,0 +1,93 @@
+#include "HalfBandResampler.h"
+#include <juce_dsp/juce_dsp.h>
+#include <algorithm>
+
+void HalfBandResampler::prepare(float transitionWidth, float stopbandDb)
+{
+    auto structure = juce::dsp::FilterDesign<float>::designIIRLowpassHalfBandPolyphaseAllpassMethod(transitionWidth, stopbandDb);
+
+    // Same branch layout as juce::dsp::Oversampling: the delayed path's first
+    // entry is the pure delay, which the polyphase split already provides
+    m_coeffs.clear();
+    for (int i = 0; i < structure.directPath.size(); ++i)
+        m_coeffs.push_back(structure.directPath.getObjectPointer(i)->coefficients[0]);
+
+    m_directStages = static_cast<int>(m_coeffs.size());
+
+    for (int i = 1; i < structure.delayedPath.size(); ++i)
+        m_coeffs.push_back(structure.delayedPath.getObjectPointer(i)->coefficients[0]);
+
+    m_delayedStages = static_cast<int>(m_coeffs.size()) - m_directStages;
+    m_states.assign(m_coeffs.size(), 0.0f);
+
+    reset();
+}
+
+void HalfBandResampler::reset()
+{
+    std::fill(m_states.begin(), m_states.end(), 0.0f);
+    m_pendingInput = 0.0f;
+    m_hasPending = false;
+    m_delayedOutput = 0.0f;
+}
+
+float HalfBandResampler::processBranch(float input, const float* coeffs, float* states, int numStages) noexcept
+{
+    for (int n = 0; n < numStages; ++n)
+    {
+        const float output = coeffs[n] * input + states[n];
+        states[n] = input - coeffs[n] * output;
+        input = output;
+    }
+
+    return input;
+}
+
+int HalfBandResampler::decimate(const float* input, float* output, int numSamples) noexcept
+{
+    const float* directCoeffs = m_coeffs.data();
+    const float* delayedCoeffs = directCoeffs + m_directStages;
+    float* directStates = m_states.data();
+    float* delayedStates = directStates + m_directStages;
+
+    int numOutput = 0;
+    int i = 0;
+
+    // Complete the pair left over from the last call
+    if (m_hasPending && numSamples > 0)
+    {
+        const float direct = processBranch(m_pendingInput, directCoeffs, directStates, m_directStages);
+        output[numOutput++] = 0.5f * (m_delayedOutput + direct);
+        m_delayedOutput = processBranch(input[i++], delayedCoeffs, delayedStates, m_delayedStages);
+        m_hasPending = false;
+    }
+
+    for (; i + 1 < numSamples; i += 2)
+    {
+        const float direct = processBranch(input[i], directCoeffs, directStates, m_directStages);
+        output[numOutput++] = 0.5f * (m_delayedOutput + direct);
+        m_delayedOutput = processBranch(input[i + 1], delayedCoeffs, delayedStates, m_delayedStages);
+    }
+
+    if (i < numSamples)
+    {
+        m_pendingInput = input[i];
+        m_hasPending = true;
+    }
+
+    return numOutput;
+}
+
+void HalfBandResampler::interpolate(const float* input, float* output, int numSamples) noexcept
+{
+    const float* directCoeffs = m_coeffs.data();
+    const float* delayedCoeffs = directCoeffs + m_directStages;
+    float* directStates = m_states.data();
+    float* delayedStates = directStates + m_directStages;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        output[2 * i] = processBranch(input[i], directCoeffs, directStates, m_directStages);
+        output[2 * i + 1] = processBranch(input[i], delayedCoeffs, delayedStates, m_delayedStages);
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * One 2x rate change through a polyphase IIR half-band filter
+ *
+ * The half-band lowpass is split into two cascades of first-order allpasses
+ * (the even and odd polyphase branches, designed with JUCE's allpass method),
+ * so decimation runs each branch once per output sample and interpolation
+ * once per input sample - the filter never runs at the higher rate.
+ *
+ * One instance keeps the state of a single channel in a single direction.
+ * decimate() accepts any number of input samples and carries an odd one over
+ * to the next call.
+ */
+class HalfBandResampler {
+public:
+    /** Designs the filter - never on the audio thread. Widths are normalised to the higher rate. */
+    void prepare(float transitionWidth = 0.1f, float stopbandDb = -70.0f);
+    void reset();
+
+    /** Halves the rate of numSamples input. Returns the number of output samples written. */
+    int decimate(const float* input, float* output, int numSamples) noexcept;
+
+    /** Doubles the rate: writes 2 * numSamples output samples. */
+    void interpolate(const float* input, float* output, int numSamples) noexcept;
+
+private:
+    // Runs one branch of allpasses over a sample
+    static float processBranch(float input, const float* coeffs, float* states, int numStages) noexcept;
+
+    std::vector<float> m_coeffs;    // Direct branch first, then the delayed branch
+    std::vector<float> m_states;
+    int m_directStages = 0;
+    int m_delayedStages = 0;
+
+    float m_pendingInput = 0.0f;    // Even input sample waiting for its odd partner
+    bool m_hasPending = false;
+    float m_delayedOutput = 0.0f;   // Delayed branch output from the previous pair
+};
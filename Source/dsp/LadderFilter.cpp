@@ -8,68 +8,271 @@ LadderFilter::LadderFilter()
 
 void LadderFilter::prepare(double sampleRate, int samplesPerBlock)
 {
-    (void)samplesPerBlock; // Unused
     m_sampleRate = static_cast<float>(sampleRate);
-    m_cutoffSmoothed = m_targetCutoff.load();
-    updateCoefficients();
+    m_preparedSampleRate = m_sampleRate;
+
+    m_cutoffSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+    m_resonanceSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+    m_envelopeAmountSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+
+    buildCoefficientTables();
+
     reset();
 }
 
+void LadderFilter::setMaxRateFactor(int factor)
+{
+    m_numRateTables = 1;
+    while (m_numRateTables < MAX_RATE_TABLES && (1 << m_numRateTables) <= factor)
+        ++m_numRateTables;
+}
+
+void LadderFilter::setSampleRate(double sampleRate)
+{
+    const int table = juce::jlimit(0, m_numRateTables - 1,
+                                   juce::roundToInt(std::log2(sampleRate / m_preparedSampleRate)));
+    jassert(std::abs(m_preparedSampleRate * static_cast<float>(1 << table) - static_cast<float>(sampleRate)) < 1.0f);
+
+    m_sampleRate = m_preparedSampleRate * static_cast<float>(1 << table);
+    m_cutoffTable = m_cutoffTables[static_cast<size_t>(table)].data();
+
+    // The integrators keep their state; the coefficients glide to the new
+    // table over the next control segment
+    m_cutoffSmoother.setSampleRate(m_sampleRate);
+    m_resonanceSmoother.setSampleRate(m_sampleRate);
+    m_envelopeAmountSmoother.setSampleRate(m_sampleRate);
+}
+
 void LadderFilter::reset()
 {
-    m_stage.fill(0.0f);
-    m_stageTanh[0] = m_stageTanh[1] = m_stageTanh[2] = m_stageTanh[3] = 0.0f;
-    m_feedback = 0.0f;
+    m_state.fill(0.0f);
+    m_solution.fill(0.0f);
+
+    // Parameter ramps jump to the current values
+    m_cutoffSmoother.reset(m_targetCutoff.load());
+    m_resonanceSmoother.reset(m_resonance.load());
+    m_envelopeAmountSmoother.reset(m_envelopeAmount.load());
+
+    const Model model = m_model.load();
+    const auto resonance = lookupResonance(m_resonance.load(), model, m_quality.load());
+    m_g.reset(lookupCutoffCoefficient(getCutoffOctave(m_targetCutoff.load()), model));
+    m_k.reset(resonance.k);
+    m_gain.reset(resonance.gain);
+}
+
+bool LadderFilter::isSilent() const
+{
+    // The stage outputs only seed the next Newton solve, but a resonant filter
+    // can hold energy in either, so both must have died away
+    for (size_t i = 0; i < m_state.size(); ++i)
+        if (std::abs(m_state[i]) >= SILENCE_THRESHOLD || std::abs(m_solution[i]) >= SILENCE_THRESHOLD)
+            return false;
+
+    return true;
 }
 
 float LadderFilter::processSample(float input)
 {
-    // Get current parameters
-    float targetCutoff = m_targetCutoff.load(std::memory_order_relaxed);
-    float resonance = m_resonance.load(std::memory_order_relaxed);
-    float envAmount = m_envelopeAmount.load(std::memory_order_relaxed);
-    float envValue = m_envelopeValue.load(std::memory_order_relaxed);
+    float output = input;
+    process(&output, 1);
+    return output;
+}
+
+void LadderFilter::process(float* data, int numSamples)
+{
+    // Ramp parameters towards their latest values
+    m_cutoffSmoother.setTarget(m_targetCutoff.load(std::memory_order_relaxed));
+    m_resonanceSmoother.setTarget(m_resonance.load(std::memory_order_relaxed));
+    m_envelopeAmountSmoother.setTarget(m_envelopeAmount.load(std::memory_order_relaxed));
+
+    const float* cutoff = m_cutoffSmoother.render(numSamples);
+    const float* resonance = m_resonanceSmoother.render(numSamples);
+    const float* envAmount = m_envelopeAmountSmoother.render(numSamples);
 
-    // Apply envelope modulation to cutoff
-    if (envAmount != 0.0f)
+    const float envValue = m_envelopeValue.load(std::memory_order_relaxed);
+    const float* envelope = m_envelopeBuffer;
+    m_envelopeBuffer = nullptr;
+
+    const Model model = m_model.load(std::memory_order_relaxed);
+    const Quality quality = m_quality.load(std::memory_order_relaxed);
+
+    if (model == Model::Diode)
+    {
+        switch (quality)
+        {
+            case Quality::Linear:       renderBlock<Model::Diode, Quality::Linear>(data, numSamples, cutoff, resonance, envAmount, envelope, envValue); break;
+            case Quality::FullNewton:   renderBlock<Model::Diode, Quality::FullNewton>(data, numSamples, cutoff, resonance, envAmount, envelope, envValue); break;
+            case Quality::SingleNewton:
+            default:                    renderBlock<Model::Diode, Quality::SingleNewton>(data, numSamples, cutoff, resonance, envAmount, envelope, envValue); break;
+        }
+    }
+    else
     {
-        // Envelope modulates in exponential fashion (like analog filters)
-        float modulation = envAmount * envValue;
-        // Convert to frequency multiplier (±4 octaves)
-        float multiplier = std::pow(2.0f, modulation * 4.0f);
-        targetCutoff *= multiplier;
-        targetCutoff = std::max(MIN_CUTOFF, std::min(targetCutoff, MAX_CUTOFF));
+        switch (quality)
+        {
+            case Quality::Linear:       renderBlock<Model::Transistor, Quality::Linear>(data, numSamples, cutoff, resonance, envAmount, envelope, envValue); break;
+            case Quality::FullNewton:   renderBlock<Model::Transistor, Quality::FullNewton>(data, numSamples, cutoff, resonance, envAmount, envelope, envValue); break;
+            case Quality::SingleNewton:
+            default:                    renderBlock<Model::Transistor, Quality::SingleNewton>(data, numSamples, cutoff, resonance, envAmount, envelope, envValue); break;
+        }
     }
+}
+
+template <LadderFilter::Model model, LadderFilter::Quality quality>
+void LadderFilter::renderBlock(float* data, int numSamples, const float* cutoff, const float* resonance,
+                               const float* envAmount, const float* envelope, float envValue)
+{
+    // Coefficients are evaluated at the last sample of each control segment
+    // and interpolated across it
+    for (int start = 0; start < numSamples; start += m_controlInterval)
+    {
+        const int end = std::min(start + m_controlInterval, numSamples);
+        const int last = end - 1;
+
+        // Envelope modulates in exponential fashion (like analog filters), so it
+        // is added in octaves (±4) and read from the log-frequency table
+        float octave = getCutoffOctave(cutoff[last]);
+        if (envAmount[last] != 0.0f)
+            octave += envAmount[last] * (envelope != nullptr ? envelope[last] : envValue) * ENVELOPE_OCTAVES;
 
-    // Smooth cutoff changes
-    m_cutoffSmoothed = m_cutoffSmoothed * CUTOFF_SMOOTHING +
-                       targetCutoff * (1.0f - CUTOFF_SMOOTHING);
+        // Update filter coefficients
+        const auto resonanceCoefficients = lookupResonance(resonance[last], model, quality);
+        m_g.setTarget(lookupCutoffCoefficient(octave, model), end - start);
+        m_k.setTarget(resonanceCoefficients.k, end - start);
+        m_gain.setTarget(resonanceCoefficients.gain, end - start);
 
-    // Update filter coefficients
-    updateCoefficients();
+        for (int i = start; i < end; ++i)
+            data[i] = processStages<model, quality>(data[i], m_g.next(), m_k.next(), m_gain.next());
+    }
+}
+
+void LadderFilter::setControlInterval(int samples)
+{
+    m_controlInterval = ControlRate::clampInterval(samples);
+}
 
+template <LadderFilter::Model model, LadderFilter::Quality quality>
+float LadderFilter::processStages(float input, float g, float k, float gain)
+{
     // Apply input saturation
     input = saturate(input);
 
-    // Feedback for resonance (from stage 4 to input)
-    input -= m_k * m_feedback;
+    Vector y;
+
+    if constexpr (quality == Quality::Linear)
+    {
+        // The linear system is solved exactly by a single step from any starting point
+        y = m_state;
+        newtonStep<model, false>(input, g, k, y);
+    }
+    else if constexpr (quality == Quality::SingleNewton)
+    {
+        y = m_solution;
+        newtonStep<model, true>(input, g, k, y);
+    }
+    else
+    {
+        y = m_solution;
+        for (int iteration = 0; iteration < MAX_NEWTON_ITERATIONS; ++iteration)
+            if (newtonStep<model, true>(input, g, k, y) < NEWTON_TOLERANCE)
+                break;
+    }
+
+    // Trapezoidal integrator update: s = 2y - s
+    for (size_t stage = 0; stage < 4; ++stage)
+        m_state[stage] = 2.0f * y[stage] - m_state[stage];
+
+    m_solution = y;
+
+    // Make up part of the passband loss that comes with resonance
+    return y[3] * gain;
+}
+
+template <LadderFilter::Model model, bool nonlinear>
+float LadderFilter::newtonStep(float input, float g, float k, Vector& y) const
+{
+    // Each stage satisfies y = s + g * F(y) (trapezoidal rule, prewarped g).
+    // Newton solves R(y) = y - s - g F(y) = 0 with Jacobian J = I - g dF/dy.
+    const auto shape = [](float x) { return nonlinear ? std::tanh(x) : x; };
+    const auto slope = [](float shaped) { return nonlinear ? 1.0f - shaped * shaped : 1.0f; };
+
+    Vector F;
+    Matrix dF{};
+
+    if constexpr (model == Model::Transistor)
+    {
+        // dy1/dt = wc (tanh(x - k y4) - tanh(y1)),  dyn/dt = wc (tanh(yn-1) - tanh(yn))
+        const float t0 = shape(input - k * y[3]);
+        const float t1 = shape(y[0]);
+        const float t2 = shape(y[1]);
+        const float t3 = shape(y[2]);
+        const float t4 = shape(y[3]);
+
+        F = { t0 - t1, t1 - t2, t2 - t3, t3 - t4 };
+
+        const float d0 = slope(t0), d1 = slope(t1), d2 = slope(t2), d3 = slope(t3), d4 = slope(t4);
+        dF[0][0] = -d1;                     dF[0][3] = -k * d0;
+        dF[1][0] = d1;  dF[1][1] = -d2;
+        dF[2][1] = d2;  dF[2][2] = -d3;
+        dF[3][2] = d3;  dF[3][3] = -d4;
+    }
+    else
+    {
+        // Diode ladder: each capacitor sees the currents through the diode pairs
+        // on either side. The first stage is driven harder than the rest.
+        //   dy1/dt = wc   (tanh(u - y1) - tanh(y1 - y2)),  u = x - k y4
+        //   dyn/dt = wc/2 (tanh(yn-1 - yn) - tanh(yn - yn+1))
+        //   dy4/dt = wc/2  tanh(y3 - y4)
+        const float t0 = shape(input - k * y[3] - y[0]);
+        const float t1 = shape(y[0] - y[1]);
+        const float t2 = shape(y[1] - y[2]);
+        const float t3 = shape(y[2] - y[3]);
+
+        F = { t0 - t1, 0.5f * (t1 - t2), 0.5f * (t2 - t3), 0.5f * t3 };
+
+        const float d0 = slope(t0), d1 = slope(t1), d2 = slope(t2), d3 = slope(t3);
+        dF[0][0] = -d0 - d1;        dF[0][1] = d1;                  dF[0][3] = -k * d0;
+        dF[1][0] = 0.5f * d1;       dF[1][1] = -0.5f * (d1 + d2);   dF[1][2] = 0.5f * d2;
+        dF[2][1] = 0.5f * d2;       dF[2][2] = -0.5f * (d2 + d3);   dF[2][3] = 0.5f * d3;
+        dF[3][2] = 0.5f * d3;       dF[3][3] = -0.5f * d3;
+    }
 
-    // Process through 4 filter stages (ladder topology)
-    for (int stage = 0; stage < 4; ++stage)
+    Matrix J;
+    Vector delta;
+    for (size_t row = 0; row < 4; ++row)
     {
-        // One-pole lowpass filter per stage
-        float stageInput = (stage == 0) ? input : m_stageTanh[stage - 1];
-        m_stage[stage] += m_g * (stageInput - m_stageTanh[stage]);
+        for (size_t column = 0; column < 4; ++column)
+            J[row][column] = (row == column ? 1.0f : 0.0f) - g * dF[row][column];
 
-        // Non-linear saturation (tanh approximation)
-        m_stageTanh[stage] = saturate(m_stage[stage]);
+        delta[row] = -(y[row] - m_state[row] - g * F[row]);
     }
 
-    // Update feedback for next sample
-    m_feedback = m_stageTanh[3];
+    // Gaussian elimination - J's leading minors stay positive for any g > 0
+    // and k below the ladder's stability limit, so no pivoting is needed
+    for (size_t pivot = 0; pivot < 3; ++pivot)
+    {
+        const float inverse = 1.0f / J[pivot][pivot];
+        for (size_t row = pivot + 1; row < 4; ++row)
+        {
+            const float factor = J[row][pivot] * inverse;
+            for (size_t column = pivot + 1; column < 4; ++column)
+                J[row][column] -= factor * J[pivot][column];
+            delta[row] -= factor * delta[pivot];
+        }
+    }
+
+    float largest = 0.0f;
+    for (size_t i = 4; i-- > 0;)
+    {
+        for (size_t column = i + 1; column < 4; ++column)
+            delta[i] -= J[i][column] * delta[column];
+        delta[i] /= J[i][i];
+
+        y[i] += delta[i];
+        largest = std::max(largest, std::abs(delta[i]));
+    }
 
-    // Output from final stage
-    return m_feedback;
+    return largest;
 }
 
 void LadderFilter::setCutoff(float frequencyHz)
@@ -96,23 +299,132 @@ void LadderFilter::setEnvelopeValue(float value)
     m_envelopeValue.store(clampedValue, std::memory_order_relaxed);
 }
 
-void LadderFilter::updateCoefficients()
+void LadderFilter::setModel(Model model)
+{
+    m_model.store(model, std::memory_order_relaxed);
+}
+
+void LadderFilter::setModel(int index)
+{
+    if (index >= 0 && index <= 1)
+        setModel(static_cast<Model>(index));
+}
+
+void LadderFilter::setQuality(Quality quality)
+{
+    m_quality.store(quality, std::memory_order_relaxed);
+}
+
+void LadderFilter::setQuality(int index)
+{
+    if (index >= 0 && index <= 2)
+        setQuality(static_cast<Quality>(index));
+}
+
+float LadderFilter::calculateCutoffCoefficient(float cutoff, float sampleRate)
+{
+    // Prewarped TPT integrator gain g = tan(pi fc / fs), warped at the resonant peak
+    const float normalised = std::min(cutoff / sampleRate, MAX_CUTOFF_RATIO);
+    return std::tan(static_cast<float>(M_PI) * normalised);
+}
+
+float LadderFilter::calculateResonanceCoefficient(float resonance, Model model, Quality quality)
+{
+    // Calculate resonance coefficient (k), relative to the loop gain at which
+    // the ladder self-oscillates (independent of cutoff in the ZDF model)
+    const float k = resonance * MAX_RESONANCE * getSelfOscillationFeedback(model);
+
+    // Without saturation in the loop there is nothing to hold self-oscillation back
+    if (quality == Quality::Linear)
+        return std::min(k, LINEAR_MAX_RESONANCE * getSelfOscillationFeedback(model));
+
+    return k;
+}
+
+float LadderFilter::getSelfOscillationFeedback(Model model)
+{
+    return model == Model::Diode ? DIODE_SELF_OSCILLATION : TRANSISTOR_SELF_OSCILLATION;
+}
+
+void LadderFilter::buildCoefficientTables()
+{
+    // Cutoff: g at CUTOFF_STEPS_PER_OCTAVE points per octave above MIN_CUTOFF,
+    // once per rate setSampleRate() may switch to
+    for (int t = 0; t < m_numRateTables; ++t)
+    {
+        auto& cutoffTable = m_cutoffTables[static_cast<size_t>(t)];
+        const float sampleRate = m_preparedSampleRate * static_cast<float>(1 << t);
+
+        cutoffTable.resize(CUTOFF_TABLE_SIZE);
+        for (int i = 0; i < CUTOFF_TABLE_SIZE; ++i)
+        {
+            const float octave = static_cast<float>(i) / CUTOFF_STEPS_PER_OCTAVE;
+            cutoffTable[static_cast<size_t>(i)] = calculateCutoffCoefficient(MIN_CUTOFF * std::exp2(octave), sampleRate);
+        }
+    }
+
+    m_cutoffTable = m_cutoffTables[0].data();
+
+    // Resonance: k and the passband make-up gain per model, with and without the linear limit
+    for (int model = 0; model < 2; ++model)
+    {
+        const float selfOscillation = getSelfOscillationFeedback(static_cast<Model>(model));
+
+        for (int linear = 0; linear < 2; ++linear)
+        {
+            const Quality quality = linear != 0 ? Quality::Linear : Quality::SingleNewton;
+            auto& table = m_resonanceTables[static_cast<size_t>(model)][static_cast<size_t>(linear)];
+
+            for (int i = 0; i <= RESONANCE_TABLE_SIZE; ++i)
+            {
+                const float resonance = static_cast<float>(i) / RESONANCE_TABLE_SIZE;
+                auto& entry = table[static_cast<size_t>(i)];
+
+                entry.k = calculateResonanceCoefficient(resonance, static_cast<Model>(model), quality);
+                entry.gain = 1.0f + RESONANCE_COMPENSATION * entry.k / selfOscillation;
+            }
+        }
+    }
+
+    m_lastCutoff = -1.0f;
+}
+
+float LadderFilter::lookupCutoffCoefficient(float octave, Model model) const
+{
+    const float position = std::max(0.0f, std::min(octave, CUTOFF_OCTAVES)) * CUTOFF_STEPS_PER_OCTAVE;
+    const int index = static_cast<int>(position);
+    const float fraction = position - static_cast<float>(index);
+
+    const float* table = m_cutoffTable;
+    const float g = table[index] + fraction * (table[index + 1] - table[index]);
+
+    // The diode ladder's stages are tuned up so its peak lands on the cutoff
+    return model == Model::Diode ? g * DIODE_TUNING : g;
+}
+
+LadderFilter::ResonanceCoefficients LadderFilter::lookupResonance(float resonance, Model model, Quality quality) const
 {
-    float resonance = m_resonance.load(std::memory_order_relaxed);
+    const auto& table = m_resonanceTables[static_cast<size_t>(model)][quality == Quality::Linear ? 1 : 0];
 
-    // Calculate cutoff coefficient (g)
-    // Using bilinear transform approximation
-    float wd = 2.0f * M_PI * m_cutoffSmoothed;
-    float T = 1.0f / m_sampleRate;
-    float wa = (2.0f / T) * std::tan(wd * T / 2.0f);
-    m_g = wa * T / 2.0f;
+    const float position = std::max(0.0f, std::min(resonance, 1.0f)) * RESONANCE_TABLE_SIZE;
+    const int index = std::min(static_cast<int>(position), RESONANCE_TABLE_SIZE - 1);
+    const float fraction = position - static_cast<float>(index);
+
+    const auto& a = table[static_cast<size_t>(index)];
+    const auto& b = table[static_cast<size_t>(index + 1)];
+    return { a.k + fraction * (b.k - a.k), a.gain + fraction * (b.gain - a.gain) };
+}
 
-    // Clamp g for stability
-    m_g = std::min(m_g, 0.99f);
+float LadderFilter::getCutoffOctave(float cutoff)
+{
+    // The cutoff ramp is usually settled, so the logarithm is only taken on a change
+    if (cutoff != m_lastCutoff)
+    {
+        m_lastCutoff = cutoff;
+        m_lastCutoffOctave = std::log2(cutoff / MIN_CUTOFF);
+    }
 
-    // Calculate resonance coefficient (k)
-    // Scale resonance to achieve self-oscillation at high values
-    m_k = 4.0f * resonance * (1.0f + 0.5f * resonance);
+    return m_lastCutoffOctave;
 }
 
 float LadderFilter::saturate(float input) const
@@ -1,21 +1,39 @@
 #pragma once
 
+#include "../core/ControlRate.h"
 #include "../core/DSPModule.h"
+#include "../core/SmoothedParameter.h"
 #include <atomic>
 #include <array>
+#include <vector>
 
 /**
  * 303 style 4-pole (24dB/octave) resonant lowpass ladder filter
  *
- * Based on the classic Moog ladder filter design used in the 303.
- * Features:
- * - 4-pole (24dB/octave) lowpass response
- * - Self-oscillating resonance
- * - Non-linear saturation for character
- * - Oversampling for improved frequency response
+ * Zero-delay-feedback (TPT) model of either ladder topology:
+ * - Transistor: the Moog ladder - four buffered one-pole stages
+ * - Diode: the 303's diode ladder - coupled stages, softer and more nasal
+ *
+ * The feedback loop is solved implicitly every sample, so resonance stays
+ * tuned to the cutoff right up to Nyquist. Three quality tiers trade accuracy
+ * of the nonlinear solve against CPU:
+ * - Linear: the linearised ladder, solved exactly (no saturation inside the loop)
+ * - SingleNewton: one Newton step from the previous solution
+ * - FullNewton: Newton-Raphson iterated until the update falls below NEWTON_TOLERANCE
  */
-class LadderFilter : public DSPModule {
+class LadderFilter final : public DSPModule {
 public:
+    enum class Model {
+        Transistor = 0,     // Moog ladder
+        Diode               // 303 diode ladder
+    };
+
+    enum class Quality {
+        Linear = 0,         // Linearised ZDF
+        SingleNewton,       // One Newton iteration
+        FullNewton          // Newton-Raphson to convergence
+    };
+
     LadderFilter();
     ~LadderFilter() override = default;
 
@@ -23,6 +41,10 @@ public:
     void prepare(double sampleRate, int samplesPerBlock) override;
     void reset() override;
     float processSample(float input) override;
+    void process(float* data, int numSamples) override;
+
+    /** True once every integrator state has decayed below SILENCE_THRESHOLD. */
+    bool isSilent() const override;
 
     // Filter parameters
     void setCutoff(float frequencyHz);          // Cutoff frequency in Hz
@@ -30,34 +52,138 @@ public:
     void setEnvelopeAmount(float amount);       // -1.0 to 1.0 envelope modulation depth
     void setEnvelopeValue(float value);         // 0.0 to 1.0 current envelope value
 
+    /**
+     * Supplies per-sample envelope values (0.0 to 1.0) for the next process() call.
+     * The buffer must hold at least numSamples values and is released after that call;
+     * without it the value from setEnvelopeValue() is used for the whole block.
+     */
+    void setEnvelopeBuffer(const float* envelope) { m_envelopeBuffer = envelope; }
+
+    /**
+     * Sets how often (in samples) the cutoff and resonance coefficients are
+     * recomputed; they are interpolated in between. Rounded to a power of two
+     * up to ControlRate::MAX_INTERVAL. 1 evaluates them every sample.
+     */
+    void setControlInterval(int samples);
+    int getControlInterval() const { return m_controlInterval; }
+
+    /**
+     * Also builds cutoff tables for the prepared rate times 2, 4, ... up to
+     * factor (at most MAX_RATE_FACTOR), so setSampleRate() can move between
+     * them on the audio thread. Call before prepare().
+     */
+    void setMaxRateFactor(int factor);
+
+    /**
+     * Audio thread: switches to the prepared rate times a power of two up to
+     * the max rate factor. Swaps in the prebuilt cutoff table and keeps the
+     * filter state, so the change does not click.
+     */
+    void setSampleRate(double sampleRate);
+
+    static constexpr int MAX_RATE_FACTOR = 8;
+
+    // Ladder topology and solver tier
+    void setModel(Model model);
+    void setModel(int index);
+    Model getModel() const { return m_model.load(std::memory_order_relaxed); }
+    void setQuality(Quality quality);
+    void setQuality(int index);
+    Quality getQuality() const { return m_quality.load(std::memory_order_relaxed); }
+
     // Get current cutoff frequency
     float getCutoff() const { return m_targetCutoff.load(std::memory_order_relaxed); }
 
 private:
-    // Calculate filter coefficients
-    void updateCoefficients();
+    using Vector = std::array<float, 4>;
+    using Matrix = std::array<Vector, 4>;
+
+    // Renders the block with the model and tier fixed, so the per-sample solve inlines
+    template <Model model, Quality quality>
+    void renderBlock(float* data, int numSamples, const float* cutoff, const float* resonance,
+                     const float* envAmount, const float* envelope, float envValue);
+
+    // Feedback and passband make-up gain for one resonance setting
+    struct ResonanceCoefficients
+    {
+        float k = 0.0f;
+        float gain = 1.0f;
+    };
+
+    // Calculate filter coefficients (used to fill the tables)
+    static float calculateCutoffCoefficient(float cutoff, float sampleRate);
+    static float calculateResonanceCoefficient(float resonance, Model model, Quality quality);
+    static float getSelfOscillationFeedback(Model model);
+    void buildCoefficientTables();
+
+    // Interpolated table reads - octave is log2(cutoff / MIN_CUTOFF)
+    float lookupCutoffCoefficient(float octave, Model model) const;
+    ResonanceCoefficients lookupResonance(float resonance, Model model, Quality quality) const;
+    float getCutoffOctave(float cutoff);
+
+    template <Model model, Quality quality>
+    float processStages(float input, float g, float k, float gain);
+
+    // One Newton step on the implicit stage equations; returns the largest update
+    template <Model model, bool nonlinear>
+    float newtonStep(float input, float g, float k, Vector& y) const;
+
     float saturate(float input) const;
 
     // State
     float m_sampleRate = 44100.0f;
-    std::array<float, 4> m_stage = {0.0f, 0.0f, 0.0f, 0.0f};  // 4 filter stages
-    float m_stageTanh[4] = {0.0f, 0.0f, 0.0f, 0.0f};          // Tanh outputs
-    float m_feedback = 0.0f;                                   // Feedback for resonance
-    float m_cutoffSmoothed = 1000.0f;                          // Smoothed cutoff
+    float m_preparedSampleRate = 44100.0f;     // Rate of the first cutoff table
+    Vector m_state = {0.0f, 0.0f, 0.0f, 0.0f};      // TPT integrator states
+    Vector m_solution = {0.0f, 0.0f, 0.0f, 0.0f};   // Stage outputs - the next Newton starting point
+
+    // Parameter ramps (rendered once per block)
+    SmoothedParameter m_cutoffSmoother{SmoothedParameter::Curve::Multiplicative};
+    SmoothedParameter m_resonanceSmoother;
+    SmoothedParameter m_envelopeAmountSmoother;
 
     // Parameters (atomic for thread safety)
     std::atomic<float> m_targetCutoff{1000.0f};
     std::atomic<float> m_resonance{0.0f};
     std::atomic<float> m_envelopeAmount{0.0f};
     std::atomic<float> m_envelopeValue{0.0f};
+    std::atomic<Model> m_model{Model::Transistor};
+    std::atomic<Quality> m_quality{Quality::SingleNewton};
+    const float* m_envelopeBuffer = nullptr;                   // Per-sample envelope (optional)
+
+    // Coefficients (updated at control rate)
+    InterpolatedCoefficient m_g;        // Cutoff coefficient
+    InterpolatedCoefficient m_k;        // Resonance coefficient
+    InterpolatedCoefficient m_gain;     // Resonance gain compensation
+    int m_controlInterval = ControlRate::DEFAULT_INTERVAL;
+
+    // Coefficient tables, built per sample rate in prepare()
+    static constexpr int CUTOFF_STEPS_PER_OCTAVE = 128;
+    static constexpr float CUTOFF_OCTAVES = 9.9657843f;        // log2(MAX_CUTOFF / MIN_CUTOFF)
+    static constexpr int CUTOFF_TABLE_SIZE = 10 * CUTOFF_STEPS_PER_OCTAVE + 2;
+    static constexpr int RESONANCE_TABLE_SIZE = 128;            // Intervals over 0..1
+    static constexpr float ENVELOPE_OCTAVES = 4.0f;             // Envelope modulation range (±4 octaves)
+
+    static constexpr int MAX_RATE_TABLES = 4;                   // log2(MAX_RATE_FACTOR) + 1
 
-    // Coefficients
-    float m_g = 0.0f;        // Cutoff coefficient
-    float m_k = 0.0f;        // Resonance coefficient
+    std::array<std::vector<float>, MAX_RATE_TABLES> m_cutoffTables;    // Per power-of-two rate multiple
+    const float* m_cutoffTable = nullptr;                       // Table for the current rate
+    int m_numRateTables = 1;
+    std::array<std::array<std::array<ResonanceCoefficients, RESONANCE_TABLE_SIZE + 1>, 2>, 2> m_resonanceTables{};  // [model][linear]
+    float m_lastCutoff = -1.0f;         // Cached log2 of the last (unmodulated) cutoff
+    float m_lastCutoffOctave = 0.0f;
 
     // Constants
     static constexpr float MIN_CUTOFF = 20.0f;     // 20 Hz
     static constexpr float MAX_CUTOFF = 20000.0f;  // 20 kHz
-    static constexpr float CUTOFF_SMOOTHING = 0.9995f;
+    static constexpr float MAX_CUTOFF_RATIO = 0.45f;             // Warped cutoff limit, relative to the sample rate
+    static constexpr float TRANSISTOR_SELF_OSCILLATION = 4.0f;   // Loop gain at which each ladder self-oscillates
+    static constexpr float DIODE_SELF_OSCILLATION = 22.104938f;
+    static constexpr float DIODE_TUNING = 1.3764944f;            // Diode ladder resonates at 0.7265x its stage cutoff
+    static constexpr float MAX_RESONANCE = 1.05f;                // Full resonance, relative to self-oscillation
+    static constexpr float LINEAR_MAX_RESONANCE = 0.995f;        // Linear tier limit - it would grow without bound past 1
+    static constexpr float RESONANCE_COMPENSATION = 2.0f;        // Passband make-up gain at self-oscillation
+    static constexpr int MAX_NEWTON_ITERATIONS = 8;
+    static constexpr float NEWTON_TOLERANCE = 1.0e-5f;
+    static constexpr float PARAMETER_RAMP_TIME = 0.02f;   // 20ms
     static constexpr float SATURATION_AMOUNT = 1.5f;
 };
@@ -1,21 +1,19 @@
 #include "Oscillator.h"
 #include <algorithm>
 
-Oscillator::Oscillator() : m_rng(std::random_device{}())
+Oscillator::Oscillator()
 {
-    // Initialize supersaw phases with slight offsets
-    for (int i = 0; i < 7; ++i)
-        m_superSawPhases[i] = static_cast<float>(i) / 7.0f;
 }
 
 void Oscillator::prepare(double sampleRate, int samplesPerBlock)
 {
     m_sampleRate = static_cast<float>(sampleRate);
     m_frequencySmoothing = m_targetFrequency.load();
+    m_fineTuneSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
 
     // Calculate slide coefficient based on slide time
-    float slideTime = m_slideTime.load();
-    m_slideCoeff = std::exp(-1.0f / (slideTime * m_sampleRate));
+    m_currentSlideTime = -1.0f;
+    updateSlideCoefficient(m_slideTime.load());
 
     reset();
 }
@@ -23,198 +21,185 @@ void Oscillator::prepare(double sampleRate, int samplesPerBlock)
 void Oscillator::reset()
 {
     m_phase = 0.0f;
-    m_syncPhase = 0.0f;
-    m_modPhase = 0.0f;
     m_phaseIncrement = m_targetFrequency.load() / m_sampleRate;
+    m_tableLevelMinIncrement = 1.0f;   // Force a level search on the next sample
+    m_tableLevelMaxIncrement = 0.0f;
 
-    for (int i = 0; i < 7; ++i)
-        m_superSawPhases[i] = static_cast<float>(i) / 7.0f;
+    updateFineTune(m_fineTuneCents.load());
+    m_fineTuneSmoother.reset(m_fineTuneRatio);
+
+    m_superSaw.reset();
+    m_random.reset();
 }
 
 float Oscillator::processSample(float input)
 {
-    // Get current parameters
+    (void)input; // Generator ignores input
+    float output = 0.0f;
+    process(&output, 1);
+    return output;
+}
+
+void Oscillator::process(float* data, int numSamples)
+{
+    render(data, nullptr, numSamples);
+}
+
+void Oscillator::process(float* left, float* right, int numSamples)
+{
+    render(left, right, numSamples);
+}
+
+void Oscillator::render(float* left, float* right, int numSamples)
+{
+    // Get current parameters (constant for the whole block)
     float targetFreq = m_targetFrequency.load(std::memory_order_relaxed);
     Waveform waveform = m_waveform.load(std::memory_order_relaxed);
     float fineTune = m_fineTuneCents.load(std::memory_order_relaxed);
     float slideTime = m_slideTime.load(std::memory_order_relaxed);
 
-    // Apply fine tuning
-    if (fineTune != 0.0f)
-        targetFreq *= std::pow(2.0f, fineTune / 1200.0f);
+    // Fine tuning is ramped: with a short slide time the slide below would
+    // pass a step in the ratio straight through
+    updateFineTune(fineTune);
+    m_fineTuneSmoother.setTarget(m_fineTuneRatio);
+    const float* fineTuneRatio = m_fineTuneSmoother.render(numSamples);
 
     // Calculate slide coefficient
-    m_slideCoeff = std::exp(-1.0f / (slideTime * m_sampleRate + 0.001f));
+    updateSlideCoefficient(slideTime);
 
-    // Smooth frequency changes (portamento/slide)
-    m_frequencySmoothing = m_frequencySmoothing * m_slideCoeff + targetFreq * (1.0f - m_slideCoeff);
+    // SuperSaw is the only waveform with stereo content
+    if (waveform == Waveform::SuperSaw)
+    {
+        m_superSaw.setVoiceCount(m_superSawVoices.load(std::memory_order_relaxed));
+        m_superSaw.setDetune(m_superSawDetune.load(std::memory_order_relaxed));
+        m_superSaw.setMix(m_superSawMix.load(std::memory_order_relaxed));
+        m_superSaw.setSpread(m_superSawSpread.load(std::memory_order_relaxed));
 
-    // Update phase increment
-    m_phaseIncrement = m_frequencySmoothing / m_sampleRate;
+        renderSuperSaw(left, right, numSamples, targetFreq, fineTuneRatio);
+        return;
+    }
 
-    // Generate waveform based on selection
-    float output = 0.0f;
+    using Shape = WavetableBank::Shape;
 
+    // Generate waveform based on selection
     switch (waveform)
     {
-        case Waveform::Sawtooth:  output = generateSawtooth(); break;
-        case Waveform::Square:    output = generateSquare(); break;
-        case Waveform::Triangle:  output = generateTriangle(); break;
-        case Waveform::Sine:      output = generateSine(); break;
-        case Waveform::Pulse25:   output = generatePulse(0.25f); break;
-        case Waveform::Pulse12:   output = generatePulse(0.125f); break;
-        case Waveform::SuperSaw:  output = generateSuperSaw(); break;
-        case Waveform::Noise:     output = generateNoise(); break;
-        case Waveform::SawSquare: output = generateSawSquare(); break;
-        case Waveform::TriSaw:    output = generateTriSaw(); break;
-        case Waveform::SyncSaw:   output = generateSyncSaw(); break;
-        case Waveform::FM:        output = generateFM(); break;
-        default:                  output = generateSawtooth(); break;
+        case Waveform::Sawtooth:  renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::Sawtooth); }); break;
+        case Waveform::Square:    renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::Square); }); break;
+        case Waveform::Triangle:  renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::Triangle); }); break;
+        case Waveform::Sine:      renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::Sine); }); break;
+        case Waveform::Pulse25:   renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::Pulse25); }); break;
+        case Waveform::Pulse12:   renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::Pulse12); }); break;
+        case Waveform::Noise:     renderNoise(left, numSamples, targetFreq, fineTuneRatio); break;
+        case Waveform::SawSquare: renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::SawSquare); }); break;
+        case Waveform::TriSaw:    renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::TriSaw); }); break;
+        case Waveform::SyncSaw:   renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::SyncSaw); }); break;
+        case Waveform::FM:        renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::FM); }); break;
+        case Waveform::SuperSaw:
+        default:                  renderBlock(left, numSamples, targetFreq, fineTuneRatio, [this] { return generateWavetable(Shape::Sawtooth); }); break;
     }
 
-    // Update main phase
-    m_phase += m_phaseIncrement;
-    if (m_phase >= 1.0f)
-        m_phase -= 1.0f;
-
-    // Soft clip output
-    return std::max(-1.0f, std::min(1.0f, output));
-}
-
-// === WAVEFORM GENERATORS ===
-
-float Oscillator::generateSawtooth()
-{
-    float output = 2.0f * m_phase - 1.0f;
-    output -= polyBLEP(m_phase, m_phaseIncrement);
-    return output;
-}
-
-float Oscillator::generateSquare()
-{
-    float output = m_phase < 0.5f ? 1.0f : -1.0f;
-    output += polyBLEP(m_phase, m_phaseIncrement);
-
-    float phase2 = m_phase + 0.5f;
-    if (phase2 >= 1.0f) phase2 -= 1.0f;
-    output -= polyBLEP(phase2, m_phaseIncrement);
-
-    return output;
+    if (right != nullptr)
+        std::copy(left, left + numSamples, right);
 }
 
-float Oscillator::generateTriangle()
+template <typename Generator>
+void Oscillator::renderBlock(float* data, int numSamples, float targetFreq, const float* fineTune, Generator&& generate)
 {
-    // Triangle from integrated square
-    float output;
-    if (m_phase < 0.5f)
-        output = 4.0f * m_phase - 1.0f;
-    else
-        output = 3.0f - 4.0f * m_phase;
-    return output;
-}
-
-float Oscillator::generateSine()
-{
-    return std::sin(m_phase * TWO_PI);
-}
+    const float slideCoeff = m_slideCoeff;
+    const float inverseSampleRate = 1.0f / m_sampleRate;
 
-float Oscillator::generatePulse(float width)
-{
-    float output = m_phase < width ? 1.0f : -1.0f;
-    output += polyBLEP(m_phase, m_phaseIncrement);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        advanceSlide(targetFreq * fineTune[i], slideCoeff, inverseSampleRate);
+        updateTableLevel(m_phaseIncrement);
 
-    float phase2 = m_phase + (1.0f - width);
-    if (phase2 >= 1.0f) phase2 -= 1.0f;
-    output -= polyBLEP(phase2, m_phaseIncrement);
+        const float output = generate();
+        advancePhase();
 
-    return output;
+        // Soft clip output
+        data[i] = std::max(-1.0f, std::min(1.0f, output));
+    }
 }
 
-float Oscillator::generateSuperSaw()
+void Oscillator::renderSuperSaw(float* left, float* right, int numSamples, float targetFreq, const float* fineTune)
 {
-    float output = 0.0f;
+    const float slideCoeff = m_slideCoeff;
+    const float inverseSampleRate = 1.0f / m_sampleRate;
 
-    // 7 detuned sawtooth oscillators
-    for (int i = 0; i < 7; ++i)
+    for (int offset = 0; offset < numSamples; offset += SUPERSAW_CHUNK_SIZE)
     {
-        float detunedInc = m_phaseIncrement * (1.0f + m_superSawDetune[i]);
-        m_superSawPhases[i] += detunedInc;
-        if (m_superSawPhases[i] >= 1.0f)
-            m_superSawPhases[i] -= 1.0f;
+        const int chunkSize = std::min(SUPERSAW_CHUNK_SIZE, numSamples - offset);
 
-        float saw = 2.0f * m_superSawPhases[i] - 1.0f;
-        saw -= polyBLEP(m_superSawPhases[i], detunedInc);
+        // Run the slide first so the voice kernel sees one increment per sample
+        for (int i = 0; i < chunkSize; ++i)
+        {
+            m_incrementBuffer[static_cast<size_t>(i)] = advanceSlide(targetFreq * fineTune[offset + i], slideCoeff, inverseSampleRate);
+            advancePhase();
+        }
 
-        // Center oscillator louder
-        float gain = (i == 3) ? 0.3f : 0.15f;
-        output += saw * gain;
+        m_superSaw.render(m_incrementBuffer.data(), left + offset,
+                          right != nullptr ? right + offset : nullptr, chunkSize);
     }
 
-    return output;
-}
+    // Soft clip output
+    for (int i = 0; i < numSamples; ++i)
+        left[i] = std::max(-1.0f, std::min(1.0f, left[i]));
 
-float Oscillator::generateNoise()
-{
-    return m_noiseDist(m_rng);
+    if (right != nullptr)
+        for (int i = 0; i < numSamples; ++i)
+            right[i] = std::max(-1.0f, std::min(1.0f, right[i]));
 }
 
-float Oscillator::generateSawSquare()
+void Oscillator::renderNoise(float* data, int numSamples, float targetFreq, const float* fineTune)
 {
-    float saw = generateSawtooth();
+    const float slideCoeff = m_slideCoeff;
+    const float inverseSampleRate = 1.0f / m_sampleRate;
 
-    // Generate square without updating phase again
-    float sq = m_phase < 0.5f ? 1.0f : -1.0f;
-    sq += polyBLEP(m_phase, m_phaseIncrement);
-    float phase2 = m_phase + 0.5f;
-    if (phase2 >= 1.0f) phase2 -= 1.0f;
-    sq -= polyBLEP(phase2, m_phaseIncrement);
+    // Keep the slide and phase running so switching back to a pitched waveform is seamless
+    for (int i = 0; i < numSamples; ++i)
+    {
+        advanceSlide(targetFreq * fineTune[i], slideCoeff, inverseSampleRate);
+        advancePhase();
+    }
 
-    return (saw + sq) * 0.5f;
+    m_random.fillUniform(data, numSamples, -1.0f, 1.0f);
 }
 
-float Oscillator::generateTriSaw()
+void Oscillator::updateSlideCoefficient(float slideTime)
 {
-    float saw = 2.0f * m_phase - 1.0f;
-    saw -= polyBLEP(m_phase, m_phaseIncrement);
-
-    float tri;
-    if (m_phase < 0.5f)
-        tri = 4.0f * m_phase - 1.0f;
-    else
-        tri = 3.0f - 4.0f * m_phase;
+    if (slideTime == m_currentSlideTime)
+        return;
 
-    return (saw + tri) * 0.5f;
+    m_currentSlideTime = slideTime;
+    m_slideCoeff = std::exp(-1.0f / (slideTime * m_sampleRate + 0.001f));
 }
 
-float Oscillator::generateSyncSaw()
+void Oscillator::updateFineTune(float cents)
 {
-    // Hard sync: slave oscillator resets when master completes cycle
-    m_syncPhase += m_phaseIncrement * m_syncRatio;
+    if (cents == m_currentFineTuneCents)
+        return;
 
-    // Reset sync oscillator when master resets
-    if (m_phase + m_phaseIncrement >= 1.0f)
-        m_syncPhase = 0.0f;
+    m_currentFineTuneCents = cents;
+    m_fineTuneRatio = std::pow(2.0f, cents / 1200.0f);
+}
 
-    if (m_syncPhase >= 1.0f)
-        m_syncPhase -= 1.0f;
+// === WAVEFORM GENERATORS ===
 
-    float output = 2.0f * m_syncPhase - 1.0f;
-    output -= polyBLEP(m_syncPhase, m_phaseIncrement * m_syncRatio);
+void Oscillator::updateTableLevel(float phaseIncrement)
+{
+    // Only search for a new mip level when the increment leaves the current one
+    if (phaseIncrement > m_tableLevelMinIncrement && phaseIncrement <= m_tableLevelMaxIncrement)
+        return;
 
-    return output;
+    m_tableLevel = WavetableBank::getLevelForIncrement(phaseIncrement);
+    m_tableLevelMinIncrement = WavetableBank::getMinIncrement(m_tableLevel);
+    m_tableLevelMaxIncrement = WavetableBank::getMaxIncrement(m_tableLevel);
 }
 
-float Oscillator::generateFM()
+float Oscillator::generateWavetable(WavetableBank::Shape shape) const
 {
-    // FM synthesis: carrier modulated by modulator
-    m_modPhase += m_phaseIncrement * m_fmRatio;
-    if (m_modPhase >= 1.0f)
-        m_modPhase -= 1.0f;
-
-    float modulator = std::sin(m_modPhase * TWO_PI);
-    float carrier = std::sin((m_phase + modulator * m_fmIndex * 0.1f) * TWO_PI);
-
-    return carrier;
+    return WavetableBank::read(m_wavetables->getTable(shape, m_tableLevel), m_phase);
 }
 
 // === PARAMETER SETTERS ===
@@ -243,26 +228,28 @@ void Oscillator::setFineTune(float cents)
                           std::memory_order_relaxed);
 }
 
-void Oscillator::setSlideTime(float seconds)
+void Oscillator::setSuperSawVoices(int voices)
 {
-    m_slideTime.store(std::max(0.001f, std::min(0.5f, seconds)),
-                      std::memory_order_relaxed);
+    m_superSawVoices.store(std::max(1, std::min(SuperSaw::MAX_VOICES, voices)), std::memory_order_relaxed);
 }
 
-float Oscillator::polyBLEP(float t, float dt) const
+void Oscillator::setSuperSawDetune(float amount)
 {
-    if (dt <= 0.0f) return 0.0f;
+    m_superSawDetune.store(std::max(0.0f, std::min(1.0f, amount)), std::memory_order_relaxed);
+}
 
-    if (t < dt)
-    {
-        const float t_norm = t / dt;
-        return t_norm * t_norm - 2.0f * t_norm + 1.0f;
-    }
-    else if (t > 1.0f - dt)
-    {
-        const float t_norm = (t - 1.0f) / dt + 1.0f;
-        return t_norm * t_norm + 2.0f * t_norm - 1.0f;
-    }
+void Oscillator::setSuperSawMix(float mix)
+{
+    m_superSawMix.store(std::max(0.0f, std::min(1.0f, mix)), std::memory_order_relaxed);
+}
+
+void Oscillator::setSuperSawSpread(float spread)
+{
+    m_superSawSpread.store(std::max(0.0f, std::min(1.0f, spread)), std::memory_order_relaxed);
+}
 
-    return 0.0f;
+void Oscillator::setSlideTime(float seconds)
+{
+    m_slideTime.store(std::max(0.001f, std::min(0.5f, seconds)),
+                      std::memory_order_relaxed);
 }
@@ -1,15 +1,24 @@
 #pragma once
 
 #include "../core/DSPModule.h"
+#include "../core/RandomGenerator.h"
+#include "../core/SmoothedParameter.h"
+#include "SuperSaw.h"
+#include "Wavetable.h"
+#include <array>
 #include <atomic>
 #include <cmath>
-#include <random>
 
 /**
  * Band-limited oscillator with 12 waveforms
  * 303 style bass synthesis with extended capabilities
+ *
+ * All periodic waveforms play from the shared mip-mapped WavetableBank; the
+ * mip level follows the phase increment so no harmonic reaches Nyquist.
+ * SuperSaw runs the SIMD SuperSaw kernel with its own polyBLEP and can render
+ * a stereo spread; noise is block-filled from a seeded RandomGenerator.
  */
-class Oscillator : public DSPModule {
+class Oscillator final : public DSPModule {
 public:
     enum class Waveform {
         Sawtooth = 0,
@@ -33,6 +42,13 @@ public:
     void prepare(double sampleRate, int samplesPerBlock) override;
     void reset() override;
     float processSample(float input) override;
+    void process(float* data, int numSamples) override;
+
+    /**
+     * Renders into two channels. Only SuperSaw produces different left and right
+     * signals; every other waveform is copied to both.
+     */
+    void process(float* left, float* right, int numSamples);
 
     // Oscillator-specific methods
     void setFrequency(float frequencyHz);
@@ -41,22 +57,47 @@ public:
     void setFineTune(float cents);
     void setSlideTime(float seconds);
 
+    // SuperSaw stack
+    void setSuperSawVoices(int voices);     // 1 - 16
+    void setSuperSawDetune(float amount);   // 0.0 - 1.0
+    void setSuperSawMix(float mix);         // 0.0 = centre voice, 1.0 = side voices
+    void setSuperSawSpread(float spread);   // 0.0 = mono, 1.0 = full stereo width
+
+    // Noise seed - not thread safe, set before prepare(); reset() restarts the sequence
+    void setRandomSeed(uint64_t seed) { m_random.setSeed(seed); }
+
 private:
+    void render(float* left, float* right, int numSamples);
+
+    // Renders a block with the waveform selection hoisted out of the loop.
+    // fineTune holds the ramped fine-tune ratio for each sample.
+    template <typename Generator>
+    void renderBlock(float* data, int numSamples, float targetFreq, const float* fineTune, Generator&& generate);
+    void renderSuperSaw(float* left, float* right, int numSamples, float targetFreq, const float* fineTune);
+    void renderNoise(float* data, int numSamples, float targetFreq, const float* fineTune);
+
+    // One step of the portamento slide - returns the new phase increment
+    float advanceSlide(float targetFreq, float slideCoeff, float inverseSampleRate) noexcept
+    {
+        m_frequencySmoothing = m_frequencySmoothing * slideCoeff + targetFreq * (1.0f - slideCoeff);
+        m_phaseIncrement = m_frequencySmoothing * inverseSampleRate;
+        return m_phaseIncrement;
+    }
+
+    void advancePhase() noexcept
+    {
+        m_phase += m_phaseIncrement;
+        if (m_phase >= 1.0f)
+            m_phase -= 1.0f;
+    }
+
+    // Per-block control updates - transcendental math only runs when a value changes
+    void updateSlideCoefficient(float slideTime);
+    void updateFineTune(float cents);
+
     // Waveform generators
-    float generateSawtooth();
-    float generateSquare();
-    float generateTriangle();
-    float generateSine();
-    float generatePulse(float width);
-    float generateSuperSaw();
-    float generateNoise();
-    float generateSawSquare();
-    float generateTriSaw();
-    float generateSyncSaw();
-    float generateFM();
-
-    // PolyBLEP anti-aliasing
-    float polyBLEP(float t, float dt) const;
+    void updateTableLevel(float phaseIncrement);
+    float generateWavetable(WavetableBank::Shape shape) const;
 
     // State
     float m_sampleRate = 44100.0f;
@@ -64,30 +105,33 @@ private:
     float m_phaseIncrement = 0.0f;
     float m_frequencySmoothing = 440.0f;
     float m_slideCoeff = 0.999f;
+    float m_currentSlideTime = -1.0f;       // Slide time m_slideCoeff was computed for
+    float m_currentFineTuneCents = 0.0f;    // Cents m_fineTuneRatio was computed for
+    float m_fineTuneRatio = 1.0f;
+    SmoothedParameter m_fineTuneSmoother{SmoothedParameter::Curve::Multiplicative};   // Ramps m_fineTuneRatio
+    static constexpr float PARAMETER_RAMP_TIME = 0.02f;   // 20ms
 
-    // SuperSaw detuned phases
-    float m_superSawPhases[7] = {0};
-    float m_superSawDetune[7] = {-0.11f, -0.06f, -0.02f, 0.0f, 0.02f, 0.06f, 0.11f};
+    // Wavetable playback (the shared bank is built when the first oscillator is created)
+    const WavetableBank* m_wavetables = &WavetableBank::getInstance();
+    int m_tableLevel = 0;
+    float m_tableLevelMinIncrement = 1.0f;  // Increment range served by m_tableLevel
+    float m_tableLevelMaxIncrement = 0.0f;
 
-    // Sync oscillator
-    float m_syncPhase = 0.0f;
-    float m_syncRatio = 2.5f;
-
-    // FM synthesis
-    float m_modPhase = 0.0f;
-    float m_fmIndex = 3.0f;
-    float m_fmRatio = 2.0f;
+    // SuperSaw stack (phase increments are staged per chunk for the SIMD kernel)
+    static constexpr int SUPERSAW_CHUNK_SIZE = 64;
+    SuperSaw m_superSaw;
+    std::array<float, SUPERSAW_CHUNK_SIZE> m_incrementBuffer{};
 
     // Noise generator
-    std::mt19937 m_rng;
-    std::uniform_real_distribution<float> m_noiseDist{-1.0f, 1.0f};
+    RandomGenerator m_random;
 
     // Parameters (atomic for thread safety)
     std::atomic<float> m_targetFrequency{440.0f};
     std::atomic<Waveform> m_waveform{Waveform::Sawtooth};
     std::atomic<float> m_fineTuneCents{0.0f};
     std::atomic<float> m_slideTime{0.1f};
-
-    // Constants
-    static constexpr float TWO_PI = 6.283185307179586f;
+    std::atomic<int> m_superSawVoices{7};
+    std::atomic<float> m_superSawDetune{0.5f};
+    std::atomic<float> m_superSawMix{0.5f};
+    std::atomic<float> m_superSawSpread{0.5f};
 };
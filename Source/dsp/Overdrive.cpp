@@ -1,110 +1,194 @@
 #include "Overdrive.h"
 #include <algorithm>
+#include <cmath>
 
 void Overdrive::prepare(double sampleRate, int samplesPerBlock)
 {
     m_sampleRate = static_cast<float>(sampleRate);
+    m_mixSmoother.prepare(sampleRate, samplesPerBlock, PARAMETER_RAMP_TIME);
+    m_wetBuffer.assign(static_cast<size_t>(samplesPerBlock), 0.0f);
+
+    // Build the shared tanh antiderivative table and the first curve off the audio thread
+    Antiderivative::logCoshIntegral(0.0);
+    m_tables.prepare(sampleRate, static_cast<int>(m_mode.load()), m_drive.load());
+
     reset();
 }
 
+void Overdrive::setSampleRate(double sampleRate)
+{
+    m_sampleRate = static_cast<float>(sampleRate);
+    m_mixSmoother.setSampleRate(sampleRate);
+    m_tables.setSampleRate(sampleRate);
+}
+
 void Overdrive::reset()
 {
     m_dcIn = 0.0f;
     m_dcOut = 0.0f;
+    m_activeState.reset();
+    m_fadingState.reset();
+    m_lastInput = 0.0f;
+    m_primePending = true;
+
+    // Parameter ramps jump to the current values
+    m_mixSmoother.reset(m_mix.load());
+}
+
+bool Overdrive::isSilent() const
+{
+    // An asymmetric curve maps silence to a constant, which the DC blocker
+    // removes - its input may settle anywhere, its output must reach zero
+    return std::abs(m_lastInput) < SILENCE_THRESHOLD && std::abs(m_dcOut) < SILENCE_THRESHOLD;
 }
 
 float Overdrive::processSample(float input)
 {
-    float drive = m_drive.load(std::memory_order_relaxed);
-    Mode mode = m_mode.load(std::memory_order_relaxed);
-    float mix = m_mix.load(std::memory_order_relaxed);
+    float output = input;
+    process(&output, 1);
+    return output;
+}
+
+void Overdrive::process(float* data, int numSamples)
+{
+    const Mode mode = m_mode.load(std::memory_order_relaxed);
+    const Antialiasing order = getAntialiasing(mode);
+    const float drive = m_drive.load(std::memory_order_relaxed);
 
-    // Skip processing if drive is 1.0 (no effect)
-    if (drive <= 1.01f)
-        return input;
+    m_tables.request(static_cast<int>(mode), drive);
+    m_mixSmoother.setTarget(m_mix.load(std::memory_order_relaxed));
 
-    float processed = 0.0f;
+    // A new table starts a crossfade: the outgoing history carries on with the
+    // old table, the incoming one starts as if the input had been held
+    if (m_tables.update())
+    {
+        m_fadingState = m_activeState;
+        m_activeState.prime(m_tables.getActive(), m_lastInput);
+    }
 
-    switch (mode)
+    // Skip processing if drive has settled at 1.0 (no effect). The output is
+    // the input, so the DC blocker has nothing left to settle
+    if (!m_tables.isCrossfading() && drive <= 1.01f && m_tables.getActive().getDrive() <= 1.01f)
     {
-        case Mode::Soft:      processed = processSoft(input, drive); break;
-        case Mode::Classic:   processed = processClassic(input, drive); break;
-        case Mode::Saturated: processed = processSaturated(input, drive); break;
-        case Mode::Fuzz:      processed = processFuzz(input, drive); break;
-        case Mode::Tape:      processed = processTape(input, drive); break;
-        default:              processed = processClassic(input, drive); break;
+        m_dcIn = 0.0f;
+        m_dcOut = 0.0f;
+        m_lastInput = numSamples > 0 ? data[numSamples - 1] : 0.0f;
+        m_primePending = true;
+        return;
     }
 
-    // DC blocker to remove any DC offset from distortion
-    float dcBlocked = processed - m_dcIn + DC_COEFF * m_dcOut;
-    m_dcIn = processed;
-    m_dcOut = dcBlocked;
+    if (numSamples <= 0)
+        return;
 
-    // Apply dry/wet mix
-    return input * (1.0f - mix) + dcBlocked * mix;
-}
+    jassert(numSamples <= static_cast<int>(m_wetBuffer.size()));
 
-float Overdrive::processSoft(float input, float drive)
-{
-    // Soft clipping using tanh - warm tube-like saturation
-    float gained = input * drive;
-    return std::tanh(gained) / std::tanh(drive);  // Normalize output
+    // ADAA history belongs to one table and order
+    if (m_primePending || order != m_stateOrder)
+    {
+        const float input = m_primePending ? data[0] : m_lastInput;
+        m_activeState.prime(m_tables.getActive(), input);
+        if (m_tables.isCrossfading())
+            m_fadingState.prime(m_tables.getFading(), input);
+
+        m_stateOrder = order;
+        m_primePending = false;
+    }
+
+    const float* mix = m_mixSmoother.render(numSamples);
+
+    switch (order)
+    {
+        case Antialiasing::First:
+            renderTables(data, numSamples, mix, [](const WaveshaperTable& table, Antiderivative::State& state, float x) { return state.first(table, x); });
+            break;
+        case Antialiasing::Second:
+            renderTables(data, numSamples, mix, [](const WaveshaperTable& table, Antiderivative::State& state, float x) { return state.second(table, x); });
+            break;
+        case Antialiasing::Off:
+        default:
+            if (!m_tables.isCrossfading())
+            {
+                // Plain shaping is a single gather over the block
+                m_tables.getActive().process(data, m_wetBuffer.data(), numSamples);
+                mixBlock(data, numSamples, mix);
+            }
+            else
+            {
+                renderTables(data, numSamples, mix, [](const WaveshaperTable& table, Antiderivative::State&, float x) { return table.f(x); });
+            }
+            break;
+    }
+
+    m_lastInput = data[numSamples - 1];
 }
 
-float Overdrive::processClassic(float input, float drive)
+template <typename Shaper>
+void Overdrive::renderTables(float* data, int numSamples, const float* mix, Shaper&& shape)
 {
-    // Classic 303 style - asymmetric soft clipping
-    float gained = input * drive;
+    const WaveshaperTable& active = m_tables.getActive();
+    float* wet = m_wetBuffer.data();
 
-    // Asymmetric waveshaping
-    if (gained > 0.0f)
-        return std::tanh(gained * 1.2f) * 0.9f;
+    if (!m_tables.isCrossfading())
+    {
+        for (int i = 0; i < numSamples; ++i)
+            wet[i] = shape(active, m_activeState, data[i]);
+    }
     else
-        return std::tanh(gained * 0.8f) * 1.1f;
-}
+    {
+        const WaveshaperTable& fading = m_tables.getFading();
 
-float Overdrive::processSaturated(float input, float drive)
-{
-    // Hard saturation with some harmonics
-    float gained = input * drive;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float gain = m_tables.nextCrossfadeGain();
+            const float shaped = shape(active, m_activeState, data[i]);
 
-    // Polynomial saturation: x - x^3/3
-    float x = std::max(-1.5f, std::min(1.5f, gained));
-    float out = x - (x * x * x) / 3.0f;
+            // The outgoing table is dropped once the fade completes
+            wet[i] = gain < 1.0f ? shaped * gain + shape(fading, m_fadingState, data[i]) * (1.0f - gain)
+                                 : shaped;
+        }
+    }
 
-    return std::max(-1.0f, std::min(1.0f, out));
+    mixBlock(data, numSamples, mix);
 }
 
-float Overdrive::processFuzz(float input, float drive)
+void Overdrive::mixBlock(float* data, int numSamples, const float* mix)
 {
-    // Fuzz: heavy clipping with octave-up harmonics
-    float gained = input * drive * 2.0f;
+    const float* wet = m_wetBuffer.data();
+    float dcIn = m_dcIn;
+    float dcOut = m_dcOut;
 
-    // Full wave rectification adds octave
-    float rectified = std::abs(gained);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float input = data[i];
+        const float processed = wet[i];
 
-    // Hard clip
-    float clipped = std::max(-1.0f, std::min(1.0f, gained));
+        // DC blocker to remove any DC offset from distortion
+        float dcBlocked = processed - dcIn + DC_COEFF * dcOut;
+        dcIn = processed;
+        dcOut = dcBlocked;
 
-    // Mix original sign with rectified
-    return (clipped * 0.7f + rectified * 0.3f * (input > 0 ? 1.0f : -1.0f));
+        // Apply dry/wet mix
+        data[i] = input * (1.0f - mix[i]) + dcBlocked * mix[i];
+    }
+
+    m_dcIn = dcIn;
+    m_dcOut = dcOut;
 }
 
-float Overdrive::processTape(float input, float drive)
+void Overdrive::buildTable(WaveshaperTable& table, int mode, float drive)
 {
-    // Tape saturation: gentle, warm compression
-    float gained = input * drive * 0.7f;
-
-    // Soft knee compression curve
-    float absGained = std::abs(gained);
-    float sign = gained >= 0.0f ? 1.0f : -1.0f;
+    using namespace Antiderivative;
 
-    if (absGained < 0.5f)
-        return gained;
-    else if (absGained < 1.0f)
-        return sign * (0.5f + (absGained - 0.5f) * 0.5f);
-    else
-        return sign * (0.75f + (absGained - 1.0f) * 0.1f);
+    switch (static_cast<Mode>(mode))
+    {
+        // Soft clipping using tanh - warm tube-like saturation, normalised to full scale
+        case Mode::Soft:      table.build<Tanh>(mode, drive, drive, 1.0f / std::tanh(drive)); break;
+        case Mode::Saturated: table.build<CubicSaturation>(mode, drive, drive, 1.0f); break;
+        case Mode::Fuzz:      table.build<Fuzz>(mode, drive, drive * 2.0f, 1.0f); break;
+        case Mode::Tape:      table.build<TapeKnee>(mode, drive, drive * 0.7f, 1.0f); break;
+        case Mode::Classic:
+        default:              table.build<AsymmetricTanh>(mode, drive, drive, 1.0f); break;
+    }
 }
 
 void Overdrive::setDrive(float amount)
@@ -127,3 +211,31 @@ void Overdrive::setMix(float mix)
 {
     m_mix.store(std::max(0.0f, std::min(1.0f, mix)), std::memory_order_relaxed);
 }
+
+void Overdrive::setAntialiasing(Mode mode, Antialiasing order)
+{
+    const int index = static_cast<int>(mode);
+    if (index >= 0 && index < NUM_MODES)
+        m_antialiasing[static_cast<size_t>(index)].store(order, std::memory_order_relaxed);
+}
+
+void Overdrive::setAntialiasing(Antialiasing order)
+{
+    for (auto& modeOrder : m_antialiasing)
+        modeOrder.store(order, std::memory_order_relaxed);
+}
+
+void Overdrive::setAntialiasing(int index)
+{
+    if (index >= 0 && index <= 2)
+        setAntialiasing(static_cast<Antialiasing>(index));
+}
+
+Overdrive::Antialiasing Overdrive::getAntialiasing(Mode mode) const
+{
+    const int index = static_cast<int>(mode);
+    if (index < 0 || index >= NUM_MODES)
+        return Antialiasing::Off;
+
+    return m_antialiasing[static_cast<size_t>(index)].load(std::memory_order_relaxed);
+}
@@ -1,13 +1,25 @@
 #pragma once
 
 #include "../core/DSPModule.h"
+#include "../core/SmoothedParameter.h"
+#include "Antiderivative.h"
+#include "WaveshaperTable.h"
+#include <array>
 #include <atomic>
 #include <cmath>
+#include <memory>
+#include <vector>
 
 /**
  * Overdrive/Distortion module with multiple saturation modes
+ *
+ * Every mode is a memoryless curve from Antiderivative.h and can run plain or
+ * with first/second-order antiderivative anti-aliasing, selected per mode.
+ * The curve for the current mode and drive is baked into a WaveshaperTable on
+ * a background thread; the audio thread only reads tables and crossfades into
+ * a new one when Drive or Drive Mode changes.
  */
-class Overdrive : public DSPModule {
+class Overdrive final : public DSPModule {
 public:
     enum class Mode {
         Soft = 0,      // Soft clipping (tube-like)
@@ -17,24 +29,54 @@ public:
         Tape           // Tape saturation
     };
 
+    static constexpr int NUM_MODES = 5;
+
+    using Antialiasing = Antiderivative::Order;
+
     Overdrive() = default;
     ~Overdrive() override = default;
 
     void prepare(double sampleRate, int samplesPerBlock) override;
     void reset() override;
     float processSample(float input) override;
+    void process(float* data, int numSamples) override;
+
+    /** Audio thread: follows an oversampling change, keeping the shaper and DC blocker state. */
+    void setSampleRate(double sampleRate);
+
+    /** True once the last input and the DC blocker output are below SILENCE_THRESHOLD. */
+    bool isSilent() const override;
 
     void setDrive(float amount);      // 1.0 - 10.0
     void setMode(Mode mode);
     void setMode(int index);
     void setMix(float mix);           // 0.0 - 1.0 dry/wet
 
+    void setAntialiasing(Mode mode, Antialiasing order);
+    void setAntialiasing(Antialiasing order);    // All modes
+    void setAntialiasing(int index);             // All modes
+    Antialiasing getAntialiasing(Mode mode) const;
+
+    /** Drive of the table currently being played (lags setDrive() until the rebuild lands). */
+    float getTableDrive() const { return m_tables.getActive().getDrive(); }
+
+    /** Bakes a mode's curve at the given drive, including its input and output gains. */
+    static void buildTable(WaveshaperTable& table, int mode, float drive);
+
+    /**
+     * A table builder for several overdrives (e.g. the channels of one chain),
+     * which then build each curve once. Set before prepare().
+     */
+    static std::shared_ptr<WaveshaperBuilder> createTableBuilder() { return std::make_shared<WaveshaperBuilder>(&Overdrive::buildTable); }
+    void setTableBuilder(std::shared_ptr<WaveshaperBuilder> builder) { m_tables.setBuilder(std::move(builder)); }
+
 private:
-    float processSoft(float input, float drive);
-    float processClassic(float input, float drive);
-    float processSaturated(float input, float drive);
-    float processFuzz(float input, float drive);
-    float processTape(float input, float drive);
+    // Shapes a block through the active table, crossfading from the previous one after a swap
+    template <typename Shaper>
+    void renderTables(float* data, int numSamples, const float* mix, Shaper&& shape);
+
+    // DC blocker and dry/wet mix over the shaped block in m_wetBuffer
+    void mixBlock(float* data, int numSamples, const float* mix);
 
     float m_sampleRate = 44100.0f;
 
@@ -43,8 +85,25 @@ private:
     float m_dcOut = 0.0f;
     static constexpr float DC_COEFF = 0.995f;
 
+    // Curve tables, rebuilt off the audio thread
+    WaveshaperTables m_tables{&Overdrive::buildTable};
+    std::vector<float> m_wetBuffer;
+
+    // ADAA history for the active table and the one fading out - re-primed
+    // whenever the table or order changes
+    Antiderivative::State m_activeState;
+    Antiderivative::State m_fadingState;
+    Antialiasing m_stateOrder = Antialiasing::Off;
+    float m_lastInput = 0.0f;
+    bool m_primePending = true;
+
+    // Parameter ramp (rendered once per block); drive changes crossfade between tables
+    SmoothedParameter m_mixSmoother;
+    static constexpr float PARAMETER_RAMP_TIME = 0.02f;   // 20ms
+
     // Parameters
     std::atomic<float> m_drive{1.0f};
     std::atomic<Mode> m_mode{Mode::Classic};
     std::atomic<float> m_mix{1.0f};
+    std::array<std::atomic<Antialiasing>, NUM_MODES> m_antialiasing{};
 };
@@ -0,0 +1,119 @@
+#include "OversamplingStage.h"
+#include <algorithm>
+
+void OversamplingStage::prepare(double sampleRate, int samplesPerBlock)
+{
+    m_sampleRate = sampleRate;
+
+    using Oversampling = juce::dsp::Oversampling<float>;
+
+    for (int type = 0; type < 2; ++type)
+    {
+        const auto filterType = type == static_cast<int>(FilterType::MinimumPhase)
+                                    ? Oversampling::filterHalfBandPolyphaseIIR
+                                    : Oversampling::filterHalfBandFIREquiripple;
+
+        for (int stages = 1; stages <= 3; ++stages)
+        {
+            auto& oversampler = m_oversamplers[static_cast<size_t>(type)][static_cast<size_t>(stages - 1)];
+            oversampler = std::make_unique<Oversampling>(static_cast<size_t>(MAX_CHANNELS), static_cast<size_t>(stages),
+                                                         filterType, true, true);
+            oversampler->initProcessing(static_cast<size_t>(samplesPerBlock));
+        }
+    }
+
+    m_controlBuffer.assign(static_cast<size_t>(samplesPerBlock * MAX_FACTOR), 0.0f);
+
+    reset();
+}
+
+void OversamplingStage::reset()
+{
+    for (auto& oversamplersForType : m_oversamplers)
+        for (auto& oversampler : oversamplersForType)
+            if (oversampler != nullptr)
+                oversampler->reset();
+
+    m_lastControl = 0.0f;
+}
+
+void OversamplingStage::setFactor(Factor factor)
+{
+    const int factorLog2 = static_cast<int>(factor);
+    if (factorLog2 == m_factorLog2)
+        return;
+
+    // The newly selected oversampler starts from silence
+    m_factorLog2 = factorLog2;
+    if (auto* oversampler = getActiveOversampler())
+        oversampler->reset();
+}
+
+void OversamplingStage::setFactor(int index)
+{
+    if (index >= 0 && index <= 3)
+        setFactor(static_cast<Factor>(index));
+}
+
+void OversamplingStage::setFilterType(FilterType type)
+{
+    if (type == m_filterType)
+        return;
+
+    m_filterType = type;
+    if (auto* oversampler = getActiveOversampler())
+        oversampler->reset();
+}
+
+void OversamplingStage::setFilterType(int index)
+{
+    if (index >= 0 && index <= 1)
+        setFilterType(static_cast<FilterType>(index));
+}
+
+int OversamplingStage::getLatencySamples() const noexcept
+{
+    if (auto* oversampler = getActiveOversampler())
+        return juce::roundToInt(oversampler->getLatencyInSamples());
+
+    return 0;
+}
+
+const float* OversamplingStage::upsampleControl(const float* input, int numSamples)
+{
+    const int factor = getFactor();
+
+    if (factor == 1 || numSamples <= 0)
+    {
+        if (numSamples > 0)
+            m_lastControl = input[numSamples - 1];
+        return input;
+    }
+
+    jassert(numSamples * factor <= static_cast<int>(m_controlBuffer.size()));
+
+    // Ramp from the previous base-rate sample to each new one
+    const float step = 1.0f / static_cast<float>(factor);
+    float* output = m_controlBuffer.data();
+    float previous = m_lastControl;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float delta = (input[i] - previous) * step;
+        for (int j = 1; j <= factor; ++j)
+            *output++ = previous + delta * static_cast<float>(j);
+
+        previous = input[i];
+    }
+
+    m_lastControl = previous;
+    return m_controlBuffer.data();
+}
+
+juce::dsp::Oversampling<float>* OversamplingStage::getActiveOversampler() const noexcept
+{
+    if (m_factorLog2 == 0)
+        return nullptr;
+
+    return m_oversamplers[static_cast<size_t>(m_filterType)][static_cast<size_t>(m_factorLog2 - 1)].get();
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+/**
+ * Oversampled region for the nonlinear stages (ladder filter and overdrive)
+ *
+ * Wraps juce::dsp::Oversampling: process() upsamples the block, hands the
+ * oversampled channels to a callback and decimates the result back in place.
+ * Everything before and after the region (oscillator, effects) stays at the
+ * base rate.
+ *
+ * One oversampler per factor and filter type is built in prepare(), so
+ * switching factor on the audio thread never allocates. Minimum-phase
+ * polyphase IIR filters add little latency; linear-phase FIR filters keep the
+ * phase response flat at the cost of more latency. Latency is rounded to
+ * whole samples so the host can compensate it exactly.
+ */
+class OversamplingStage {
+public:
+    enum class Factor {
+        Off = 0,
+        X2,
+        X4,
+        X8
+    };
+
+    enum class FilterType {
+        MinimumPhase = 0,   // Polyphase IIR half-band
+        LinearPhase         // Equiripple FIR half-band
+    };
+
+    static constexpr int MAX_FACTOR = 8;
+    static constexpr int MAX_CHANNELS = 2;
+
+    /** Builds every oversampler and the control buffer - never on the audio thread. */
+    void prepare(double sampleRate, int samplesPerBlock);
+    void reset();
+
+    void setFactor(Factor factor);
+    void setFactor(int index);
+    void setFilterType(FilterType type);
+    void setFilterType(int index);
+
+    int getFactor() const noexcept { return 1 << m_factorLog2; }
+    double getOversampledRate() const noexcept { return m_sampleRate * getFactor(); }
+    int getLatencySamples() const noexcept;
+
+    /**
+     * Upsamples left/right (right may be nullptr), calls
+     * processOversampled(float* const* channels, int numChannels, int numSamples)
+     * at the oversampled rate and decimates back into left/right.
+     */
+    template <typename Processor>
+    void process(float* left, float* right, int numSamples, Processor&& processOversampled)
+    {
+        float* channels[MAX_CHANNELS] = { left, right };
+        const int numChannels = right != nullptr ? 2 : 1;
+
+        auto* oversampler = getActiveOversampler();
+        if (oversampler == nullptr)
+        {
+            processOversampled(channels, numChannels, numSamples);
+            return;
+        }
+
+        juce::dsp::AudioBlock<float> block(channels, static_cast<size_t>(numChannels), static_cast<size_t>(numSamples));
+        auto oversampled = oversampler->processSamplesUp(block);
+
+        float* oversampledChannels[MAX_CHANNELS] = { oversampled.getChannelPointer(0),
+                                                     numChannels > 1 ? oversampled.getChannelPointer(1) : nullptr };
+        processOversampled(oversampledChannels, numChannels, static_cast<int>(oversampled.getNumSamples()));
+
+        oversampler->processSamplesDown(block);
+    }
+
+    /**
+     * Linearly interpolates a base-rate control signal (the filter envelope) to
+     * the oversampled rate. Call once per block; returns input when oversampling is off.
+     */
+    const float* upsampleControl(const float* input, int numSamples);
+
+private:
+    juce::dsp::Oversampling<float>* getActiveOversampler() const noexcept;
+
+    // [filter type][factor - 1], built in prepare()
+    std::array<std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, 3>, 2> m_oversamplers;
+
+    double m_sampleRate = 44100.0;
+    int m_factorLog2 = 0;
+    FilterType m_filterType = FilterType::MinimumPhase;
+
+    // Upsampled control signal
+    std::vector<float> m_controlBuffer;
+    float m_lastControl = 0.0f;
+};
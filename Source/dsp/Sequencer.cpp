@@ -0,0 +1,214 @@
+#include "Sequencer.h"
+#include <algorithm>
+#include <cmath>
+
+// === PATTERN ===
+
+juce::String Sequencer::Pattern::toString() const
+{
+    juce::StringArray steps;
+    for (int step = 0; step < NUM_STEPS; ++step)
+        steps.add(juce::String(notes[static_cast<size_t>(step)]) + ":" + juce::String(flags[static_cast<size_t>(step)]));
+
+    return steps.joinIntoString(" ");
+}
+
+bool Sequencer::Pattern::fromString(const juce::String& text)
+{
+    const auto steps = juce::StringArray::fromTokens(text, " ", "");
+    if (steps.size() != NUM_STEPS)
+        return false;
+
+    Pattern parsed;
+    for (int step = 0; step < NUM_STEPS; ++step)
+    {
+        const auto& token = steps[step];
+        if (!token.containsChar(':'))
+            return false;
+
+        const int note = token.upToFirstOccurrenceOf(":", false, false).getIntValue();
+        const int stepFlags = token.fromFirstOccurrenceOf(":", false, false).getIntValue();
+        if (note < 0 || note > 127 || stepFlags < 0 || stepFlags > (Gate | Accent | Slide))
+            return false;
+
+        parsed.notes[static_cast<size_t>(step)] = static_cast<uint8_t>(note);
+        parsed.flags[static_cast<size_t>(step)] = static_cast<uint8_t>(stepFlags);
+    }
+
+    *this = parsed;
+    return true;
+}
+
+// === SEQUENCER ===
+
+Sequencer::Sequencer()
+{
+}
+
+void Sequencer::prepare(double sampleRate)
+{
+    m_sampleRate = sampleRate;
+    m_events.reserve(MAX_EVENTS);
+    reset();
+}
+
+void Sequencer::reset()
+{
+    m_nextStep = -1;
+    m_gateOpen = false;
+    m_tied = false;
+    m_currentNote = -1;
+    m_playingStep.store(-1, std::memory_order_relaxed);
+    m_events.clear();
+}
+
+const std::vector<Sequencer::Event>& Sequencer::process(double bpm, double ppqPosition, int numSamples)
+{
+    m_events.clear();
+
+    // Pattern edits take effect from the next step scheduled
+    m_patterns.update();
+    const Pattern& pattern = m_patterns.read();
+
+    if (!m_enabled.load(std::memory_order_relaxed))
+    {
+        // Release the last step when the sequencer is switched off
+        if (m_gateOpen)
+            addEvent(Event::Type::NoteOff, 0, m_currentNote, false, false);
+
+        m_nextStep = -1;
+        m_gateOpen = false;
+        m_tied = false;
+        m_playingStep.store(-1, std::memory_order_relaxed);
+        return m_events;
+    }
+
+    if (numSamples <= 0 || bpm <= 0.0)
+        return m_events;
+
+    // Timing - evaluated once per span
+    const double samplesPerBeat = m_sampleRate * 60.0 / bpm;
+    const double shuffleBeats = STEP_BEATS * MAX_SHUFFLE * m_shuffle.load(std::memory_order_relaxed);
+
+    // First sample at or after a grid position
+    const auto toOffset = [&](double ppq)
+    {
+        return static_cast<int>(std::ceil((ppq - ppqPosition) * samplesPerBeat - 1.0e-6));
+    };
+
+    // Resync after a transport jump or loop (the next step is more than a sample
+    // behind us or far ahead)
+    if (m_nextStep >= 0
+        && (m_nextStepPpq < ppqPosition - 1.0 / samplesPerBeat || m_nextStepPpq > ppqPosition + 3.0 * STEP_BEATS))
+    {
+        if (m_gateOpen)
+            addEvent(Event::Type::NoteOff, 0, m_currentNote, false, false);
+
+        m_nextStep = -1;
+        m_gateOpen = false;
+        m_tied = false;
+    }
+
+    if (m_nextStep < 0)
+    {
+        m_nextStep = findNextStep(ppqPosition, shuffleBeats);
+        m_nextStepPpq = getStepStart(m_nextStep, shuffleBeats);
+    }
+
+    while (true)
+    {
+        // Gate-offs come first when they coincide with the next step; tied notes run on
+        if (m_gateOpen && !m_tied && m_gateOffPpq <= m_nextStepPpq)
+        {
+            const int offset = std::max(0, toOffset(m_gateOffPpq));
+            if (offset >= numSamples)
+                break;
+
+            addEvent(Event::Type::NoteOff, offset, m_currentNote, false, false);
+            m_gateOpen = false;
+            continue;
+        }
+
+        // Events rounding past the end of the span fall at the start of the next
+        const int offset = std::max(0, toOffset(m_nextStepPpq));
+        if (offset >= numSamples)
+            break;
+
+        const int step = getPatternStep(m_nextStep);
+        const double start = m_nextStepPpq;
+        const double next = getStepStart(m_nextStep + 1, shuffleBeats);
+
+        if (pattern.hasFlag(step, Pattern::Gate))
+        {
+            const int note = pattern.notes[static_cast<size_t>(step)];
+            addEvent(Event::Type::NoteOn, offset, note, pattern.hasFlag(step, Pattern::Accent), m_tied && m_gateOpen);
+
+            m_gateOpen = true;
+            m_currentNote = note;
+            m_tied = pattern.hasFlag(step, Pattern::Slide) && pattern.hasFlag(getPatternStep(m_nextStep + 1), Pattern::Gate);
+            m_gateOffPpq = start + GATE_LENGTH * (next - start);
+        }
+        else if (m_gateOpen)
+        {
+            // A tie into a step that has since become a rest ends here
+            addEvent(Event::Type::NoteOff, offset, m_currentNote, false, false);
+            m_gateOpen = false;
+            m_tied = false;
+        }
+
+        m_playingStep.store(step, std::memory_order_relaxed);
+        ++m_nextStep;
+        m_nextStepPpq = next;
+    }
+
+    return m_events;
+}
+
+double Sequencer::getStepStart(int64_t index, double shuffleBeats) const
+{
+    return static_cast<double>(index) * STEP_BEATS + ((index & 1) != 0 ? shuffleBeats : 0.0);
+}
+
+int64_t Sequencer::findNextStep(double ppq, double shuffleBeats) const
+{
+    auto index = static_cast<int64_t>(std::floor(ppq / STEP_BEATS)) - 1;
+    while (getStepStart(index, shuffleBeats) < ppq - 1.0e-9)
+        ++index;
+
+    return index;
+}
+
+void Sequencer::addEvent(Event::Type type, int offset, int note, bool accent, bool slide)
+{
+    // Never grows past the capacity reserved in prepare()
+    if (static_cast<int>(m_events.size()) >= MAX_EVENTS)
+        return;
+
+    Event event;
+    event.type = type;
+    event.offset = offset;
+    event.note = note;
+    event.accent = accent;
+    event.slide = slide;
+    m_events.push_back(event);
+}
+
+// === PATTERN EDITING ===
+
+void Sequencer::setPattern(const Pattern& pattern)
+{
+    m_editPattern = pattern;
+    m_patterns.write(pattern);
+}
+
+// === PARAMETER SETTERS ===
+
+void Sequencer::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Sequencer::setShuffle(float shuffle)
+{
+    m_shuffle.store(std::max(0.0f, std::min(1.0f, shuffle)), std::memory_order_relaxed);
+}
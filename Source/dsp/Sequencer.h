@@ -0,0 +1,137 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../core/TripleBuffer.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * 16-step acid sequencer locked to the host transport
+ *
+ * Each step holds a note and gate, accent and slide flags. Steps are 1/16
+ * notes on the host's ppq grid (step 0 falls on every bar line), with odd
+ * steps delayed by the shuffle amount. A gated step plays for half its length;
+ * a slid step instead ties into the next gated step, which then glides to its
+ * pitch without retriggering the envelope.
+ *
+ * Like the arpeggiator, process() returns the notes and gate-offs of a span as
+ * sample-accurate events. Patterns are edited on the message thread and handed
+ * to the audio thread through a TripleBuffer, so neither side locks and a step
+ * never reads a half-written pattern.
+ */
+class Sequencer {
+public:
+    /** One pattern as flat arrays - plain data so it can be copied between threads. */
+    struct Pattern {
+        static constexpr int NUM_STEPS = 16;
+
+        enum Flags : uint8_t {
+            Gate = 1,
+            Accent = 2,
+            Slide = 4
+        };
+
+        std::array<uint8_t, NUM_STEPS> notes;      // MIDI note per step
+        std::array<uint8_t, NUM_STEPS> flags;      // Flags per step
+
+        Pattern() noexcept
+        {
+            notes.fill(DEFAULT_NOTE);
+            flags.fill(Gate);
+        }
+
+        bool hasFlag(int step, Flags flag) const noexcept
+        {
+            return (flags[static_cast<size_t>(step)] & flag) != 0;
+        }
+
+        void setFlag(int step, Flags flag, bool on) noexcept
+        {
+            auto& stepFlags = flags[static_cast<size_t>(step)];
+            stepFlags = static_cast<uint8_t>(on ? (stepFlags | flag) : (stepFlags & ~flag));
+        }
+
+        /** "note:flags" per step, space separated - stored with the plugin state. */
+        juce::String toString() const;
+
+        /** Parses toString() output. Returns false (leaving the pattern unchanged) if malformed. */
+        bool fromString(const juce::String& text);
+
+        static constexpr uint8_t DEFAULT_NOTE = 36;    // C2
+    };
+
+    /** A step starting (NoteOn) or its gate closing (NoteOff) at a sample offset. */
+    struct Event {
+        enum class Type { NoteOn, NoteOff };
+
+        Type type = Type::NoteOn;
+        int offset = 0;
+        int note = -1;
+        bool accent = false;
+        bool slide = false;     // NoteOn glides from the previous note without retriggering
+    };
+
+    static constexpr int MAX_EVENTS = 256;          // Per process() call
+    static constexpr double STEP_BEATS = 0.25;      // 1/16 notes
+    static constexpr double GATE_LENGTH = 0.5;      // Fraction of a step a gated note plays
+    static constexpr double MAX_SHUFFLE = 0.5;      // Odd steps delayed by up to half a step
+
+    Sequencer();
+    ~Sequencer() = default;
+
+    void prepare(double sampleRate);
+    void reset();
+
+    /**
+     * Schedules the steps and gate-offs for numSamples samples starting at
+     * ppqPosition (quarter notes). Adopts the latest published pattern first.
+     */
+    const std::vector<Event>& process(double bpm, double ppqPosition, int numSamples);
+
+    // Message thread - publishes a new pattern to the audio thread
+    void setPattern(const Pattern& pattern);
+    const Pattern& getPattern() const { return m_editPattern; }
+
+    // Parameters
+    void setEnabled(bool enabled);
+    void setShuffle(float shuffle);  // 0-1
+
+    bool isEnabled() const { return m_enabled.load(); }
+
+    /** Step that last started playing, or -1 - for the editor's playhead. */
+    int getPlayingStep() const { return m_playingStep.load(std::memory_order_relaxed); }
+
+private:
+    // Start of grid step index, with odd steps delayed by shuffle
+    double getStepStart(int64_t index, double shuffleBeats) const;
+
+    // First grid step starting at or after ppq
+    int64_t findNextStep(double ppq, double shuffleBeats) const;
+
+    static int getPatternStep(int64_t index) { return static_cast<int>(index & (Pattern::NUM_STEPS - 1)); }
+
+    void addEvent(Event::Type type, int offset, int note, bool accent, bool slide);
+
+    double m_sampleRate = 44100.0;
+
+    // Patterns: edited on the message thread, played from the reader side
+    TripleBuffer<Pattern> m_patterns;
+    Pattern m_editPattern;
+
+    // Timing, in quarter notes on the host grid
+    int64_t m_nextStep = -1;           // Negative until synced to the grid
+    double m_nextStepPpq = 0.0;
+    double m_gateOffPpq = 0.0;
+    bool m_gateOpen = false;
+    bool m_tied = false;               // The sounding note slides into the next step
+    int m_currentNote = -1;
+    std::vector<Event> m_events;
+
+    std::atomic<int> m_playingStep{-1};
+
+    // Parameters
+    std::atomic<bool> m_enabled{false};
+    std::atomic<float> m_shuffle{0.0f};
+};
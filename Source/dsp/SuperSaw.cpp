@@ -0,0 +1,174 @@
+#include "SuperSaw.h"
+#include <algorithm>
+#include <cmath>
+
+SuperSaw::SuperSaw()
+{
+    updateLayout();
+    reset();
+}
+
+void SuperSaw::reset()
+{
+    // Spread the starting phases so the stack does not start phase-aligned
+    for (int v = 0; v < PADDED_VOICES; ++v)
+        m_phases[v] = v < m_numVoices ? static_cast<float>(v) / static_cast<float>(m_numVoices) : 0.0f;
+}
+
+void SuperSaw::setVoiceCount(int voices)
+{
+    voices = std::max(1, std::min(MAX_VOICES, voices));
+    if (voices == m_numVoices)
+        return;
+
+    m_numVoices = voices;
+    updateLayout();
+}
+
+void SuperSaw::setDetune(float amount)
+{
+    amount = std::max(0.0f, std::min(1.0f, amount));
+    if (amount == m_detune)
+        return;
+
+    m_detune = amount;
+    updateLayout();
+}
+
+void SuperSaw::setMix(float mix)
+{
+    mix = std::max(0.0f, std::min(1.0f, mix));
+    if (mix == m_mix)
+        return;
+
+    m_mix = mix;
+    updateLayout();
+}
+
+void SuperSaw::setSpread(float spread)
+{
+    spread = std::max(0.0f, std::min(1.0f, spread));
+    if (spread == m_spread)
+        return;
+
+    m_spread = spread;
+    updateLayout();
+}
+
+void SuperSaw::updateLayout()
+{
+    const int numVoices = m_numVoices;
+    m_numGroups = (numVoices + LANES - 1) / LANES;
+
+    // Odd stacks have one centre voice, even stacks share the centre between two
+    const int numCentre = (numVoices % 2 == 1) ? 1 : std::min(2, numVoices);
+    const int numSides = numVoices - numCentre;
+
+    // 7 voices at mix 0.5 give the classic 0.3 centre / 0.15 side balance
+    const float centreGain = numSides > 0 ? 0.6f * (1.0f - m_mix) / static_cast<float>(numCentre)
+                                          : 1.0f / static_cast<float>(numCentre);
+    const float sideGain = numSides > 0 ? 1.8f * m_mix / static_cast<float>(numSides) : 0.0f;
+
+    for (int v = 0; v < PADDED_VOICES; ++v)
+    {
+        if (v >= numVoices)
+        {
+            // Padding lanes run but stay silent
+            m_ratios[v] = 1.0f;
+            m_inverseRatios[v] = 1.0f;
+            m_gainsLeft[v] = m_gainsRight[v] = m_gainsMono[v] = 0.0f;
+            continue;
+        }
+
+        // Position in the stack, -1 (lowest) to +1 (highest)
+        const float x = numVoices > 1 ? 2.0f * static_cast<float>(v) / static_cast<float>(numVoices - 1) - 1.0f : 0.0f;
+
+        // Detune grows faster towards the outer voices (|x|^1.5)
+        const float offset = std::copysign(std::pow(std::abs(x), 1.5f), x) * m_detune * MAX_DETUNE;
+        m_ratios[v] = 1.0f + offset;
+        m_inverseRatios[v] = 1.0f / m_ratios[v];
+
+        const bool isCentre = numCentre == 1 ? v == numVoices / 2
+                                             : (v == numVoices / 2 - 1 || v == numVoices / 2);
+        const float gain = isCentre ? centreGain : sideGain;
+
+        // Balance-law pan: centred voices keep full level on both sides
+        const float pan = m_spread * x;
+        m_gainsLeft[v] = gain * std::min(1.0f, 1.0f - pan);
+        m_gainsRight[v] = gain * std::min(1.0f, 1.0f + pan);
+        m_gainsMono[v] = 0.5f * (m_gainsLeft[v] + m_gainsRight[v]);
+    }
+}
+
+void SuperSaw::render(const float* phaseIncrements, float* left, float* right, int numSamples) noexcept
+{
+    if (right != nullptr)
+        renderVoices<true>(phaseIncrements, left, right, numSamples);
+    else
+        renderVoices<false>(phaseIncrements, left, nullptr, numSamples);
+}
+
+template <bool Stereo>
+void SuperSaw::renderVoices(const float* phaseIncrements, float* left, float* right, int numSamples) noexcept
+{
+    const int numGroups = m_numGroups;
+    const Vec one = Vec::expand(1.0f);
+
+    // Load the stack into registers once per block
+    Vec phases[MAX_GROUPS], ratios[MAX_GROUPS], inverseRatios[MAX_GROUPS];
+    Vec gainsLeft[MAX_GROUPS], gainsRight[MAX_GROUPS];
+
+    for (int g = 0; g < numGroups; ++g)
+    {
+        phases[g] = Vec::fromRawArray(m_phases + g * LANES);
+        ratios[g] = Vec::fromRawArray(m_ratios + g * LANES);
+        inverseRatios[g] = Vec::fromRawArray(m_inverseRatios + g * LANES);
+        gainsLeft[g] = Vec::fromRawArray((Stereo ? m_gainsLeft : m_gainsMono) + g * LANES);
+        gainsRight[g] = Vec::fromRawArray(m_gainsRight + g * LANES);
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float increment = phaseIncrements[i];
+        const float inverseIncrement = 1.0f / std::max(increment, 1.0e-9f);
+
+        Vec sumLeft = Vec::expand(0.0f);
+        Vec sumRight = Vec::expand(0.0f);
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            const Vec dt = ratios[g] * increment;
+            Vec phase = phases[g] + dt;
+            phase -= one & Vec::greaterThanOrEqual(phase, one);
+            phases[g] = phase;
+
+            const Vec saw = phase + phase - one - polyBLEP(phase, dt, inverseRatios[g] * inverseIncrement);
+
+            sumLeft += saw * gainsLeft[g];
+            if constexpr (Stereo)
+                sumRight += saw * gainsRight[g];
+        }
+
+        left[i] = sumLeft.sum();
+        if constexpr (Stereo)
+            right[i] = sumRight.sum();
+    }
+
+    for (int g = 0; g < numGroups; ++g)
+        phases[g].copyToRawArray(m_phases + g * LANES);
+}
+
+SuperSaw::Vec SuperSaw::polyBLEP(Vec t, Vec dt, Vec inverseDt) noexcept
+{
+    const Vec one = Vec::expand(1.0f);
+
+    // Just after the wrap: 2x - x^2 - 1 with x = t / dt
+    const Vec x = t * inverseDt;
+    const Vec start = (x + x - x * x - one) & Vec::lessThan(t, dt);
+
+    // Just before the wrap: y^2 + 2y + 1 with y = (t - 1) / dt
+    const Vec y = (t - one) * inverseDt;
+    const Vec end = (y * y + y + y + one) & Vec::greaterThan(t, one - dt);
+
+    return start + end;
+}
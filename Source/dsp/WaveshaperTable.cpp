@@ -0,0 +1,186 @@
+#include "WaveshaperTable.h"
+#include <algorithm>
+#include <cstring>
+
+// === BUILDER ===
+
+WaveshaperBuilder::WaveshaperBuilder(BuildFunction build)
+    : juce::Thread("Waveshaper tables"),
+      m_build(build)
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+WaveshaperBuilder::~WaveshaperBuilder()
+{
+    jassert(m_tables.empty());
+
+    signalThreadShouldExit();
+    m_semaphore.post();
+    stopThread(1000);
+}
+
+void WaveshaperBuilder::attach(WaveshaperTables& tables)
+{
+    const juce::ScopedLock lock(m_lock);
+    m_tables.push_back(&tables);
+}
+
+void WaveshaperBuilder::detach(WaveshaperTables& tables)
+{
+    const juce::ScopedLock lock(m_lock);
+    m_tables.erase(std::remove(m_tables.begin(), m_tables.end(), &tables), m_tables.end());
+}
+
+void WaveshaperBuilder::make(WaveshaperTable& table, int mode, float drive, uint64_t key)
+{
+    if (m_hasLastBuilt && key == m_lastBuiltKey)
+    {
+        table = m_lastBuilt;
+        return;
+    }
+
+    m_build(table, mode, drive);
+
+    m_lastBuilt = table;
+    m_lastBuiltKey = key;
+    m_hasLastBuilt = true;
+}
+
+void WaveshaperBuilder::run()
+{
+    while (!threadShouldExit())
+    {
+        // Until request() or update() has something new
+        m_semaphore.wait();
+
+        if (threadShouldExit())
+            break;
+
+        const juce::ScopedLock lock(m_lock);
+        for (auto* tables : m_tables)
+            tables->buildPending(*this);
+    }
+}
+
+// === TABLES ===
+
+WaveshaperTables::WaveshaperTables(WaveshaperBuilder::BuildFunction build)
+    : m_build(build)
+{
+}
+
+WaveshaperTables::~WaveshaperTables()
+{
+    if (m_attached)
+        m_builder->detach(*this);
+}
+
+void WaveshaperTables::setBuilder(std::shared_ptr<WaveshaperBuilder> builder)
+{
+    jassert(!m_attached);
+    jassert(builder == nullptr || builder->getBuildFunction() == m_build);
+
+    m_builder = std::move(builder);
+}
+
+void WaveshaperTables::prepare(double sampleRate, int mode, float drive)
+{
+    setSampleRate(sampleRate);
+    m_crossfadeRemaining = 0;
+
+    if (m_attached)
+    {
+        request(mode, drive);
+        return;
+    }
+
+    m_build(m_slots[0], mode, drive);
+
+    m_builtKey = makeKey(mode, drive);
+    m_requestedKey.store(m_builtKey);
+    m_activeSlot.store(0);
+    m_fadingSlot.store(-1);
+    m_readySlot.store(-1);
+
+    if (m_builder == nullptr)
+        m_builder = std::make_shared<WaveshaperBuilder>(m_build);
+
+    m_builder->attach(*this);
+    m_attached = true;
+}
+
+void WaveshaperTables::setSampleRate(double sampleRate) noexcept
+{
+    const int length = std::max(1, static_cast<int>(CROSSFADE_TIME * sampleRate));
+    m_crossfadeRemaining = static_cast<int>(static_cast<int64_t>(m_crossfadeRemaining) * length / m_crossfadeLength);
+    m_crossfadeLength = length;
+    m_inverseCrossfadeLength = 1.0f / static_cast<float>(m_crossfadeLength);
+}
+
+void WaveshaperTables::request(int mode, float drive) noexcept
+{
+    // Called every block - the worker is only woken when the curve changes
+    const uint64_t key = makeKey(mode, drive);
+    if (m_requestedKey.exchange(key, std::memory_order_acq_rel) != key && m_attached)
+        m_builder->post();
+}
+
+bool WaveshaperTables::update() noexcept
+{
+    if (m_crossfadeRemaining > 0)
+        return false;
+
+    // The previous crossfade has finished - its table is free again
+    m_fadingSlot.store(-1, std::memory_order_relaxed);
+
+    const int ready = m_readySlot.load(std::memory_order_acquire);
+    if (ready < 0)
+        return false;
+
+    // Publish the new slot roles before handing the ready slot back to the worker
+    m_fadingSlot.store(m_activeSlot.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_activeSlot.store(ready, std::memory_order_relaxed);
+    m_readySlot.store(-1, std::memory_order_release);
+
+    // A request that arrived while this table waited could not be built yet
+    const auto& adopted = m_slots[static_cast<size_t>(ready)];
+    if (m_requestedKey.load(std::memory_order_acquire) != makeKey(adopted.getMode(), adopted.getDrive()))
+        m_builder->post();
+
+    m_crossfadeRemaining = m_crossfadeLength;
+    return true;
+}
+
+void WaveshaperTables::buildPending(WaveshaperBuilder& builder)
+{
+    const uint64_t key = m_requestedKey.load(std::memory_order_acquire);
+
+    // Build only once the previous result has been adopted; with three slots
+    // one is then always free. A request made meanwhile posts another pass.
+    if (key == m_builtKey || m_readySlot.load(std::memory_order_acquire) >= 0)
+        return;
+
+    const int active = m_activeSlot.load(std::memory_order_relaxed);
+    const int fading = m_fadingSlot.load(std::memory_order_relaxed);
+
+    int slot = 0;
+    while (slot == active || slot == fading)
+        ++slot;
+
+    const int mode = static_cast<int>(key >> 32);
+    const auto driveBits = static_cast<uint32_t>(key & 0xffffffffu);
+    float drive;
+    std::memcpy(&drive, &driveBits, sizeof(drive));
+
+    builder.make(m_slots[static_cast<size_t>(slot)], mode, drive, key);
+    m_builtKey = key;
+    m_readySlot.store(slot, std::memory_order_release);
+}
+
+uint64_t WaveshaperTables::makeKey(int mode, float drive) noexcept
+{
+    uint32_t driveBits;
+    std::memcpy(&driveBits, &drive, sizeof(driveBits));
+    return (static_cast<uint64_t>(static_cast<uint32_t>(mode)) << 32) | driveBits;
+}
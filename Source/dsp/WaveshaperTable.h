@@ -0,0 +1,290 @@
+#pragma once
+
+#include "../core/Semaphore.h"
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * One waveshaper transfer curve baked into lookup tables
+ *
+ * The curve is sampled over the input range with drive, input and output gain
+ * folded in, together with its first and second antiderivatives, so the audio
+ * thread only does interpolated reads:
+ *
+ *   f   linear interpolation of a float table (plain shaping)
+ *   F1  cubic Hermite on a double table, with f as the slope (1st-order ADAA)
+ *   F2  cubic Hermite on a double table, with F1 as the slope (2nd-order ADAA)
+ *
+ * Outside the range the curve continues along its end slope. A table exposes
+ * the same f/F1/F2 interface as the curves in Antiderivative.h, so
+ * Antiderivative::State runs on it directly.
+ */
+class WaveshaperTable {
+public:
+    static constexpr int TABLE_SIZE = 8192;              // Intervals across the input range
+    static constexpr float INPUT_RANGE = 4.0f;           // Tables cover -4 .. +4
+
+    /**
+     * Bakes Curve::f(x * inputGain) * outputGain and its antiderivatives (in x).
+     * Allocates on the first build only.
+     */
+    template <typename Curve>
+    void build(int mode, float drive, float inputGain, float outputGain);
+
+    int getMode() const noexcept { return m_mode; }
+    float getDrive() const noexcept { return m_drive; }
+
+    /** Branch-free gather: the input is clamped into the table and the excess continues along the end slope. */
+    float f(float x) const noexcept
+    {
+        const float clamped = std::max(-INPUT_RANGE, std::min(INPUT_RANGE, x));
+        const float excess = x - clamped;
+
+        const float position = (clamped + INPUT_RANGE) * SCALE;
+        const int k = std::min(static_cast<int>(position), TABLE_SIZE - 1);
+        const float frac = position - static_cast<float>(k);
+
+        const float* values = m_values.data();
+        return values[k] + frac * (values[k + 1] - values[k])
+             + excess * (x < 0.0f ? m_lowSlope : m_highSlope);
+    }
+
+    /** Plain shaping of a block - a gather loop with no per-sample curve maths. */
+    void process(const float* input, float* output, int numSamples) const noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = f(input[i]);
+    }
+
+    double F1(double x) const noexcept
+    {
+        if (x <= -INPUT_RANGE || x >= INPUT_RANGE)
+            return getEnd(x).extrapolate1(x);
+
+        return hermite(m_integral.data(), m_values.data(), x);
+    }
+
+    double F2(double x) const noexcept
+    {
+        if (x <= -INPUT_RANGE || x >= INPUT_RANGE)
+            return getEnd(x).extrapolate2(x);
+
+        return hermite(m_secondIntegral.data(), m_integral.data(), x);
+    }
+
+private:
+    static constexpr float SCALE = TABLE_SIZE / (2.0f * INPUT_RANGE);    // Table steps per unit input
+    static constexpr double STEP = 2.0 * INPUT_RANGE / TABLE_SIZE;
+
+    // Curve state at one end of the range, continued with its end slope
+    struct End
+    {
+        double x = 0.0, f = 0.0, slope = 0.0, F1 = 0.0, F2 = 0.0;
+
+        double extrapolate1(double at) const noexcept { const double d = at - x; return F1 + d * (f + 0.5 * slope * d); }
+        double extrapolate2(double at) const noexcept
+        {
+            const double d = at - x;
+            return F2 + d * (F1 + d * (0.5 * f + slope * d / 6.0));
+        }
+    };
+
+    const End& getEnd(double x) const noexcept { return x < 0.0 ? m_lowEnd : m_highEnd; }
+
+    template <typename Slope>
+    static double hermite(const double* values, const Slope* slopes, double x) noexcept
+    {
+        const double position = (x + INPUT_RANGE) * SCALE;
+        const int k = static_cast<int>(position);
+        const double t = position - k;
+
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        return (2.0 * t3 - 3.0 * t2 + 1.0) * values[k] + (t3 - 2.0 * t2 + t) * slopes[k] * STEP
+             + (-2.0 * t3 + 3.0 * t2) * values[k + 1] + (t3 - t2) * slopes[k + 1] * STEP;
+    }
+
+    std::vector<float> m_values;            // f at TABLE_SIZE + 1 nodes
+    std::vector<double> m_integral;         // F1 at the nodes
+    std::vector<double> m_secondIntegral;   // F2 at the nodes
+    End m_lowEnd, m_highEnd;
+    float m_lowSlope = 0.0f;
+    float m_highSlope = 0.0f;
+
+    int m_mode = -1;
+    float m_drive = 0.0f;
+};
+
+template <typename Curve>
+void WaveshaperTable::build(int mode, float drive, float inputGain, float outputGain)
+{
+    m_values.resize(TABLE_SIZE + 1);
+    m_integral.resize(TABLE_SIZE + 1);
+    m_secondIntegral.resize(TABLE_SIZE + 1);
+
+    // Antiderivatives in x: F1(g x) / g and F2(g x) / g^2
+    const double g = inputGain;
+    const double out = outputGain;
+
+    for (int k = 0; k <= TABLE_SIZE; ++k)
+    {
+        const double x = -INPUT_RANGE + k * STEP;
+        m_values[static_cast<size_t>(k)] = static_cast<float>(out * Curve::f(g * x));
+        m_integral[static_cast<size_t>(k)] = out * Curve::F1(g * x) / g;
+        m_secondIntegral[static_cast<size_t>(k)] = out * Curve::F2(g * x) / (g * g);
+    }
+
+    const auto makeEnd = [&](double x, double inward)
+    {
+        End end;
+        end.x = x;
+        end.f = out * Curve::f(g * x);
+        end.slope = (end.f - out * Curve::f(g * (x + inward))) / -inward;
+        end.F1 = out * Curve::F1(g * x) / g;
+        end.F2 = out * Curve::F2(g * x) / (g * g);
+        return end;
+    };
+
+    m_lowEnd = makeEnd(-INPUT_RANGE, 1.0e-3);
+    m_highEnd = makeEnd(INPUT_RANGE, -1.0e-3);
+    m_lowSlope = static_cast<float>(m_lowEnd.slope);
+    m_highSlope = static_cast<float>(m_highEnd.slope);
+
+    m_mode = mode;
+    m_drive = drive;
+}
+
+class WaveshaperTables;
+
+/**
+ * Background thread building waveshaper tables for any number of
+ * WaveshaperTables sets, e.g. one per channel
+ *
+ * It sleeps on a Semaphore the audio thread posts without taking a lock. The
+ * last table built is kept, so sets that ask for the same curve (the channels
+ * of one overdrive) get a copy rather than a second build.
+ */
+class WaveshaperBuilder : private juce::Thread {
+public:
+    using BuildFunction = void (*)(WaveshaperTable& table, int mode, float drive);
+
+    explicit WaveshaperBuilder(BuildFunction build);
+    ~WaveshaperBuilder() override;
+
+    BuildFunction getBuildFunction() const noexcept { return m_build; }
+
+private:
+    friend class WaveshaperTables;
+
+    // detach() waits out a pass in progress
+    void attach(WaveshaperTables& tables);
+    void detach(WaveshaperTables& tables);
+
+    /** Audio thread: wakes the builder. */
+    void post() noexcept { m_semaphore.post(); }
+
+    // Builder thread: the curve for key, copied from the last build if it matches
+    void make(WaveshaperTable& table, int mode, float drive, uint64_t key);
+
+    void run() override;
+
+    BuildFunction m_build;
+
+    juce::CriticalSection m_lock;           // Guards m_tables, held for each pass over them
+    std::vector<WaveshaperTables*> m_tables;
+    Semaphore m_semaphore;
+
+    WaveshaperTable m_lastBuilt;            // Builder thread only
+    uint64_t m_lastBuiltKey = 0;
+    bool m_hasLastBuilt = false;
+
+    JUCE_DECLARE_NON_COPYABLE (WaveshaperBuilder)
+};
+
+/**
+ * Triple-buffered set of waveshaper tables rebuilt on a background thread
+ *
+ * The audio thread requests a (mode, drive) curve and, once per block, adopts
+ * the latest finished table with a short crossfade from the previous one. The
+ * builder thread fills whichever of the three slots is neither playing nor
+ * fading, so neither side ever waits for the other. The builder is only woken
+ * for a new request (or a finished table being adopted while another request
+ * is queued), so a steady drive costs no wakeups:
+ *
+ *   active  - read by the audio thread
+ *   fading  - the previous table, read until the crossfade ends
+ *   ready   - finished by the builder, waiting to be adopted
+ */
+class WaveshaperTables {
+public:
+    explicit WaveshaperTables(WaveshaperBuilder::BuildFunction build);
+    ~WaveshaperTables();
+
+    /**
+     * Before the first prepare(): builds on a thread shared with other sets of
+     * the same build function. Without one, prepare() starts a private builder.
+     */
+    void setBuilder(std::shared_ptr<WaveshaperBuilder> builder);
+
+    /**
+     * The first call builds the initial table synchronously and attaches to the
+     * builder. Tables do not depend on the sample rate, so later calls (e.g. when
+     * the oversampling factor changes on the audio thread) only set the crossfade length.
+     */
+    void prepare(double sampleRate, int mode, float drive);
+
+    /** Audio thread: rescales the crossfade length, keeping the tables and any fade in progress. */
+    void setSampleRate(double sampleRate) noexcept;
+
+    /** Audio thread: asks for a curve. The builder sleeps until the request changes. */
+    void request(int mode, float drive) noexcept;
+
+    /** Audio thread, once per block: adopts a finished table. Returns true when a crossfade starts. */
+    bool update() noexcept;
+
+    const WaveshaperTable& getActive() const noexcept { return m_slots[static_cast<size_t>(m_activeSlot.load(std::memory_order_relaxed))]; }
+    const WaveshaperTable& getFading() const noexcept { return m_slots[static_cast<size_t>(m_fadingSlot.load(std::memory_order_relaxed))]; }
+    bool isCrossfading() const noexcept { return m_crossfadeRemaining > 0; }
+
+    /** Gain of the active table for the next sample of a crossfade (0 -> 1). */
+    float nextCrossfadeGain() noexcept
+    {
+        if (m_crossfadeRemaining <= 0)
+            return 1.0f;
+
+        --m_crossfadeRemaining;
+        return 1.0f - static_cast<float>(m_crossfadeRemaining) * m_inverseCrossfadeLength;
+    }
+
+    static constexpr float CROSSFADE_TIME = 0.005f;     // 5ms
+
+private:
+    friend class WaveshaperBuilder;
+
+    // Builder thread: builds the requested curve once the previous one has been adopted
+    void buildPending(WaveshaperBuilder& builder);
+
+    static uint64_t makeKey(int mode, float drive) noexcept;
+
+    WaveshaperBuilder::BuildFunction m_build;
+    std::shared_ptr<WaveshaperBuilder> m_builder;
+    bool m_attached = false;
+    std::array<WaveshaperTable, 3> m_slots;
+
+    std::atomic<int> m_activeSlot{0};
+    std::atomic<int> m_fadingSlot{-1};
+    std::atomic<int> m_readySlot{-1};
+    std::atomic<uint64_t> m_requestedKey{0};
+    uint64_t m_builtKey = 0;                // Builder thread only
+
+    int m_crossfadeLength = 1;
+    float m_inverseCrossfadeLength = 1.0f;
+    int m_crossfadeRemaining = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (WaveshaperTables)
+};
@@ -0,0 +1,142 @@
+#include "Wavetable.h"
+#include <juce_dsp/juce_dsp.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Naive shapes are analysed at this resolution so harmonics up to
+    // MAX_HARMONICS are measured with negligible aliasing
+    constexpr int ANALYSIS_ORDER = 14;
+    constexpr int ANALYSIS_SIZE = 1 << ANALYSIS_ORDER;
+    constexpr int TABLE_ORDER = 12;
+
+    static_assert((1 << TABLE_ORDER) == WavetableBank::TABLE_SIZE, "TABLE_ORDER must match TABLE_SIZE");
+    static_assert((WavetableBank::MAX_HARMONICS >> (WavetableBank::NUM_LEVELS - 1)) == 1, "Last level must hold the fundamental only");
+
+    constexpr float TWO_PI = 6.283185307179586f;
+
+    // Fixed generator settings baked into the SyncSaw and FM tables
+    constexpr float SYNC_RATIO = 2.5f;
+    constexpr float FM_RATIO = 2.0f;
+    constexpr float FM_INDEX = 3.0f;
+
+    float naiveSaw(float phase) { return 2.0f * phase - 1.0f; }
+    float naivePulse(float phase, float width) { return phase < width ? 1.0f : -1.0f; }
+    float naiveTriangle(float phase) { return phase < 0.5f ? 4.0f * phase - 1.0f : 3.0f - 4.0f * phase; }
+}
+
+const WavetableBank& WavetableBank::getInstance()
+{
+    static const WavetableBank bank;
+    return bank;
+}
+
+WavetableBank::WavetableBank()
+{
+    m_tables.assign(static_cast<size_t>(NUM_SHAPES) * NUM_LEVELS * (TABLE_SIZE + 1), 0.0f);
+
+    for (int shape = 0; shape < NUM_SHAPES; ++shape)
+        buildShape(static_cast<Shape>(shape));
+}
+
+void WavetableBank::buildShape(Shape shape)
+{
+    juce::dsp::FFT analysis(ANALYSIS_ORDER);
+    juce::dsp::FFT synthesis(TABLE_ORDER);
+
+    // Measure the harmonics of the naive waveform
+    std::vector<float> spectrum(2 * ANALYSIS_SIZE, 0.0f);
+    for (int i = 0; i < ANALYSIS_SIZE; ++i)
+        spectrum[static_cast<size_t>(i)] = evaluateNaive(shape, static_cast<float>(i) / static_cast<float>(ANALYSIS_SIZE));
+
+    analysis.performRealOnlyForwardTransform(spectrum.data(), true);
+
+    // Rescale bins so the inverse transform at TABLE_SIZE restores the amplitude
+    const float binScale = static_cast<float>(TABLE_SIZE) / static_cast<float>(ANALYSIS_SIZE);
+
+    std::vector<float> level(2 * TABLE_SIZE);
+    float peak = 0.0f;
+
+    for (int lvl = 0; lvl < NUM_LEVELS; ++lvl)
+    {
+        const int numHarmonics = MAX_HARMONICS >> lvl;
+
+        // Keep DC and harmonics 1..numHarmonics, drop everything above
+        std::fill(level.begin(), level.end(), 0.0f);
+        for (int k = 0; k <= numHarmonics; ++k)
+        {
+            level[static_cast<size_t>(2 * k)] = spectrum[static_cast<size_t>(2 * k)] * binScale;
+            level[static_cast<size_t>(2 * k + 1)] = spectrum[static_cast<size_t>(2 * k + 1)] * binScale;
+        }
+
+        synthesis.performRealOnlyInverseTransform(level.data());
+
+        float* table = m_tables.data() + (static_cast<size_t>(shape) * NUM_LEVELS + static_cast<size_t>(lvl)) * (TABLE_SIZE + 1);
+        std::copy(level.begin(), level.begin() + TABLE_SIZE, table);
+        table[TABLE_SIZE] = table[0];   // Guard sample for interpolation
+
+        for (int i = 0; i < TABLE_SIZE; ++i)
+            peak = std::max(peak, std::abs(table[i]));
+    }
+
+    // Scale all levels by the same amount so Gibbs overshoot stays within +-1
+    // without changing loudness between levels
+    if (peak > 1.0f)
+    {
+        const float gain = 1.0f / peak;
+        float* shapeTables = m_tables.data() + static_cast<size_t>(shape) * NUM_LEVELS * (TABLE_SIZE + 1);
+        std::transform(shapeTables, shapeTables + NUM_LEVELS * (TABLE_SIZE + 1), shapeTables,
+                       [gain](float x) { return x * gain; });
+    }
+}
+
+float WavetableBank::evaluateNaive(Shape shape, float phase)
+{
+    switch (shape)
+    {
+        case Shape::Sawtooth:  return naiveSaw(phase);
+        case Shape::Square:    return naivePulse(phase, 0.5f);
+        case Shape::Triangle:  return naiveTriangle(phase);
+        case Shape::Sine:      return std::sin(phase * TWO_PI);
+        case Shape::Pulse25:   return naivePulse(phase, 0.25f);
+        case Shape::Pulse12:   return naivePulse(phase, 0.125f);
+        case Shape::SawSquare: return (naiveSaw(phase) + naivePulse(phase, 0.5f)) * 0.5f;
+        case Shape::TriSaw:    return (naiveSaw(phase) + naiveTriangle(phase)) * 0.5f;
+        case Shape::SyncSaw:
+        {
+            // Slave restarts with every master cycle
+            const float slavePhase = phase * SYNC_RATIO;
+            return naiveSaw(slavePhase - std::floor(slavePhase));
+        }
+        case Shape::FM:
+        {
+            const float modulator = std::sin(phase * FM_RATIO * TWO_PI);
+            return std::sin((phase + modulator * FM_INDEX * 0.1f) * TWO_PI);
+        }
+        case Shape::NumShapes:
+        default:
+            break;
+    }
+
+    return 0.0f;
+}
+
+int WavetableBank::getLevelForIncrement(float phaseIncrement) noexcept
+{
+    // Level L holds MAX_HARMONICS >> L harmonics; the highest must stay below 0.5 cycles/sample
+    int level = 0;
+    while (level < NUM_LEVELS - 1 && static_cast<float>(MAX_HARMONICS >> level) * phaseIncrement > 0.5f)
+        ++level;
+    return level;
+}
+
+float WavetableBank::getMinIncrement(int level) noexcept
+{
+    return level == 0 ? 0.0f : 0.5f / static_cast<float>(MAX_HARMONICS >> (level - 1));
+}
+
+float WavetableBank::getMaxIncrement(int level) noexcept
+{
+    return level == NUM_LEVELS - 1 ? 1.0f : 0.5f / static_cast<float>(MAX_HARMONICS >> level);
+}
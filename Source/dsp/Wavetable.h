@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Band-limited, mip-mapped single-cycle wavetables for the oscillator
+ *
+ * Each shape is sampled at high resolution, transformed with juce::dsp::FFT and
+ * resynthesised into octave-spaced levels: level 0 holds MAX_HARMONICS
+ * harmonics, every following level half as many. A level is safe to play as
+ * long as its highest harmonic stays below Nyquist, so the oscillator picks the
+ * lowest safe level for its current phase increment.
+ *
+ * The tables do not depend on the sample rate, so one read-only bank is built
+ * on first use and shared by every oscillator instance.
+ */
+class WavetableBank {
+public:
+    enum class Shape {
+        Sawtooth = 0,
+        Square,
+        Triangle,
+        Sine,
+        Pulse25,
+        Pulse12,
+        SawSquare,
+        TriSaw,
+        SyncSaw,      // Hard-synced saw at a fixed 2.5 ratio
+        FM,           // 2:1 sine FM at a fixed index
+        NumShapes
+    };
+
+    static constexpr int TABLE_SIZE = 4096;                    // Samples per cycle
+    static constexpr int MAX_HARMONICS = TABLE_SIZE / 4;       // Level 0 (2x oversampled for interpolation)
+    static constexpr int NUM_LEVELS = 11;                      // 1024 harmonics down to 1
+    static constexpr int NUM_SHAPES = static_cast<int>(Shape::NumShapes);
+
+    /** Returns the shared bank, building it on first call (call from prepare()). */
+    static const WavetableBank& getInstance();
+
+    /** Returns TABLE_SIZE samples plus one guard sample for interpolation. */
+    const float* getTable(Shape shape, int level) const noexcept
+    {
+        return m_tables.data() + (static_cast<size_t>(shape) * NUM_LEVELS + static_cast<size_t>(level)) * (TABLE_SIZE + 1);
+    }
+
+    /** Returns the lowest level whose harmonics all stay below Nyquist. */
+    static int getLevelForIncrement(float phaseIncrement) noexcept;
+
+    /** Phase increment range [min, max) served by a level. */
+    static float getMinIncrement(int level) noexcept;
+    static float getMaxIncrement(int level) noexcept;
+
+    /** Reads a table at phase 0..1 with linear interpolation. */
+    static float read(const float* table, float phase) noexcept
+    {
+        const float position = phase * static_cast<float>(TABLE_SIZE);
+        const int index = static_cast<int>(position);
+        const float frac = position - static_cast<float>(index);
+        return table[index] + frac * (table[index + 1] - table[index]);
+    }
+
+private:
+    WavetableBank();
+
+    void buildShape(Shape shape);
+    static float evaluateNaive(Shape shape, float phase);
+
+    std::vector<float> m_tables;
+};
@@ -0,0 +1,307 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+// Include arpeggiator
+#include "dsp/Arpeggiator.h"
+#include "core/HeldNoteSet.h"
+
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr double BPM = 120.0;
+constexpr double SAMPLES_PER_BEAT = SAMPLE_RATE * 60.0 / BPM;
+constexpr int BUFFER_SIZE = 480;
+
+using Event = Arpeggiator::Event;
+
+namespace {
+    struct TimedEvent {
+        Event event;
+        int64_t sample = 0;
+    };
+
+    /** Runs the arpeggiator over consecutive blocks and collects events at absolute sample positions. */
+    std::vector<TimedEvent> runBlocks(Arpeggiator& arp, int numBlocks, int blockSize, double startPpq = 0.0)
+    {
+        std::vector<TimedEvent> events;
+        int64_t position = 0;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const double ppq = startPpq + position / SAMPLES_PER_BEAT;
+            for (const auto& event : arp.process(BPM, ppq, blockSize))
+            {
+                REQUIRE(event.offset >= 0);
+                REQUIRE(event.offset < blockSize);
+                events.push_back({event, position + event.offset});
+            }
+
+            position += blockSize;
+        }
+
+        return events;
+    }
+
+    std::vector<int64_t> noteOnSamples(const std::vector<TimedEvent>& events)
+    {
+        std::vector<int64_t> samples;
+        for (const auto& timed : events)
+            if (timed.event.type == Event::Type::NoteOn)
+                samples.push_back(timed.sample);
+        return samples;
+    }
+
+    void configure(Arpeggiator& arp, Arpeggiator::Division division, float gate, float swing)
+    {
+        arp.prepare(SAMPLE_RATE);
+        arp.setEnabled(true);
+        arp.setDivision(division);
+        arp.setGate(gate);
+        arp.setSwing(swing);
+    }
+}
+
+TEST_CASE("Arpeggiator Event Scheduling", "[arpeggiator][events]") {
+    Arpeggiator arp;
+    configure(arp, Arpeggiator::Division::Sixteenth, 0.5f, 0.0f);
+
+    const int64_t step = static_cast<int64_t>(SAMPLES_PER_BEAT * 0.25);    // 6000 samples
+
+    SECTION("No events without held notes") {
+        REQUIRE(arp.process(BPM, 0.0, BUFFER_SIZE).empty());
+    }
+
+    SECTION("Steps land exactly on the ppq grid") {
+        arp.noteOn(60, 1.0f);
+        arp.noteOn(64, 1.0f);
+
+        const auto events = runBlocks(arp, 200, BUFFER_SIZE);
+        const auto starts = noteOnSamples(events);
+
+        REQUIRE(starts.size() == 16);
+        for (size_t i = 0; i < starts.size(); ++i)
+            REQUIRE(starts[i] == static_cast<int64_t>(i) * step);
+    }
+
+    SECTION("Gate-offs close each step after gate * step length") {
+        arp.noteOn(60, 1.0f);
+
+        const auto events = runBlocks(arp, 100, BUFFER_SIZE);
+
+        int64_t lastOn = -1;
+        int gateOffs = 0;
+        for (const auto& timed : events)
+        {
+            if (timed.event.type == Event::Type::NoteOn)
+            {
+                lastOn = timed.sample;
+            }
+            else
+            {
+                REQUIRE(timed.sample - lastOn == step / 2);
+                ++gateOffs;
+            }
+        }
+
+        REQUIRE(gateOffs > 0);
+    }
+
+    SECTION("Events alternate and carry the arpeggiated notes") {
+        arp.noteOn(60, 0.8f);
+        arp.noteOn(67, 0.8f);
+
+        const auto events = runBlocks(arp, 100, BUFFER_SIZE);
+
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            const auto expected = (i % 2 == 0) ? Event::Type::NoteOn : Event::Type::NoteOff;
+            REQUIRE(events[i].event.type == expected);
+        }
+
+        REQUIRE(events[0].event.note == 60);
+        REQUIRE(events[2].event.note == 67);
+        REQUIRE(events[0].event.velocity == 0.8f);
+    }
+
+    SECTION("Releasing every note closes the gate at the next block") {
+        arp.noteOn(60, 1.0f);
+        arp.setGate(1.0f);
+        REQUIRE(arp.process(BPM, 0.0, BUFFER_SIZE).size() == 1);
+
+        arp.noteOff(60);
+        const auto& events = arp.process(BPM, BUFFER_SIZE / SAMPLES_PER_BEAT, BUFFER_SIZE);
+
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].type == Event::Type::NoteOff);
+        REQUIRE(events[0].offset == 0);
+    }
+}
+
+TEST_CASE("Arpeggiator Timing Accuracy", "[arpeggiator][timing]") {
+    Arpeggiator arp;
+
+    SECTION("No drift over a long run with odd block sizes") {
+        // Triplet eighths don't divide the sample grid evenly
+        configure(arp, Arpeggiator::Division::TripletEighth, 0.5f, 0.0f);
+        arp.noteOn(60, 1.0f);
+
+        const auto starts = noteOnSamples(runBlocks(arp, 20000, 127));
+        const double stepSamples = SAMPLES_PER_BEAT / 3.0;
+
+        REQUIRE(starts.size() > 300);
+        for (size_t i = 0; i < starts.size(); ++i)
+            REQUIRE(starts[i] == static_cast<int64_t>(std::ceil(i * stepSamples - 1.0e-6)));
+    }
+
+    SECTION("Block size does not change the schedule") {
+        configure(arp, Arpeggiator::Division::Sixteenth, 0.3f, 0.4f);
+        arp.noteOn(60, 1.0f);
+        const auto large = runBlocks(arp, 20, 4096);
+
+        Arpeggiator other;
+        configure(other, Arpeggiator::Division::Sixteenth, 0.3f, 0.4f);
+        other.noteOn(60, 1.0f);
+        const auto small = runBlocks(other, 4096 * 20 / 64, 64);
+
+        REQUIRE(large.size() == small.size());
+        for (size_t i = 0; i < large.size(); ++i)
+        {
+            REQUIRE(large[i].sample == small[i].sample);
+            REQUIRE(large[i].event.type == small[i].event.type);
+        }
+    }
+
+    SECTION("Swing delays odd steps") {
+        configure(arp, Arpeggiator::Division::Eighth, 0.5f, 1.0f);
+        arp.noteOn(60, 1.0f);
+
+        const auto starts = noteOnSamples(runBlocks(arp, 200, BUFFER_SIZE));
+        const auto step = static_cast<int64_t>(SAMPLES_PER_BEAT * 0.5);
+
+        REQUIRE(starts.size() >= 8);
+        for (size_t i = 0; i < 8; ++i)
+        {
+            const int64_t swing = (i % 2 == 1) ? step / 2 : 0;
+            REQUIRE(starts[i] == static_cast<int64_t>(i) * step + swing);
+        }
+    }
+
+    SECTION("First note starts immediately, then follows the grid") {
+        configure(arp, Arpeggiator::Division::Quarter, 0.5f, 0.0f);
+        arp.noteOn(60, 1.0f);
+
+        // Start a third of the way into a beat
+        const auto starts = noteOnSamples(runBlocks(arp, 200, BUFFER_SIZE, 10.0 + 1.0 / 3.0));
+
+        REQUIRE(starts.size() >= 2);
+        REQUIRE(starts[0] == 0);
+        REQUIRE(starts[1] == static_cast<int64_t>(std::ceil(SAMPLES_PER_BEAT * 2.0 / 3.0 - 1.0e-6)));
+    }
+
+    SECTION("Resyncs when the transport jumps") {
+        configure(arp, Arpeggiator::Division::Quarter, 0.5f, 0.0f);
+        arp.noteOn(60, 1.0f);
+        runBlocks(arp, 10, BUFFER_SIZE, 0.0);
+
+        // Loop back to bar 1, half a beat before a step
+        std::vector<int> starts;
+        for (const auto& event : arp.process(BPM, 3.5, static_cast<int>(SAMPLES_PER_BEAT)))
+            if (event.type == Event::Type::NoteOn)
+                starts.push_back(event.offset);
+
+        REQUIRE(starts.size() == 1);
+        REQUIRE(starts[0] == static_cast<int>(SAMPLES_PER_BEAT / 2));
+    }
+}
+
+TEST_CASE("HeldNoteSet", "[arpeggiator][notes]") {
+    HeldNoteSet notes;
+
+    SECTION("Insert, update and remove") {
+        REQUIRE(notes.empty());
+        REQUIRE(notes.insert(60, 0.5f));
+        REQUIRE_FALSE(notes.insert(60, 0.9f));      // Already held - velocity updated
+
+        REQUIRE(notes.size() == 1);
+        REQUIRE(notes.contains(60));
+        REQUIRE(notes.getVelocity(60) == 0.9f);
+
+        REQUIRE(notes.remove(60));
+        REQUIRE_FALSE(notes.remove(60));
+        REQUIRE(notes.empty());
+        REQUIRE(notes.getVelocity(60) == 0.0f);
+    }
+
+    SECTION("Rejects notes outside the MIDI range") {
+        REQUIRE_FALSE(notes.insert(-1, 1.0f));
+        REQUIRE_FALSE(notes.insert(128, 1.0f));
+        REQUIRE(notes.empty());
+    }
+
+    SECTION("Sorted access spans both words") {
+        const int pressed[] = { 100, 3, 64, 63, 127, 0 };
+        for (int note : pressed)
+            notes.insert(note, 1.0f);
+
+        const int sorted[] = { 0, 3, 63, 64, 100, 127 };
+        for (int i = 0; i < 6; ++i)
+            REQUIRE(notes.getSorted(i) == sorted[i]);
+
+        std::vector<int> visited;
+        notes.forEachSorted([&](int note, float) { visited.push_back(note); });
+        REQUIRE(visited == std::vector<int>(std::begin(sorted), std::end(sorted)));
+    }
+
+    SECTION("Press order survives removals from anywhere") {
+        for (int note : { 50, 40, 60, 45, 55 })
+            notes.insert(note, 1.0f);
+
+        notes.remove(50);     // Oldest
+        notes.remove(45);     // Middle
+        notes.remove(55);     // Newest
+        notes.insert(70, 1.0f);
+
+        const int expected[] = { 40, 60, 70 };
+        REQUIRE(notes.size() == 3);
+        for (int i = 0; i < 3; ++i)
+            REQUIRE(notes.getInOrder(i) == expected[i]);
+    }
+
+    SECTION("Holds every MIDI note") {
+        for (int note = 127; note >= 0; --note)
+            REQUIRE(notes.insert(note, 1.0f));
+
+        REQUIRE(notes.size() == HeldNoteSet::NUM_NOTES);
+        for (int i = 0; i < HeldNoteSet::NUM_NOTES; ++i) {
+            REQUIRE(notes.getSorted(i) == i);
+            REQUIRE(notes.getInOrder(i) == 127 - i);
+        }
+    }
+}
+
+TEST_CASE("Arpeggiator Modes", "[arpeggiator][modes]") {
+    Arpeggiator arp;
+    configure(arp, Arpeggiator::Division::Sixteenth, 0.5f, 0.0f);
+
+    const auto playedNotes = [&](int count)
+    {
+        std::vector<int> notes;
+        for (const auto& timed : runBlocks(arp, 400, BUFFER_SIZE))
+            if (timed.event.type == Event::Type::NoteOn && static_cast<int>(notes.size()) < count)
+                notes.push_back(timed.event.note);
+        return notes;
+    };
+
+    arp.noteOn(67, 1.0f);
+    arp.noteOn(60, 1.0f);
+    arp.noteOn(64, 1.0f);
+
+    SECTION("Up plays held notes in pitch order") {
+        arp.setMode(Arpeggiator::Mode::Up);
+        REQUIRE(playedNotes(6) == std::vector<int>{ 60, 64, 67, 60, 64, 67 });
+    }
+
+    SECTION("Order plays held notes in press order") {
+        arp.setMode(Arpeggiator::Mode::Order);
+        REQUIRE(playedNotes(6) == std::vector<int>{ 67, 60, 64, 67, 60, 64 });
+    }
+}
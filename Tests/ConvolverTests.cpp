@@ -0,0 +1,275 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Include convolver
+#include "dsp/Convolver.h"
+
+using Catch::Matchers::WithinAbs;
+
+namespace {
+    juce::AudioBuffer<float> makeResponse(int numChannels, int length, unsigned seed)
+    {
+        // Decaying noise, like a room
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+
+        juce::AudioBuffer<float> response(numChannels, length);
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < length; ++i)
+                response.setSample(c, i, noise(random) * std::exp(-4.0f * static_cast<float>(i) / static_cast<float>(length)));
+
+        return response;
+    }
+
+    std::vector<float> makeInput(int length, unsigned seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+
+        std::vector<float> input(static_cast<size_t>(length));
+        for (auto& sample : input)
+            sample = noise(random);
+
+        return input;
+    }
+
+    /** Reference time-domain convolution of one response channel. */
+    std::vector<float> convolveDirect(const std::vector<float>& input, const juce::AudioBuffer<float>& response, int channel)
+    {
+        std::vector<float> output(input.size(), 0.0f);
+        const float* h = response.getReadPointer(channel);
+
+        for (size_t n = 0; n < input.size(); ++n)
+        {
+            double sum = 0.0;
+            const size_t taps = std::min(n + 1, static_cast<size_t>(response.getNumSamples()));
+            for (size_t k = 0; k < taps; ++k)
+                sum += static_cast<double>(h[k]) * input[n - k];
+            output[n] = static_cast<float>(sum);
+        }
+
+        return output;
+    }
+
+    /** Runs the convolver over the input in blocks of varying size. */
+    void render(Convolver& convolver, const std::vector<float>& input, std::vector<float>& left,
+                std::vector<float>* right, int blockSize)
+    {
+        left.assign(input.size(), 0.0f);
+        if (right != nullptr)
+            right->assign(input.size(), 0.0f);
+
+        const int length = static_cast<int>(input.size());
+        int block = 0;
+        for (int start = 0; start < length; ++block)
+        {
+            // Odd sizes so blocks straddle the partition boundaries
+            const int n = std::min(length - start, blockSize + (block % 3) * 37);
+            convolver.process(input.data() + start, left.data() + start,
+                              right != nullptr ? right->data() + start : nullptr, n);
+            start += n;
+        }
+    }
+}
+
+TEST_CASE("Convolver matches direct convolution", "[convolver]")
+{
+    const auto input = makeInput(12000, 1);
+
+    // Head only, head + mid, and head + mid + several tail partitions
+    for (int length : {40, 700, 2048, 6500})
+    {
+        for (bool useWorker : {false, true})
+        {
+            Convolver convolver(useWorker);
+            const auto response = makeResponse(1, length, static_cast<unsigned>(length));
+            convolver.setImpulseResponse(response);
+
+            std::vector<float> output;
+            render(convolver, input, output, nullptr, 256);
+
+            const auto expected = convolveDirect(input, response, 0);
+            for (size_t i = 0; i < output.size(); ++i)
+                REQUIRE_THAT(output[i], WithinAbs(expected[i], 2.0e-3));
+        }
+    }
+}
+
+TEST_CASE("Convolver does not depend on the worker keeping up", "[convolver]")
+{
+    // Blocks spanning several tail partitions make each job due before the
+    // worker can finish it, so they are cancelled and rendered inline
+    const auto input = makeInput(40000, 3);
+    const auto response = makeResponse(1, 9000, 4);
+
+    Convolver convolver(true);
+    convolver.setImpulseResponse(response);
+
+    std::vector<float> output;
+    render(convolver, input, output, nullptr, 8192);
+
+    const auto expected = convolveDirect(input, response, 0);
+    for (size_t i = 0; i < output.size(); ++i)
+        REQUIRE_THAT(output[i], WithinAbs(expected[i], 2.0e-3));
+
+    // A reset with a job in flight leaves nothing behind
+    convolver.reset();
+    const std::vector<float> silence(10000, 0.0f);
+    render(convolver, silence, output, nullptr, 64);
+
+    for (float sample : output)
+        REQUIRE(sample == 0.0f);
+}
+
+TEST_CASE("Convolvers share a response and a worker", "[convolver]")
+{
+    const auto response = makeResponse(1, 7000, 11);
+    const auto shared = Convolver::createResponse(response);
+    auto worker = std::make_shared<Convolver::Worker>();
+
+    Convolver first, second;
+    for (auto* convolver : { &first, &second })
+    {
+        convolver->setWorker(worker);
+        convolver->setImpulseResponse(shared);
+    }
+
+    // Interleaved, so both post jobs to the same thread
+    const auto firstInput = makeInput(20000, 12);
+    const auto secondInput = makeInput(20000, 13);
+    std::vector<float> firstOutput(firstInput.size()), secondOutput(secondInput.size());
+    for (size_t start = 0; start < firstInput.size(); start += 500)
+    {
+        const int n = static_cast<int>(std::min<size_t>(500, firstInput.size() - start));
+        first.process(firstInput.data() + start, firstOutput.data() + start, nullptr, n);
+        second.process(secondInput.data() + start, secondOutput.data() + start, nullptr, n);
+    }
+
+    const auto firstExpected = convolveDirect(firstInput, response, 0);
+    const auto secondExpected = convolveDirect(secondInput, response, 0);
+    for (size_t i = 0; i < firstOutput.size(); ++i)
+    {
+        REQUIRE_THAT(firstOutput[i], WithinAbs(firstExpected[i], 2.0e-3));
+        REQUIRE_THAT(secondOutput[i], WithinAbs(secondExpected[i], 2.0e-3));
+    }
+
+    // Unloading one leaves the other on the worker
+    first.setImpulseResponse(juce::AudioBuffer<float>());
+    REQUIRE_FALSE(first.hasImpulseResponse());
+    REQUIRE(second.getLength() == 7000);
+}
+
+TEST_CASE("Convolver has no latency", "[convolver]")
+{
+    Convolver convolver(false);
+    const auto response = makeResponse(1, 5000, 7);
+    convolver.setImpulseResponse(response);
+
+    std::vector<float> impulse(6000, 0.0f), output;
+    impulse[0] = 1.0f;
+    render(convolver, impulse, output, nullptr, 1);
+
+    for (int i = 0; i < response.getNumSamples(); ++i)
+        REQUIRE_THAT(output[static_cast<size_t>(i)], WithinAbs(response.getSample(0, i), 1.0e-4));
+
+    for (size_t i = static_cast<size_t>(response.getNumSamples()); i < output.size(); ++i)
+        REQUIRE_THAT(output[i], WithinAbs(0.0, 1.0e-4));
+}
+
+TEST_CASE("Convolver stereo responses", "[convolver]")
+{
+    const auto input = makeInput(8000, 3);
+    const auto response = makeResponse(2, 4000, 11);
+
+    Convolver convolver(true);
+    convolver.setImpulseResponse(response);
+
+    SECTION("Each channel has its own response")
+    {
+        std::vector<float> left, right;
+        render(convolver, input, left, &right, 512);
+
+        const auto expectedLeft = convolveDirect(input, response, 0);
+        const auto expectedRight = convolveDirect(input, response, 1);
+
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            REQUIRE_THAT(left[i], WithinAbs(expectedLeft[i], 2.0e-3));
+            REQUIRE_THAT(right[i], WithinAbs(expectedRight[i], 2.0e-3));
+        }
+    }
+
+    SECTION("Mono output is the downmix")
+    {
+        std::vector<float> mono;
+        render(convolver, input, mono, nullptr, 512);
+
+        const auto expectedLeft = convolveDirect(input, response, 0);
+        const auto expectedRight = convolveDirect(input, response, 1);
+
+        for (size_t i = 0; i < mono.size(); ++i)
+            REQUIRE_THAT(mono[i], WithinAbs(0.5f * (expectedLeft[i] + expectedRight[i]), 2.0e-3));
+    }
+}
+
+TEST_CASE("Convolver state", "[convolver]")
+{
+    Convolver convolver(true);
+
+    SECTION("Silent without a response")
+    {
+        const auto input = makeInput(1000, 5);
+        std::vector<float> output;
+        render(convolver, input, output, nullptr, 128);
+
+        REQUIRE_FALSE(convolver.hasImpulseResponse());
+        for (float sample : output)
+            REQUIRE(sample == 0.0f);
+    }
+
+    SECTION("Reset clears the tail")
+    {
+        convolver.setImpulseResponse(makeResponse(1, 5000, 9));
+        REQUIRE(convolver.getLength() == 5000);
+
+        std::vector<float> output;
+        render(convolver, makeInput(3000, 6), output, nullptr, 128);
+        convolver.reset();
+
+        const std::vector<float> silence(6000, 0.0f);
+        render(convolver, silence, output, nullptr, 128);
+
+        for (float sample : output)
+            REQUIRE(sample == 0.0f);
+    }
+
+    SECTION("Input after a reset convolves as if from the start")
+    {
+        const auto response = makeResponse(1, 9000, 12);
+        convolver.setImpulseResponse(response);
+
+        // Large blocks leave the worker's job running at the reset
+        std::vector<float> output;
+        render(convolver, makeInput(20000, 13), output, nullptr, 8192);
+        convolver.reset();
+
+        const auto input = makeInput(20000, 14);
+        render(convolver, input, output, nullptr, 256);
+
+        const auto expected = convolveDirect(input, response, 0);
+        for (size_t i = 0; i < output.size(); ++i)
+            REQUIRE_THAT(output[i], WithinAbs(expected[i], 2.0e-3));
+    }
+
+    SECTION("An empty response unloads it")
+    {
+        convolver.setImpulseResponse(makeResponse(1, 3000, 2));
+        convolver.setImpulseResponse(juce::AudioBuffer<float>());
+
+        REQUIRE_FALSE(convolver.hasImpulseResponse());
+    }
+}
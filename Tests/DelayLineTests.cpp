@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Include delay line
+#include "dsp/DelayLine.h"
+
+using Catch::Matchers::WithinAbs;
+
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr double TWO_PI = 6.283185307179586;
+
+namespace {
+    const DelayLine::Interpolation POLYNOMIAL_TYPES[] = {
+        DelayLine::Interpolation::Linear,
+        DelayLine::Interpolation::Lagrange,
+        DelayLine::Interpolation::Hermite
+    };
+
+    /** Largest error against the ideally delayed sine, after the line has filled. */
+    float sineError(DelayLine::Interpolation type, double frequency, float delay)
+    {
+        DelayLine line;
+        line.setInterpolation(type);
+        line.prepare(1024);
+
+        float maxError = 0.0f;
+        for (int n = 0; n < 4096; ++n)
+        {
+            const float output = line.read(delay);
+            line.write(static_cast<float>(std::sin(TWO_PI * frequency * n / SAMPLE_RATE)));
+
+            const float expected = static_cast<float>(std::sin(TWO_PI * frequency * (n - delay) / SAMPLE_RATE));
+            if (n > 2048)
+                maxError = std::max(maxError, std::abs(output - expected));
+        }
+        return maxError;
+    }
+
+    /** Amplitude of a delayed sine (from its RMS), after the line has filled. */
+    float sineAmplitude(DelayLine::Interpolation type, double frequency, float delay)
+    {
+        DelayLine line;
+        line.setInterpolation(type);
+        line.prepare(1024);
+
+        double sumSquares = 0.0;
+        for (int n = 0; n < 4096; ++n)
+        {
+            const float output = line.read(delay);
+            line.write(static_cast<float>(std::sin(TWO_PI * frequency * n / SAMPLE_RATE)));
+
+            if (n >= 2048)
+                sumSquares += output * output;
+        }
+        return static_cast<float>(std::sqrt(2.0 * sumSquares / 2048.0));
+    }
+}
+
+TEST_CASE("DelayLine integer delays are exact", "[delayline]")
+{
+    for (auto type : POLYNOMIAL_TYPES)
+    {
+        DelayLine line;
+        line.setInterpolation(type);
+        line.prepare(100);
+
+        for (int n = 0; n < 64; ++n)
+        {
+            const float output = line.read(37.0f);
+            line.write(n == 0 ? 1.0f : 0.0f);
+
+            REQUIRE_THAT(output, WithinAbs(n == 37 ? 1.0f : 0.0f, 1e-6f));
+        }
+    }
+}
+
+TEST_CASE("DelayLine reads across the wrap", "[delayline]")
+{
+    // Capacity rounds up to 128, so the ramp wraps many times
+    for (auto type : POLYNOMIAL_TYPES)
+    {
+        DelayLine line;
+        line.setInterpolation(type);
+        line.prepare(100);
+
+        for (int n = 0; n < 1000; ++n)
+        {
+            const float delay = 2.0f + static_cast<float>(n % 99);
+            const float output = line.read(delay);
+            line.write(static_cast<float>(n));
+
+            if (n >= 101)
+                REQUIRE_THAT(output, WithinAbs(static_cast<float>(n) - delay, 1e-3f));
+        }
+    }
+}
+
+TEST_CASE("DelayLine fractional delays follow a sine", "[delayline]")
+{
+    REQUIRE(sineError(DelayLine::Interpolation::Linear, 1000.0, 100.37f) < 5e-3f);
+    REQUIRE(sineError(DelayLine::Interpolation::Lagrange, 1000.0, 100.37f) < 1e-4f);
+    REQUIRE(sineError(DelayLine::Interpolation::Hermite, 1000.0, 100.37f) < 1e-3f);
+    REQUIRE(sineError(DelayLine::Interpolation::Allpass, 1000.0, 100.37f) < 1e-3f);
+}
+
+TEST_CASE("DelayLine 4-point and allpass keep the highs at half-sample delays", "[delayline]")
+{
+    // Linear interpolation halfway between samples is a cos(pi f / fs) lowpass
+    const float linear = sineAmplitude(DelayLine::Interpolation::Linear, 12000.0, 50.5f);
+    const float lagrange = sineAmplitude(DelayLine::Interpolation::Lagrange, 12000.0, 50.5f);
+    const float allpass = sineAmplitude(DelayLine::Interpolation::Allpass, 12000.0, 50.5f);
+
+    REQUIRE_THAT(linear, WithinAbs(std::cos(TWO_PI * 0.125), 1e-3));
+    REQUIRE(lagrange > linear + 0.1f);
+    REQUIRE_THAT(allpass, WithinAbs(1.0f, 1e-3f));
+}
+
+TEST_CASE("DelayLine clamps the delay range", "[delayline]")
+{
+    DelayLine line;
+    line.prepare(100);
+    REQUIRE_THAT(line.getMaxDelay(), WithinAbs(100.0f, 1e-6f));
+
+    for (int n = 0; n < 300; ++n)
+    {
+        const float clamped = line.read(1.0e6f);
+        const float longest = line.read(100.0f);
+        REQUIRE(clamped == longest);
+
+        REQUIRE(line.read(0.0f) == line.read(DelayLine::MIN_DELAY));
+        line.write(static_cast<float>(n));
+    }
+}
+
+TEST_CASE("DelayLine reset clears the history", "[delayline]")
+{
+    DelayLine line;
+    line.prepare(100);
+
+    for (int n = 0; n < 50; ++n)
+    {
+        line.read(10.0f);
+        line.write(1.0f);
+    }
+
+    line.reset();
+
+    for (int n = 0; n < 100; ++n)
+        REQUIRE(line.read(static_cast<float>(n)) == 0.0f);
+}
+
+TEST_CASE("StereoDelayLine matches a DelayLine per channel", "[delayline]")
+{
+    const DelayLine::Interpolation types[] = {
+        DelayLine::Interpolation::Linear,
+        DelayLine::Interpolation::Lagrange,
+        DelayLine::Interpolation::Hermite,
+        DelayLine::Interpolation::Allpass
+    };
+
+    for (auto type : types)
+    {
+        StereoDelayLine stereo;
+        DelayLine left, right;
+        for (auto* line : { &left, &right })
+        {
+            line->setInterpolation(type);
+            line->prepare(300);
+        }
+        stereo.setInterpolation(type);
+        stereo.prepare(300);
+
+        for (int n = 0; n < 2000; ++n)
+        {
+            // Independent signals read at independently swept delays
+            const float delayLeft = 100.0f + 80.0f * static_cast<float>(std::sin(n * 0.003));
+            const float delayRight = 150.0f + 60.0f * static_cast<float>(std::cos(n * 0.005));
+
+            const auto output = stereo.read(delayLeft, delayRight);
+            REQUIRE_THAT(output.left, WithinAbs(left.read(delayLeft), 1e-5f));
+            REQUIRE_THAT(output.right, WithinAbs(right.read(delayRight), 1e-5f));
+
+            const float inputLeft = static_cast<float>(std::sin(n * 0.11));
+            const float inputRight = n % 7 == 0 ? 1.0f : -0.25f;
+            stereo.write({ inputLeft, inputRight });
+            left.write(inputLeft);
+            right.write(inputRight);
+        }
+    }
+}
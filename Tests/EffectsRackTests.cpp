@@ -0,0 +1,331 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Include effects rack
+#include "dsp/EffectsRack.h"
+
+using Catch::Matchers::WithinAbs;
+
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr int BUFFER_SIZE = 512;
+
+namespace {
+    /** Bypasses every slot but the ones listed. */
+    void enableOnly(EffectsRack& rack, std::initializer_list<int> slots)
+    {
+        for (int s = 0; s < EffectsRack::NUM_SLOTS; ++s)
+            rack.setBypassed(s, true);
+
+        for (int s : slots)
+            rack.setBypassed(s, false);
+    }
+
+    void fillSine(std::vector<float>& left, std::vector<float>& right, int block)
+    {
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+        {
+            left[static_cast<size_t>(i)] = 0.5f * std::sin(0.05f * static_cast<float>(block * BUFFER_SIZE + i));
+            right[static_cast<size_t>(i)] = left[static_cast<size_t>(i)];
+        }
+    }
+}
+
+TEST_CASE("EffectsRack bypassed slots pass the signal through", "[effectsrack]")
+{
+    EffectsRack rack;
+    enableOnly(rack, {});
+    rack.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+    std::vector<float> left(BUFFER_SIZE), right(BUFFER_SIZE);
+    for (int block = 0; block < 20; ++block)
+    {
+        fillSine(left, right, block);
+        const auto expected = left;
+        rack.process(left.data(), right.data(), BUFFER_SIZE);
+
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+        {
+            REQUIRE(left[static_cast<size_t>(i)] == expected[static_cast<size_t>(i)]);
+            REQUIRE(right[static_cast<size_t>(i)] == expected[static_cast<size_t>(i)]);
+        }
+    }
+}
+
+TEST_CASE("EffectsRack slots start from silence when enabled again", "[effectsrack]")
+{
+    // A long repeating delay is bypassed mid-tail, then enabled on silence
+    EffectsRack rack;
+    enableOnly(rack, {2});
+    rack.getSlot(2).setType(Effects::Type::DigitalDelay);
+    rack.getSlot(2).setTime(100.0f);
+    rack.getSlot(2).setFeedback(0.9f);
+    rack.getSlot(2).setMix(1.0f);
+    rack.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+    std::vector<float> left(BUFFER_SIZE, 0.0f), right(left);
+    left[0] = right[0] = 1.0f;
+    for (int block = 0; block < 20; ++block)
+    {
+        rack.process(left.data(), right.data(), BUFFER_SIZE);
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+    }
+
+    rack.setBypassed(2, true);
+    rack.process(left.data(), right.data(), BUFFER_SIZE);
+    rack.setBypassed(2, false);
+
+    for (int block = 0; block < 40; ++block)
+    {
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        rack.process(left.data(), right.data(), BUFFER_SIZE);
+
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+            REQUIRE(left[static_cast<size_t>(i)] == 0.0f);
+    }
+}
+
+TEST_CASE("EffectsRack runs its slots in series", "[effectsrack]")
+{
+    // Two 10ms digital delays in series, fully wet: an impulse comes out 20ms later
+    EffectsRack rack;
+    enableOnly(rack, {1, 2});
+    for (int s : {1, 2})
+    {
+        rack.getSlot(s).setType(Effects::Type::DigitalDelay);
+        rack.getSlot(s).setTime(10.0f);
+        rack.getSlot(s).setFeedback(0.0f);
+        rack.getSlot(s).setMix(1.0f);
+    }
+    rack.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+    const int delay = static_cast<int>(SAMPLE_RATE * 0.01);
+    std::vector<float> left(4 * BUFFER_SIZE, 0.0f), right(left);
+    left[0] = right[0] = 1.0f;
+
+    for (int start = 0; start < static_cast<int>(left.size()); start += BUFFER_SIZE)
+        rack.process(left.data() + start, right.data() + start, BUFFER_SIZE);
+
+    for (int i = 0; i < static_cast<int>(left.size()); ++i)
+    {
+        const float expected = i == 2 * delay ? 1.0f : 0.0f;
+        REQUIRE_THAT(left[static_cast<size_t>(i)], WithinAbs(expected, 1e-5f));
+        REQUIRE_THAT(right[static_cast<size_t>(i)], WithinAbs(expected, 1e-5f));
+    }
+}
+
+TEST_CASE("EffectsRack convolution slots share one response", "[effectsrack]")
+{
+    // A response that is a single tap in the tail segment, in two slots in series
+    const int tap = 3000;
+    juce::AudioBuffer<float> response(1, tap + 1);
+    response.clear();
+    response.setSample(0, tap, 1.0f);
+
+    EffectsRack rack;
+    enableOnly(rack, {0, 3});
+    for (int s : {0, 3})
+    {
+        rack.getSlot(s).setType(Effects::Type::Convolution);
+        rack.getSlot(s).setMix(1.0f);
+    }
+    rack.prepare(SAMPLE_RATE, BUFFER_SIZE);
+    rack.setImpulseResponse(response);
+
+    REQUIRE(rack.hasImpulseResponse());
+    for (int s = 0; s < EffectsRack::NUM_SLOTS; ++s)
+        REQUIRE(rack.getSlot(s).hasImpulseResponse());
+
+    std::vector<float> left(16 * BUFFER_SIZE, 0.0f), right(left);
+    left[0] = right[0] = 1.0f;
+
+    for (int start = 0; start < static_cast<int>(left.size()); start += BUFFER_SIZE)
+        rack.process(left.data() + start, right.data() + start, BUFFER_SIZE);
+
+    for (int i = 0; i < static_cast<int>(left.size()); ++i)
+    {
+        const float expected = i == 2 * tap ? 1.0f : 0.0f;
+        REQUIRE_THAT(left[static_cast<size_t>(i)], WithinAbs(expected, 1e-4f));
+    }
+
+    // A short response unloads the worker but still convolves
+    response.setSize(1, 100);
+    rack.setImpulseResponse(response);
+    REQUIRE(rack.getSlot(3).hasImpulseResponse());
+}
+
+TEST_CASE("EffectsRack slots sleep once their tail has decayed", "[effectsrack]")
+{
+    EffectsRack rack;
+    enableOnly(rack, {0});
+    rack.getSlot(0).setType(Effects::Type::DigitalDelay);
+    rack.getSlot(0).setTime(100.0f);
+    rack.getSlot(0).setFeedback(0.5f);
+    rack.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+    const double tail = rack.getSlot(0).getTailLengthSeconds();
+    REQUIRE(tail > 0.1);
+    REQUIRE(tail < 5.0);
+
+    std::vector<float> left(BUFFER_SIZE), right(BUFFER_SIZE);
+    fillSine(left, right, 0);
+    rack.process(left.data(), right.data(), BUFFER_SIZE);
+    REQUIRE_FALSE(rack.isAsleep(0));
+
+    // Awake, and ringing, for the length of the tail
+    const int tailBlocks = static_cast<int>(tail * SAMPLE_RATE / BUFFER_SIZE);
+    float ringing = 0.0f;
+    for (int block = 0; block < tailBlocks; ++block)
+    {
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        rack.process(left.data(), right.data(), BUFFER_SIZE);
+
+        REQUIRE_FALSE(rack.isAsleep(0));
+        for (float sample : left)
+            ringing = std::max(ringing, std::abs(sample));
+    }
+    REQUIRE(ringing > 0.01f);
+
+    // Then asleep, with nothing left to hear
+    for (int block = 0; block < 4; ++block)
+    {
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        rack.process(left.data(), right.data(), BUFFER_SIZE);
+    }
+    REQUIRE(rack.isAsleep(0));
+
+    REQUIRE(rack.isSilent());
+
+    // New signal wakes it
+    fillSine(left, right, 1);
+    rack.process(left.data(), right.data(), BUFFER_SIZE);
+    REQUIRE_FALSE(rack.isAsleep(0));
+    REQUIRE_FALSE(rack.isSilent());
+}
+
+TEST_CASE("EffectsRack slots keep separate state", "[effectsrack]")
+{
+    // A bitcrusher must render the same whether or not another one runs
+    // in between - their sample-and-hold state is not shared
+    EffectsRack reference, interrupted, other;
+    for (auto* rack : { &reference, &interrupted, &other })
+    {
+        enableOnly(*rack, {0});
+        rack->getSlot(0).setType(Effects::Type::Bitcrush);
+        rack->getSlot(0).setMix(1.0f);
+        rack->prepare(SAMPLE_RATE, BUFFER_SIZE);
+    }
+
+    std::vector<float> left(BUFFER_SIZE), right(BUFFER_SIZE);
+    std::vector<float> interruptedLeft(BUFFER_SIZE), interruptedRight(BUFFER_SIZE);
+    std::vector<float> otherLeft(BUFFER_SIZE), otherRight(BUFFER_SIZE);
+
+    for (int block = 0; block < 4; ++block)
+    {
+        fillSine(left, right, block);
+        fillSine(interruptedLeft, interruptedRight, block);
+        fillSine(otherLeft, otherRight, block + 7);
+
+        reference.process(left.data(), right.data(), BUFFER_SIZE);
+        other.process(otherLeft.data(), otherRight.data(), 7);
+        interrupted.process(interruptedLeft.data(), interruptedRight.data(), BUFFER_SIZE);
+
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+            REQUIRE(interruptedLeft[static_cast<size_t>(i)] == left[static_cast<size_t>(i)]);
+    }
+}
+
+TEST_CASE("Effects delay types do not replay each other's history", "[effectsrack]")
+{
+    // The delay types share one line; a repeating digital delay is left
+    // mid-tail and the slot switched to ping-pong
+    Effects effects;
+    effects.setType(Effects::Type::DigitalDelay);
+    effects.setTime(100.0f);
+    effects.setFeedback(0.9f);
+    effects.setMix(1.0f);
+    effects.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+    std::vector<float> left(BUFFER_SIZE, 0.0f), right(left);
+    left[0] = right[0] = 1.0f;
+    for (int block = 0; block < 20; ++block)
+    {
+        effects.process(left.data(), right.data(), BUFFER_SIZE);
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+    }
+
+    effects.setType(Effects::Type::PingPong);
+    for (int block = 0; block < 40; ++block)
+    {
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        effects.process(left.data(), right.data(), BUFFER_SIZE);
+
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+        {
+            REQUIRE(left[static_cast<size_t>(i)] == 0.0f);
+            REQUIRE(right[static_cast<size_t>(i)] == 0.0f);
+        }
+    }
+}
+
+TEST_CASE("Effects tail length follows type, time and feedback", "[effectsrack]")
+{
+    Effects effects;
+    effects.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+    effects.setType(Effects::Type::DigitalDelay);
+    effects.setTime(500.0f);
+    effects.setFeedback(0.0f);
+    REQUIRE_THAT(effects.getTailLengthSeconds(), WithinAbs(0.5f, 1e-6f));
+
+    // -6dB per repeat reaches -100dB after 17 repeats
+    effects.setFeedback(0.5f);
+    REQUIRE_THAT(effects.getTailLengthSeconds(), WithinAbs(0.5f * 18.0f, 1e-3f));
+
+    effects.setType(Effects::Type::Reverb);
+    const float shortReverb = effects.getTailLengthSeconds();
+    effects.setFeedback(0.95f);
+    REQUIRE(effects.getTailLengthSeconds() > shortReverb);
+
+    // Saturating tape feedback sustains itself near the top of the range
+    effects.setType(Effects::Type::TapeDelay);
+    REQUIRE(std::isinf(effects.getTailLengthSeconds()));
+
+    effects.setType(Effects::Type::Bitcrush);
+    REQUIRE(effects.getTailLengthSeconds() == 0.0f);
+}
+
+TEST_CASE("EffectsRack tail is the sum of its enabled slots", "[effectsrack]")
+{
+    EffectsRack rack;
+    enableOnly(rack, {});
+    rack.prepare(SAMPLE_RATE, BUFFER_SIZE);
+    REQUIRE(rack.getTailLengthSeconds() == 0.0);
+    REQUIRE(rack.isSilent());
+
+    for (int s : {0, 2})
+    {
+        rack.getSlot(s).setType(Effects::Type::DigitalDelay);
+        rack.getSlot(s).setTime(250.0f);
+        rack.getSlot(s).setFeedback(0.0f);
+    }
+    rack.getSlot(1).setType(Effects::Type::DigitalDelay);
+    rack.getSlot(1).setTime(1000.0f);
+
+    // Slot 2 (index 1) stays bypassed and does not count
+    enableOnly(rack, {0, 2});
+    REQUIRE_THAT(rack.getTailLengthSeconds(), WithinAbs(0.5, 1e-6));
+
+    // A self-sustaining slot makes the tail infinite
+    rack.getSlot(2).setType(Effects::Type::TapeDelay);
+    rack.getSlot(2).setFeedback(0.95f);
+    REQUIRE(std::isinf(rack.getTailLengthSeconds()));
+}
@@ -72,6 +72,18 @@ TEST_CASE("Envelope Note On/Off", "[envelope][trigger]") {
         REQUIRE(env.getCurrentStage() == Envelope::Stage::Idle);
         REQUIRE(env.getCurrentLevel() == 0.0f);
     }
+
+    SECTION("Silent only while idle") {
+        REQUIRE(env.isSilent());
+        env.setRelease(0.01f);
+        env.noteOn();
+        REQUIRE_FALSE(env.isSilent());
+        env.noteOff();
+        for (int i = 0; i < 2000; ++i) {
+            env.processSample(0.0f);
+        }
+        REQUIRE(env.isSilent());
+    }
 }
 
 TEST_CASE("Envelope ADSR Stages", "[envelope][stages]") {
@@ -411,3 +423,106 @@ TEST_CASE("Envelope Exponential Curves", "[envelope][curve]") {
         REQUIRE(earlyRate > lateRate);
     }
 }
+
+TEST_CASE("Envelope Block Processing", "[envelope][block]") {
+    Envelope blockEnv;
+    Envelope sampleEnv;
+    for (auto* env : { &blockEnv, &sampleEnv }) {
+        env->prepare(SAMPLE_RATE, BUFFER_SIZE);
+        env->setAttack(0.001f);
+        env->setDecay(0.01f);
+        env->setSustain(0.4f);
+        env->setRelease(0.01f);
+    }
+
+    SECTION("Block output matches per-sample output across stage changes") {
+        blockEnv.noteOn();
+        sampleEnv.noteOn();
+
+        std::vector<float> block(BUFFER_SIZE, 0.0f);
+        for (int b = 0; b < 8; ++b) {
+            if (b == 4) {
+                blockEnv.noteOff();
+                sampleEnv.noteOff();
+            }
+
+            blockEnv.process(block.data(), BUFFER_SIZE);
+            for (int i = 0; i < BUFFER_SIZE; ++i) {
+                REQUIRE_THAT(block[i], WithinAbs(sampleEnv.processSample(0.0f), 1.0e-6f));
+            }
+            REQUIRE(blockEnv.getCurrentStage() == sampleEnv.getCurrentStage());
+        }
+
+        REQUIRE(blockEnv.getCurrentStage() == Envelope::Stage::Idle);
+    }
+}
+
+TEST_CASE("Envelope Block Rendering", "[envelope][block]") {
+    auto configure = [](Envelope& env) {
+        env.prepare(SAMPLE_RATE, BUFFER_SIZE);
+        env.setAttack(0.002f);
+        env.setDecay(0.02f);
+        env.setSustain(0.4f);
+        env.setRelease(0.01f);
+    };
+
+    SECTION("Triggers inside a block match per-sample note calls") {
+        // Fast 1/32-style retriggers, including two in one block and one at offset 0
+        const std::vector<Envelope::Trigger> triggers {
+            { 0, Envelope::TriggerType::NoteOn },
+            { 150, Envelope::TriggerType::NoteOff },
+            { 300, Envelope::TriggerType::NoteOn },
+            { 700, Envelope::TriggerType::NoteOn },
+            { 1800, Envelope::TriggerType::NoteOff },
+        };
+
+        Envelope reference;
+        configure(reference);
+        std::vector<float> expected(BUFFER_SIZE * 4);
+        size_t next = 0;
+        for (int i = 0; i < static_cast<int>(expected.size()); ++i) {
+            for (; next < triggers.size() && triggers[next].offset == i; ++next) {
+                if (triggers[next].type == Envelope::TriggerType::NoteOn)
+                    reference.noteOn();
+                else
+                    reference.noteOff();
+            }
+            expected[i] = reference.processSample(0.0f);
+        }
+
+        Envelope block;
+        configure(block);
+        std::vector<float> output(expected.size());
+        for (int offset = 0; offset < static_cast<int>(output.size()); offset += BUFFER_SIZE) {
+            std::vector<Envelope::Trigger> blockTriggers;
+            for (const auto& trigger : triggers) {
+                if (trigger.offset >= offset && trigger.offset < offset + BUFFER_SIZE)
+                    blockTriggers.push_back({ trigger.offset - offset, trigger.type });
+            }
+
+            block.process(output.data() + offset, BUFFER_SIZE, blockTriggers.data(), static_cast<int>(blockTriggers.size()));
+        }
+
+        for (size_t i = 0; i < output.size(); ++i) {
+            REQUIRE_THAT(output[i], WithinAbs(expected[i], 1.0e-5f));
+        }
+    }
+
+    SECTION("Stage ends land on the analytic sample") {
+        Envelope env;
+        configure(env);
+        env.noteOn();
+
+        std::vector<float> output(BUFFER_SIZE * 8);
+        env.process(output.data(), static_cast<int>(output.size()));
+
+        // Attack: first k with (1 - level) = r^k < 0.001, r = exp(-5 / (0.002 * fs))
+        const double attackSamples = 0.002 * SAMPLE_RATE;
+        const int attackEnd = static_cast<int>(std::log(0.001) / (-5.0 / attackSamples)) + 1;
+
+        REQUIRE(output[attackEnd - 1] == 1.0f);
+        REQUIRE(output[attackEnd - 2] < 1.0f);
+        REQUIRE(output.back() == 0.4f);
+        REQUIRE(env.getCurrentStage() == Envelope::Stage::Sustain);
+    }
+}
@@ -0,0 +1,308 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Include reverb
+#include "dsp/FdnReverb.h"
+
+using Catch::Matchers::WithinAbs;
+
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr int BUFFER_SIZE = 512;
+
+namespace {
+    struct Response {
+        std::vector<float> left;
+        std::vector<float> right;
+    };
+
+    /** Impulse response of the reverb, rendered in blocks. */
+    Response renderImpulse(FdnReverb& reverb, int numSamples)
+    {
+        Response response;
+        response.left.assign(static_cast<size_t>(numSamples), 0.0f);
+        response.right.assign(static_cast<size_t>(numSamples), 0.0f);
+
+        std::vector<float> input(static_cast<size_t>(numSamples), 0.0f);
+        input[0] = 1.0f;
+
+        for (int start = 0; start < numSamples; start += BUFFER_SIZE)
+        {
+            const int n = std::min(BUFFER_SIZE, numSamples - start);
+            reverb.process(input.data() + start, response.left.data() + start, response.right.data() + start, n);
+        }
+
+        return response;
+    }
+
+    /** Energy of samples [start, start + length). */
+    double energy(const std::vector<float>& signal, int start, int length)
+    {
+        double sum = 0.0;
+        for (int i = start; i < start + length; ++i)
+            sum += static_cast<double>(signal[static_cast<size_t>(i)]) * signal[static_cast<size_t>(i)];
+        return sum;
+    }
+}
+
+TEST_CASE("FdnReverb decays and stays bounded", "[fdnreverb]")
+{
+    FdnReverb reverb;
+    reverb.prepare(SAMPLE_RATE);
+    reverb.setDamping(6000.0f);
+
+    SECTION("Impulse response dies away")
+    {
+        reverb.setDecay(1.0f);
+        const auto response = renderImpulse(reverb, static_cast<int>(SAMPLE_RATE * 2.0));
+
+        const int window = static_cast<int>(SAMPLE_RATE * 0.1);
+        const double early = energy(response.left, 0, window);
+        const double late = energy(response.left, static_cast<int>(SAMPLE_RATE * 1.5), window);
+
+        REQUIRE(early > 0.0);
+        REQUIRE(late < early * 1.0e-4);
+    }
+
+    SECTION("Longest decay is stable under constant input")
+    {
+        reverb.setDecay(FdnReverb::MAX_DECAY);
+
+        std::vector<float> input(BUFFER_SIZE), left(BUFFER_SIZE), right(BUFFER_SIZE);
+        float peak = 0.0f;
+
+        for (int block = 0; block < 2000; ++block)
+        {
+            for (int i = 0; i < BUFFER_SIZE; ++i)
+                input[static_cast<size_t>(i)] = std::sin(0.05f * static_cast<float>(block * BUFFER_SIZE + i));
+
+            reverb.process(input.data(), left.data(), right.data(), BUFFER_SIZE);
+
+            for (int i = 0; i < BUFFER_SIZE; ++i)
+            {
+                REQUIRE(std::isfinite(left[static_cast<size_t>(i)]));
+                peak = std::max(peak, std::abs(left[static_cast<size_t>(i)]));
+            }
+        }
+
+        // Bounded by the loop gain, far from blowing up
+        REQUIRE(peak < 100.0f);
+    }
+}
+
+TEST_CASE("FdnReverb decay time follows the setting", "[fdnreverb]")
+{
+    FdnReverb reverb;
+    reverb.prepare(SAMPLE_RATE);
+
+    // Undamped, so the decay is set by the line gains alone
+    reverb.setDamping(static_cast<float>(SAMPLE_RATE));
+
+    for (float decay : {0.5f, 1.0f, 2.0f})
+    {
+        reverb.reset();
+        reverb.setDecay(decay);
+
+        const auto response = renderImpulse(reverb, static_cast<int>(SAMPLE_RATE * decay * 1.5));
+
+        // Measure the fall over one decay time from a point past the build-up
+        const int window = static_cast<int>(SAMPLE_RATE * 0.05);
+        const int start = static_cast<int>(SAMPLE_RATE * 0.1);
+        const int end = start + static_cast<int>(SAMPLE_RATE * decay);
+
+        const double dropDb = 10.0 * std::log10(energy(response.left, start, window) / energy(response.left, end, window));
+        REQUIRE_THAT(dropDb, WithinAbs(60.0, 8.0));
+    }
+}
+
+TEST_CASE("FdnReverb stereo output", "[fdnreverb]")
+{
+    FdnReverb reverb;
+    reverb.prepare(SAMPLE_RATE);
+    reverb.setDecay(2.0f);
+
+    SECTION("Left and right tails are decorrelated")
+    {
+        const auto response = renderImpulse(reverb, static_cast<int>(SAMPLE_RATE));
+
+        double cross = 0.0, left = 0.0, right = 0.0;
+        for (size_t i = 0; i < response.left.size(); ++i)
+        {
+            cross += static_cast<double>(response.left[i]) * response.right[i];
+            left += static_cast<double>(response.left[i]) * response.left[i];
+            right += static_cast<double>(response.right[i]) * response.right[i];
+        }
+
+        REQUIRE(left > 0.0);
+        REQUIRE(right > 0.0);
+        REQUIRE(std::abs(cross / std::sqrt(left * right)) < 0.2);
+    }
+
+    SECTION("Mono output is the downmix")
+    {
+        const auto stereo = renderImpulse(reverb, 4096);
+
+        reverb.reset();
+        std::vector<float> input(4096, 0.0f), mono(4096, 0.0f);
+        input[0] = 1.0f;
+        reverb.process(input.data(), mono.data(), nullptr, 4096);
+
+        for (size_t i = 0; i < mono.size(); ++i)
+            REQUIRE_THAT(mono[i], WithinAbs(0.5f * (stereo.left[i] + stereo.right[i]), 1.0e-6));
+    }
+
+    SECTION("Reset clears the tail")
+    {
+        renderImpulse(reverb, 4096);
+        reverb.reset();
+
+        std::vector<float> silence(BUFFER_SIZE, 0.0f), left(BUFFER_SIZE), right(BUFFER_SIZE);
+        reverb.process(silence.data(), left.data(), right.data(), BUFFER_SIZE);
+
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+        {
+            REQUIRE(left[static_cast<size_t>(i)] == 0.0f);
+            REQUIRE(right[static_cast<size_t>(i)] == 0.0f);
+        }
+    }
+}
+
+TEST_CASE("FdnReverb stereo input", "[fdnreverb]")
+{
+    for (int downsampling : { 1, 4 })
+    {
+        FdnReverb reverb;
+        reverb.prepare(SAMPLE_RATE * downsampling, downsampling);
+        reverb.setDecay(2.0f);
+
+        const int numSamples = static_cast<int>(SAMPLE_RATE) * downsampling;
+        std::vector<float> impulse(static_cast<size_t>(numSamples), 0.0f), silence(impulse);
+        impulse[0] = 1.0f;
+
+        // Tails of an impulse on the left only and on the right only
+        std::vector<float> fromLeft(impulse.size()), fromRight(impulse.size()), unused(impulse.size());
+        reverb.process(impulse.data(), silence.data(), fromLeft.data(), unused.data(), numSamples);
+        reverb.reset();
+        reverb.process(silence.data(), impulse.data(), fromRight.data(), unused.data(), numSamples);
+
+        double cross = 0.0;
+        for (size_t i = 0; i < impulse.size(); ++i)
+            cross += static_cast<double>(fromLeft[i]) * fromRight[i];
+
+        const double left = energy(fromLeft, 0, numSamples);
+        const double right = energy(fromRight, 0, numSamples);
+
+        REQUIRE(left > 0.0);
+        REQUIRE(right > 0.0);
+        REQUIRE(std::abs(cross / std::sqrt(left * right)) < 0.2);
+
+        // Together the two patterns carry the energy of the mono input
+        reverb.reset();
+        std::vector<float> monoLeft(impulse.size()), stereoLeft(impulse.size());
+        reverb.process(impulse.data(), nullptr, monoLeft.data(), unused.data(), numSamples);
+        reverb.reset();
+        reverb.process(impulse.data(), impulse.data(), stereoLeft.data(), unused.data(), numSamples);
+
+        const double monoEnergy = energy(monoLeft, 0, numSamples);
+        const double stereoEnergy = energy(stereoLeft, 0, numSamples);
+        REQUIRE(stereoEnergy > monoEnergy * 0.5);
+        REQUIRE(stereoEnergy < monoEnergy * 2.0);
+    }
+}
+
+TEST_CASE("FdnReverb multirate core", "[fdnreverb]")
+{
+    SECTION("Network runs at the divided rate")
+    {
+        FdnReverb reverb;
+        reverb.prepare(192000.0, 4);
+
+        REQUIRE(reverb.getDownsampling() == 4);
+        REQUIRE(reverb.getCoreSampleRate() == 48000.0);
+    }
+
+    SECTION("Line lengths and echo times follow the core rate")
+    {
+        FdnReverb fullRate, quarterRate;
+        fullRate.prepare(48000.0, 1);
+        quarterRate.prepare(192000.0, 4);
+
+        for (int l = 0; l < FdnReverb::NUM_LINES; ++l)
+            REQUIRE(quarterRate.getLineLength(l) == fullRate.getLineLength(l));
+
+        // First sample out of the lines, in milliseconds
+        const auto firstEchoMs = [](FdnReverb& reverb, double hostRate) {
+            const auto response = renderImpulse(reverb, static_cast<int>(hostRate * 0.1));
+            const auto first = std::find_if(response.left.begin(), response.left.end(),
+                                            [](float x) { return std::abs(x) > 1.0e-3f; });
+            return 1000.0 * static_cast<double>(first - response.left.begin()) / hostRate;
+        };
+
+        const double fullRateMs = firstEchoMs(fullRate, 48000.0);
+        const double quarterRateMs = firstEchoMs(quarterRate, 192000.0);
+
+        REQUIRE(fullRateMs > 20.0);
+        REQUIRE_THAT(quarterRateMs, WithinAbs(fullRateMs, 1.0));
+    }
+
+    SECTION("Decay time is kept")
+    {
+        constexpr double HOST_RATE = 96000.0;
+
+        FdnReverb reverb;
+        reverb.prepare(HOST_RATE, 2);
+        reverb.setDamping(static_cast<float>(HOST_RATE));
+        reverb.setDecay(1.0f);
+
+        const auto response = renderImpulse(reverb, static_cast<int>(HOST_RATE * 1.5));
+
+        const int window = static_cast<int>(HOST_RATE * 0.05);
+        const int start = static_cast<int>(HOST_RATE * 0.1);
+        const int end = start + static_cast<int>(HOST_RATE);
+
+        const double dropDb = 10.0 * std::log10(energy(response.left, start, window) / energy(response.left, end, window));
+        REQUIRE_THAT(dropDb, WithinAbs(60.0, 8.0));
+    }
+
+    SECTION("Level matches the full-rate network")
+    {
+        constexpr double HOST_RATE = 96000.0;
+        const int length = static_cast<int>(HOST_RATE * 0.5);
+
+        FdnReverb fullRate, halfRate;
+        fullRate.prepare(HOST_RATE, 1);
+        halfRate.prepare(HOST_RATE, 2);
+
+        const auto full = renderImpulse(fullRate, length);
+        const auto half = renderImpulse(halfRate, length);
+
+        const double ratioDb = 10.0 * std::log10(energy(half.left, 0, length) / energy(full.left, 0, length));
+        REQUIRE(std::abs(ratioDb) < 3.0);
+    }
+
+    SECTION("Output does not depend on the block size")
+    {
+        FdnReverb blockwise, sampleWise;
+        blockwise.prepare(176400.0, 4);
+        sampleWise.prepare(176400.0, 4);
+
+        const int length = 3000;
+        std::vector<float> input(static_cast<size_t>(length));
+        for (int i = 0; i < length; ++i)
+            input[static_cast<size_t>(i)] = std::sin(0.01f * static_cast<float>(i)) * (i < 1000 ? 1.0f : 0.0f);
+
+        std::vector<float> left(input.size()), right(input.size());
+        blockwise.process(input.data(), left.data(), right.data(), length);
+
+        for (int i = 0; i < length; ++i)
+        {
+            float sampleLeft = 0.0f, sampleRight = 0.0f;
+            sampleWise.process(input.data() + i, &sampleLeft, &sampleRight, 1);
+
+            REQUIRE(sampleLeft == left[static_cast<size_t>(i)]);
+            REQUIRE(sampleRight == right[static_cast<size_t>(i)]);
+        }
+    }
+}
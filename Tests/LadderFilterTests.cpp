@@ -3,6 +3,7 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <chrono>
 
 // Include filter
 #include "dsp/LadderFilter.h"
@@ -345,6 +346,85 @@ TEST_CASE("LadderFilter Reset Behavior", "[filter][reset]") {
     }
 }
 
+TEST_CASE("LadderFilter Sample Rate Switch", "[filter][samplerate]") {
+    constexpr int NUM_SAMPLES = 4096;
+
+    std::vector<float> input(NUM_SAMPLES);
+    for (int i = 0; i < NUM_SAMPLES; ++i)
+        input[i] = std::sin(2.0f * M_PI * 220.0f * i / (2.0f * SAMPLE_RATE));
+
+    SECTION("Matches a filter prepared at the new rate") {
+        LadderFilter switched, reference;
+        switched.setMaxRateFactor(8);
+        switched.prepare(SAMPLE_RATE, NUM_SAMPLES);
+        switched.setSampleRate(2.0 * SAMPLE_RATE);
+        reference.prepare(2.0 * SAMPLE_RATE, NUM_SAMPLES);
+
+        for (auto* filter : { &switched, &reference }) {
+            filter->setCutoff(800.0f);
+            filter->setResonance(0.6f);
+        }
+
+        std::vector<float> a(input), b(input);
+        switched.process(a.data(), NUM_SAMPLES);
+        reference.process(b.data(), NUM_SAMPLES);
+
+        // The coefficients glide over the first control segment, then agree
+        for (int i = NUM_SAMPLES / 2; i < NUM_SAMPLES; ++i)
+            REQUIRE_THAT(a[i], WithinAbs(b[i], 1.0e-4f));
+    }
+
+    SECTION("Keeps its state across the switch") {
+        LadderFilter filter;
+        filter.setMaxRateFactor(8);
+        filter.prepare(SAMPLE_RATE, NUM_SAMPLES);
+        filter.setCutoff(800.0f);
+        filter.setResonance(0.6f);
+
+        std::vector<float> buffer(input);
+        filter.process(buffer.data(), NUM_SAMPLES / 2);
+        const float before = buffer[NUM_SAMPLES / 2 - 1];
+        REQUIRE(std::abs(before) > 0.1f);
+
+        filter.setSampleRate(4.0 * SAMPLE_RATE);
+        float after = input[NUM_SAMPLES / 2];
+        filter.process(&after, 1);
+
+        // One sample at the higher rate barely moves the output
+        REQUIRE_THAT(after, WithinAbs(before, 0.05f));
+    }
+}
+
+TEST_CASE("LadderFilter Silence Detection", "[filter][silence]") {
+    LadderFilter filter;
+    filter.prepare(SAMPLE_RATE, BUFFER_SIZE);
+    filter.setCutoff(1000.0f);
+    filter.setResonance(0.5f);
+
+    REQUIRE(filter.isSilent());
+
+    std::vector<float> buffer(BUFFER_SIZE);
+    for (int i = 0; i < BUFFER_SIZE; ++i)
+        buffer[i] = std::sin(2.0f * M_PI * 440.0f * i / SAMPLE_RATE);
+    filter.process(buffer.data(), BUFFER_SIZE);
+    REQUIRE_FALSE(filter.isSilent());
+
+    // Rings out within a second on silent input, and stays below the
+    // threshold once it reports silence
+    bool silent = false;
+    for (int block = 0; block < 100 && !silent; ++block) {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        filter.process(buffer.data(), BUFFER_SIZE);
+        silent = filter.isSilent();
+    }
+    REQUIRE(silent);
+
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    filter.process(buffer.data(), BUFFER_SIZE);
+    for (float sample : buffer)
+        REQUIRE(std::abs(sample) < DSPModule::SILENCE_THRESHOLD);
+}
+
 TEST_CASE("LadderFilter DC Blocking", "[filter][dc]") {
     LadderFilter filter;
     filter.prepare(SAMPLE_RATE, BUFFER_SIZE);
@@ -370,3 +450,274 @@ TEST_CASE("LadderFilter DC Blocking", "[filter][dc]") {
         REQUIRE(avgOutput < 0.9f);
     }
 }
+
+TEST_CASE("LadderFilter Block Processing", "[filter][block]") {
+    LadderFilter blockFilter;
+    LadderFilter sampleFilter;
+    for (auto* filter : { &blockFilter, &sampleFilter }) {
+        filter->prepare(SAMPLE_RATE, BUFFER_SIZE);
+        filter->setCutoff(800.0f);
+        filter->setResonance(0.6f);
+        filter->setEnvelopeAmount(0.5f);
+        filter->setControlInterval(1);
+    }
+
+    SECTION("Envelope buffer matches per-sample envelope values") {
+        std::vector<float> block(BUFFER_SIZE);
+        std::vector<float> envelope(BUFFER_SIZE);
+        for (int i = 0; i < BUFFER_SIZE; ++i) {
+            block[i] = std::sin(2.0f * static_cast<float>(M_PI) * 110.0f * i / SAMPLE_RATE);
+            envelope[i] = std::exp(-static_cast<float>(i) / 200.0f);
+        }
+
+        std::vector<float> expected(BUFFER_SIZE);
+        for (int i = 0; i < BUFFER_SIZE; ++i) {
+            sampleFilter.setEnvelopeValue(envelope[i]);
+            expected[i] = sampleFilter.processSample(block[i]);
+        }
+
+        blockFilter.setEnvelopeBuffer(envelope.data());
+        blockFilter.process(block.data(), BUFFER_SIZE);
+
+        for (int i = 0; i < BUFFER_SIZE; ++i) {
+            REQUIRE_THAT(block[i], WithinAbs(expected[i], 1.0e-5f));
+        }
+    }
+}
+
+TEST_CASE("LadderFilter Control-Rate Coefficients", "[filter][controlrate]") {
+    SECTION("Intervals are rounded to supported values") {
+        LadderFilter filter;
+        filter.setControlInterval(1);
+        REQUIRE(filter.getControlInterval() == 1);
+        filter.setControlInterval(20);
+        REQUIRE(filter.getControlInterval() == 16);
+        filter.setControlInterval(1000);
+        REQUIRE(filter.getControlInterval() == ControlRate::MAX_INTERVAL);
+    }
+
+    SECTION("Interpolated coefficients stay close to the per-sample path") {
+        // Fast envelope sweep with high resonance - the worst case for interpolation
+        std::vector<float> input(BUFFER_SIZE * 4);
+        std::vector<float> envelope(input.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = 2.0f * std::fmod(110.0f * i / SAMPLE_RATE, 1.0f) - 1.0f;
+            envelope[i] = std::exp(-static_cast<float>(i) / 300.0f);
+        }
+
+        auto render = [&](int interval) {
+            LadderFilter filter;
+            filter.prepare(SAMPLE_RATE, BUFFER_SIZE);
+            filter.setCutoff(400.0f);
+            filter.setResonance(0.8f);
+            filter.setEnvelopeAmount(1.0f);
+            filter.setControlInterval(interval);
+
+            std::vector<float> output(input);
+            for (size_t offset = 0; offset < output.size(); offset += BUFFER_SIZE) {
+                filter.setEnvelopeBuffer(envelope.data() + offset);
+                filter.process(output.data() + offset, BUFFER_SIZE);
+            }
+            return output;
+        };
+
+        const auto reference = render(1);
+
+        for (int interval : { 8, 16, 32 }) {
+            const auto output = render(interval);
+
+            float maxError = 0.0f;
+            for (size_t i = 0; i < output.size(); ++i) {
+                maxError = std::max(maxError, std::abs(output[i] - reference[i]));
+            }
+
+            INFO("Interval: " << interval << ", max error: " << maxError);
+            REQUIRE(maxError < 0.01f);
+        }
+    }
+}
+
+namespace {
+    // Frequency of the largest peak in the filter's small-signal impulse response
+    float findResonantPeak(LadderFilter::Model model, LadderFilter::Quality quality, float cutoff,
+                           float envelopeAmount = 0.0f, float envelopeValue = 0.0f) {
+        constexpr int LENGTH = 16384;
+
+        LadderFilter filter;
+        filter.setModel(model);
+        filter.setQuality(quality);
+        filter.setCutoff(cutoff);
+        filter.setResonance(1.0f);
+        filter.setEnvelopeAmount(envelopeAmount);
+        filter.setEnvelopeValue(envelopeValue);
+        filter.prepare(SAMPLE_RATE, LENGTH);
+
+        std::vector<float> response(LENGTH, 0.0f);
+        response[0] = 1.0e-3f;
+        filter.process(response.data(), LENGTH);
+
+        float peakFrequency = 0.0f;
+        double peakMagnitude = 0.0;
+        const float modulated = cutoff * std::exp2(4.0f * envelopeAmount * envelopeValue);
+        for (float frequency = 0.7f * modulated; frequency <= 1.3f * modulated; frequency *= 1.002f) {
+            const double w = 2.0 * M_PI * frequency / SAMPLE_RATE;
+            double re = 0.0, im = 0.0;
+            for (int n = 0; n < LENGTH; ++n) {
+                re += response[n] * std::cos(w * n);
+                im -= response[n] * std::sin(w * n);
+            }
+
+            const double magnitude = re * re + im * im;
+            if (magnitude > peakMagnitude) {
+                peakMagnitude = magnitude;
+                peakFrequency = frequency;
+            }
+        }
+
+        return peakFrequency;
+    }
+
+    std::vector<float> renderSaw(LadderFilter::Model model, LadderFilter::Quality quality,
+                                 double sampleRate, int numSamples, float amplitude) {
+        LadderFilter filter;
+        filter.setModel(model);
+        filter.setQuality(quality);
+        filter.setCutoff(1500.0f);
+        filter.setResonance(0.7f);
+        filter.prepare(sampleRate, BUFFER_SIZE);
+
+        std::vector<float> output(static_cast<size_t>(numSamples));
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = amplitude * (2.0f * static_cast<float>(std::fmod(110.0 * i / sampleRate, 1.0)) - 1.0f);
+
+        for (int offset = 0; offset < numSamples; offset += BUFFER_SIZE)
+            filter.process(output.data() + offset, std::min(BUFFER_SIZE, numSamples - offset));
+
+        return output;
+    }
+
+    float maxDifference(const std::vector<float>& a, const std::vector<float>& b) {
+        float difference = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i)
+            difference = std::max(difference, std::abs(a[i] - b[i]));
+        return difference;
+    }
+}
+
+TEST_CASE("LadderFilter Zero-Delay Feedback", "[filter][zdf]") {
+    using Model = LadderFilter::Model;
+    using Quality = LadderFilter::Quality;
+
+    SECTION("Resonant peak tracks the cutoff up to the top of the range") {
+        for (auto model : { Model::Transistor, Model::Diode }) {
+            for (float cutoff : { 300.0f, 2000.0f, 8000.0f, 12000.0f }) {
+                const float peak = findResonantPeak(model, Quality::Linear, cutoff);
+                INFO("Model " << static_cast<int>(model) << ", cutoff " << cutoff << ", peak " << peak);
+                REQUIRE_THAT(peak, WithinRel(cutoff, 0.02f));
+            }
+        }
+    }
+
+    SECTION("Envelope modulation moves the cutoff in octaves") {
+        for (auto model : { Model::Transistor, Model::Diode }) {
+            REQUIRE_THAT(findResonantPeak(model, Quality::Linear, 250.0f, 1.0f, 0.5f), WithinRel(1000.0f, 0.02f));
+            REQUIRE_THAT(findResonantPeak(model, Quality::Linear, 4000.0f, -0.5f, 0.75f), WithinRel(1414.2f, 0.02f));
+        }
+    }
+
+    SECTION("Nonlinear tiers match the linear ladder at low level") {
+        for (auto model : { Model::Transistor, Model::Diode }) {
+            const auto linear = renderSaw(model, Quality::Linear, SAMPLE_RATE, 4096, 1.0e-3f);
+            const auto single = renderSaw(model, Quality::SingleNewton, SAMPLE_RATE, 4096, 1.0e-3f);
+            const auto full = renderSaw(model, Quality::FullNewton, SAMPLE_RATE, 4096, 1.0e-3f);
+
+            REQUIRE(maxDifference(linear, full) < 2.0e-5f);
+            REQUIRE(maxDifference(single, full) < 2.0e-5f);
+        }
+    }
+
+    SECTION("One Newton step stays close to the converged solution when oversampled") {
+        for (auto model : { Model::Transistor, Model::Diode }) {
+            const auto single = renderSaw(model, Quality::SingleNewton, SAMPLE_RATE * 4, 16384, 1.0f);
+            const auto full = renderSaw(model, Quality::FullNewton, SAMPLE_RATE * 4, 16384, 1.0f);
+
+            INFO("Model " << static_cast<int>(model) << ", error " << maxDifference(single, full));
+            REQUIRE(maxDifference(single, full) < 0.02f);
+        }
+    }
+
+    SECTION("High cutoffs are no longer clamped") {
+        LadderFilter filter;
+        filter.setCutoff(18000.0f);
+        filter.setResonance(0.0f);
+        filter.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+        float inputRMS = 0.0f, outputRMS = 0.0f;
+        for (int i = 0; i < 4000; ++i) {
+            const float input = 0.1f * std::sin(2.0f * static_cast<float>(M_PI) * 10000.0f * i / SAMPLE_RATE);
+            const float output = filter.processSample(input);
+            if (i >= 2000) {
+                inputRMS += input * input;
+                outputRMS += output * output;
+            }
+        }
+
+        REQUIRE(outputRMS > 0.5f * inputRMS);
+    }
+
+    SECTION("Every model and tier stays bounded at full resonance") {
+        for (auto model : { Model::Transistor, Model::Diode }) {
+            for (auto quality : { Quality::Linear, Quality::SingleNewton, Quality::FullNewton }) {
+                const auto output = renderSaw(model, quality, SAMPLE_RATE, 8192, 1.0f);
+                for (float x : output) {
+                    REQUIRE(std::isfinite(x));
+                    REQUIRE(std::abs(x) < 10.0f);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("LadderFilter Tier Cost", "[filter][zdf][timing]") {
+    using Model = LadderFilter::Model;
+    using Quality = LadderFilter::Quality;
+
+    constexpr int NUM_SAMPLES = 1 << 18;
+
+    for (auto model : { Model::Transistor, Model::Diode }) {
+        for (auto quality : { Quality::Linear, Quality::SingleNewton, Quality::FullNewton }) {
+            LadderFilter filter;
+            filter.setModel(model);
+            filter.setQuality(quality);
+            filter.setCutoff(800.0f);
+            filter.setResonance(0.8f);
+            filter.setEnvelopeAmount(0.5f);
+            filter.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+            std::vector<float> block(BUFFER_SIZE);
+            float checksum = 0.0f;
+            int phase = 0;
+
+            const auto start = std::chrono::steady_clock::now();
+            for (int offset = 0; offset < NUM_SAMPLES; offset += BUFFER_SIZE) {
+                for (float& x : block)
+                    x = 2.0f * static_cast<float>((phase++ % 400) / 400.0) - 1.0f;
+
+                filter.setEnvelopeValue(static_cast<float>(offset % 8192) / 8192.0f);
+                filter.process(block.data(), BUFFER_SIZE);
+                checksum += block[BUFFER_SIZE - 1];
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            const double nanosecondsPerSample =
+                std::chrono::duration<double, std::nano>(elapsed).count() / NUM_SAMPLES;
+
+            WARN((model == Model::Diode ? "Diode" : "Transistor")
+                 << (quality == Quality::Linear ? " linear" : quality == Quality::SingleNewton ? " single Newton" : " full Newton")
+                 << ": " << nanosecondsPerSample << " ns/sample");
+
+            REQUIRE(std::isfinite(checksum));
+            REQUIRE(nanosecondsPerSample > 0.0);
+        }
+    }
+}
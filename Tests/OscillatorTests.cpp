@@ -158,7 +158,8 @@ TEST_CASE("Oscillator Fine Tuning", "[oscillator][tuning]") {
 
         // Signals should be different
         bool different = false;
-        for (size_t i = 100; i < 200; ++i) { // Skip transient
+        // Band-limited edges are smooth, so let the detuned phase drift build up
+        for (size_t i = 500; i < 1000; ++i) { // Skip transient
             if (std::abs(signal1[i] - signal2[i]) > 0.1f) {
                 different = true;
                 break;
@@ -166,6 +167,47 @@ TEST_CASE("Oscillator Fine Tuning", "[oscillator][tuning]") {
         }
         REQUIRE(different);
     }
+
+    SECTION("Fine tune changes are ramped") {
+        // A short slide passes frequency steps straight through, so any glide
+        // here comes from the fine tune ramp
+        osc.setWaveform(Oscillator::Waveform::Sine);
+        osc.setSlideTime(0.001f);
+        osc.setFrequency(1000.0f);
+        osc.setFineTune(0.0f);
+        osc.reset();
+
+        std::vector<float> settle(BUFFER_SIZE);
+        osc.process(settle.data(), BUFFER_SIZE);
+
+        osc.setFineTune(50.0f);
+        std::vector<float> signal(8 * BUFFER_SIZE);
+        for (size_t offset = 0; offset < signal.size(); offset += BUFFER_SIZE)
+            osc.process(signal.data() + offset, BUFFER_SIZE);
+
+        // Mean frequency between the rising zero crossings in [start, end)
+        auto measureFrequency = [&signal](size_t start, size_t end) {
+            double first = -1.0, last = -1.0;
+            int cycles = -1;
+            for (size_t i = start + 1; i < end; ++i) {
+                if (signal[i - 1] < 0.0f && signal[i] >= 0.0f) {
+                    const double crossing = static_cast<double>(i - 1) + signal[i - 1] / (signal[i - 1] - signal[i]);
+                    if (first < 0.0)
+                        first = crossing;
+                    last = crossing;
+                    ++cycles;
+                }
+            }
+            return cycles * SAMPLE_RATE / (last - first);
+        };
+
+        const double detuned = 1000.0 * std::pow(2.0, 50.0 / 1200.0);
+        const size_t rampSamples = static_cast<size_t>(0.02f * SAMPLE_RATE);
+
+        // Half way between the two pitches over the ramp, then at the new one
+        REQUIRE_THAT(measureFrequency(0, rampSamples), WithinAbs(0.5 * (1000.0 + detuned), 3.0));
+        REQUIRE_THAT(measureFrequency(2 * rampSamples, signal.size()), WithinAbs(detuned, 0.5));
+    }
 }
 
 TEST_CASE("Oscillator Real-Time Safety", "[oscillator][realtime]") {
@@ -225,3 +267,138 @@ TEST_CASE("Oscillator Phase Continuity", "[oscillator][phase]") {
         REQUIRE_THAT(sample1, WithinRel(sample2, 0.001f));
     }
 }
+
+TEST_CASE("Oscillator Block Processing", "[oscillator][block]") {
+    Oscillator blockOsc;
+    Oscillator sampleOsc;
+    blockOsc.prepare(SAMPLE_RATE, BUFFER_SIZE);
+    sampleOsc.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+    SECTION("Block output matches per-sample output") {
+        for (int wave = 0; wave <= 11; ++wave) {
+            if (wave == static_cast<int>(Oscillator::Waveform::Noise))
+                continue; // Random by design
+
+            blockOsc.setWaveform(wave);
+            sampleOsc.setWaveform(wave);
+            blockOsc.setFrequency(220.0f);
+            sampleOsc.setFrequency(220.0f);
+            blockOsc.reset();
+            sampleOsc.reset();
+
+            std::vector<float> block(BUFFER_SIZE, 0.0f);
+            blockOsc.process(block.data(), BUFFER_SIZE);
+
+            for (int i = 0; i < BUFFER_SIZE; ++i) {
+                REQUIRE_THAT(block[i], WithinAbs(sampleOsc.processSample(0.0f), 1.0e-5f));
+            }
+        }
+    }
+}
+
+TEST_CASE("Oscillator Wavetables", "[oscillator][wavetable]") {
+    const auto& bank = WavetableBank::getInstance();
+
+    SECTION("Mip level keeps every harmonic below Nyquist") {
+        for (float freq = 20.0f; freq < 20000.0f; freq *= 1.1f) {
+            const float increment = freq / SAMPLE_RATE;
+            const int level = WavetableBank::getLevelForIncrement(increment);
+
+            INFO("Frequency: " << freq);
+            REQUIRE(static_cast<float>(WavetableBank::MAX_HARMONICS >> level) * increment <= 0.5f);
+
+            // The previous level would alias, so no bandwidth is wasted
+            if (level > 0) {
+                REQUIRE(static_cast<float>(WavetableBank::MAX_HARMONICS >> (level - 1)) * increment > 0.5f);
+            }
+        }
+    }
+
+    SECTION("Sine table matches std::sin") {
+        const float* table = bank.getTable(WavetableBank::Shape::Sine, 0);
+        for (int i = 0; i < WavetableBank::TABLE_SIZE; i += 64) {
+            const float phase = static_cast<float>(i) / WavetableBank::TABLE_SIZE;
+            REQUIRE_THAT(WavetableBank::read(table, phase), WithinAbs(std::sin(6.2831853f * phase), 1.0e-4f));
+        }
+    }
+
+    SECTION("Tables stay within range at every level") {
+        for (int shape = 0; shape < WavetableBank::NUM_SHAPES; ++shape) {
+            for (int level = 0; level < WavetableBank::NUM_LEVELS; ++level) {
+                const float* table = bank.getTable(static_cast<WavetableBank::Shape>(shape), level);
+                for (int i = 0; i <= WavetableBank::TABLE_SIZE; ++i) {
+                    REQUIRE(std::abs(table[i]) <= 1.0001f);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Oscillator SuperSaw", "[oscillator][supersaw]") {
+    Oscillator osc;
+    osc.prepare(SAMPLE_RATE, BUFFER_SIZE);
+    osc.setWaveform(Oscillator::Waveform::SuperSaw);
+    osc.setFrequency(110.0f);
+
+    std::vector<float> left(BUFFER_SIZE, 0.0f);
+    std::vector<float> right(BUFFER_SIZE, 0.0f);
+
+    SECTION("Full stack stays finite and in range") {
+        osc.setSuperSawVoices(16);
+        osc.setSuperSawDetune(1.0f);
+        osc.setSuperSawMix(1.0f);
+        osc.reset();
+
+        for (int block = 0; block < 8; ++block) {
+            osc.process(left.data(), right.data(), BUFFER_SIZE);
+            for (int i = 0; i < BUFFER_SIZE; ++i) {
+                REQUIRE(std::isfinite(left[i]));
+                REQUIRE(std::isfinite(right[i]));
+                REQUIRE(std::abs(left[i]) <= 1.0f);
+                REQUIRE(std::abs(right[i]) <= 1.0f);
+            }
+        }
+    }
+
+    SECTION("Zero spread renders identical channels") {
+        osc.setSuperSawSpread(0.0f);
+        osc.reset();
+        osc.process(left.data(), right.data(), BUFFER_SIZE);
+
+        for (int i = 0; i < BUFFER_SIZE; ++i) {
+            REQUIRE_THAT(left[i], WithinAbs(right[i], 1.0e-6f));
+        }
+    }
+
+    SECTION("Full spread widens the stereo image") {
+        osc.setSuperSawSpread(1.0f);
+        osc.reset();
+        osc.process(left.data(), right.data(), BUFFER_SIZE);
+
+        float difference = 0.0f;
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+            difference += std::abs(left[i] - right[i]);
+
+        REQUIRE(difference / BUFFER_SIZE > 0.01f);
+    }
+
+    SECTION("Mono output is the stereo downmix") {
+        osc.setSuperSawSpread(1.0f);
+        osc.reset();
+        osc.process(left.data(), right.data(), BUFFER_SIZE);
+
+        Oscillator mono;
+        mono.prepare(SAMPLE_RATE, BUFFER_SIZE);
+        mono.setWaveform(Oscillator::Waveform::SuperSaw);
+        mono.setFrequency(110.0f);
+        mono.setSuperSawSpread(1.0f);
+        mono.reset();
+
+        std::vector<float> downmix(BUFFER_SIZE, 0.0f);
+        mono.process(downmix.data(), BUFFER_SIZE);
+
+        for (int i = 0; i < BUFFER_SIZE; ++i) {
+            REQUIRE_THAT(downmix[i], WithinAbs(0.5f * (left[i] + right[i]), 1.0e-5f));
+        }
+    }
+}
@@ -0,0 +1,295 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <juce_dsp/juce_dsp.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Include overdrive
+#include "dsp/Overdrive.h"
+
+using namespace Catch::Matchers;
+
+constexpr double SAMPLE_RATE = 44100.0;
+constexpr int BUFFER_SIZE = 512;
+
+namespace {
+    template <typename Curve>
+    void requireConsistentAntiderivatives() {
+        constexpr double h = 1.0e-4;
+
+        for (double u = -4.0; u <= 4.0; u += 0.0137) {
+            INFO("u = " << u);
+
+            // F1' = f and F2' = F1 (central differences)
+            const double dF1 = (Curve::F1(u + h) - Curve::F1(u - h)) / (2.0 * h);
+            const double dF2 = (Curve::F2(u + h) - Curve::F2(u - h)) / (2.0 * h);
+
+            REQUIRE_THAT(dF1, WithinAbs(Curve::f(u), 1.0e-5));
+            REQUIRE_THAT(dF2, WithinAbs(Curve::F1(u), 1.0e-5));
+        }
+    }
+
+    // Fraction of the output power that lands outside the harmonics of a bin-aligned sine
+    float measureAliasing(Overdrive::Antialiasing order) {
+        constexpr int FFT_ORDER = 12;
+        constexpr int FFT_SIZE = 1 << FFT_ORDER;
+        constexpr int FUNDAMENTAL_BIN = 93;   // ~1 kHz
+
+        Overdrive overdrive;
+        overdrive.setMode(Overdrive::Mode::Fuzz);
+        overdrive.setDrive(10.0f);
+        overdrive.setAntialiasing(order);
+        overdrive.prepare(SAMPLE_RATE, FFT_SIZE);
+
+        std::vector<float> signal(2 * FFT_SIZE, 0.0f);
+        for (int n = 0; n < FFT_SIZE; ++n)
+            signal[n] = 0.5f * std::sin(6.283185307f * FUNDAMENTAL_BIN * n / FFT_SIZE);
+
+        // Run once to settle the DC blocker, then analyse a second period
+        std::vector<float> warmUp(signal.begin(), signal.begin() + FFT_SIZE);
+        overdrive.process(warmUp.data(), FFT_SIZE);
+        overdrive.process(signal.data(), FFT_SIZE);
+
+        juce::dsp::FFT fft(FFT_ORDER);
+        fft.performFrequencyOnlyForwardTransform(signal.data());
+
+        double harmonicPower = 0.0, aliasPower = 0.0;
+        for (int bin = 1; bin < FFT_SIZE / 2; ++bin) {
+            const double power = static_cast<double>(signal[bin]) * signal[bin];
+            if (bin % FUNDAMENTAL_BIN == 0)
+                harmonicPower += power;
+            else
+                aliasPower += power;
+        }
+
+        return static_cast<float>(aliasPower / harmonicPower);
+    }
+}
+
+TEST_CASE("Overdrive Antiderivatives", "[overdrive][adaa]") {
+    SECTION("Tanh") { requireConsistentAntiderivatives<Antiderivative::Tanh>(); }
+    SECTION("Asymmetric tanh") { requireConsistentAntiderivatives<Antiderivative::AsymmetricTanh>(); }
+    SECTION("Cubic saturation") { requireConsistentAntiderivatives<Antiderivative::CubicSaturation>(); }
+    SECTION("Fuzz") { requireConsistentAntiderivatives<Antiderivative::Fuzz>(); }
+    SECTION("Tape knee") { requireConsistentAntiderivatives<Antiderivative::TapeKnee>(); }
+
+    SECTION("Tabulated tanh integral extends past the table") {
+        // Far from zero log(cosh(u)) = |u| - log(2)
+        const double u = 20.0;
+        const double slope = (Antiderivative::logCoshIntegral(u + 0.01) - Antiderivative::logCoshIntegral(u - 0.01)) / 0.02;
+        REQUIRE_THAT(slope, WithinAbs(u - 0.6931471805599453, 1.0e-6));
+        REQUIRE(Antiderivative::logCoshIntegral(-u) == -Antiderivative::logCoshIntegral(u));
+    }
+}
+
+TEST_CASE("Overdrive Anti-Aliasing", "[overdrive][adaa]") {
+    SECTION("Every mode and order stays finite and within the plain curve's range") {
+        for (int mode = 0; mode < Overdrive::NUM_MODES; ++mode) {
+            float plainPeak = 0.0f;
+
+            for (int order = 0; order <= 2; ++order) {
+                Overdrive overdrive;
+                overdrive.setMode(mode);
+                overdrive.setDrive(10.0f);
+                overdrive.setAntialiasing(order);
+                overdrive.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+                std::vector<float> block(BUFFER_SIZE);
+                for (int i = 0; i < BUFFER_SIZE; ++i)
+                    block[i] = std::sin(0.3f * i) * (i % 7 == 0 ? 1.0f : 0.3f);
+
+                overdrive.process(block.data(), BUFFER_SIZE);
+
+                float peak = 0.0f;
+                for (float x : block) {
+                    REQUIRE(std::isfinite(x));
+                    peak = std::max(peak, std::abs(x));
+                }
+
+                // ADAA averages the curve, so it cannot exceed the plain output by much
+                INFO("Mode " << mode << ", order " << order);
+                if (order == 0)
+                    plainPeak = peak;
+                else
+                    REQUIRE(peak <= plainPeak * 1.1f);
+            }
+        }
+    }
+
+    SECTION("ADAA lowers aliasing at high drive") {
+        const float off = measureAliasing(Overdrive::Antialiasing::Off);
+        const float first = measureAliasing(Overdrive::Antialiasing::First);
+        const float second = measureAliasing(Overdrive::Antialiasing::Second);
+
+        REQUIRE(first < 0.5f * off);
+        REQUIRE(second < first);
+    }
+
+    SECTION("Order can be chosen per mode") {
+        Overdrive overdrive;
+        overdrive.setAntialiasing(Overdrive::Antialiasing::Off);
+        overdrive.setAntialiasing(Overdrive::Mode::Fuzz, Overdrive::Antialiasing::Second);
+
+        REQUIRE(overdrive.getAntialiasing(Overdrive::Mode::Fuzz) == Overdrive::Antialiasing::Second);
+        REQUIRE(overdrive.getAntialiasing(Overdrive::Mode::Soft) == Overdrive::Antialiasing::Off);
+    }
+}
+
+TEST_CASE("Overdrive Waveshaper Tables", "[overdrive][table]") {
+    SECTION("Table matches the curve and its antiderivatives") {
+        constexpr float drive = 6.0f;
+        WaveshaperTable table;
+        table.build<Antiderivative::AsymmetricTanh>(1, drive, drive, 1.0f);
+
+        // Includes points beyond the tabulated range
+        for (double x = -6.0; x <= 6.0; x += 0.0173) {
+            INFO("x = " << x);
+            const double u = drive * x;
+            REQUIRE_THAT(table.f(static_cast<float>(x)), WithinAbs(Antiderivative::AsymmetricTanh::f(u), 1.0e-4));
+            REQUIRE_THAT(table.F1(x), WithinAbs(Antiderivative::AsymmetricTanh::F1(u) / drive, 1.0e-7));
+            REQUIRE_THAT(table.F2(x), WithinAbs(Antiderivative::AsymmetricTanh::F2(u) / (drive * drive), 1.0e-7));
+        }
+    }
+
+    SECTION("A drive change is rebuilt in the background and crossfaded in") {
+        Overdrive overdrive;
+        overdrive.setMode(Overdrive::Mode::Soft);
+        overdrive.setDrive(2.0f);
+        overdrive.prepare(SAMPLE_RATE, BUFFER_SIZE);
+        REQUIRE(overdrive.getTableDrive() == 2.0f);
+
+        overdrive.setDrive(8.0f);
+
+        std::vector<float> block(BUFFER_SIZE);
+        bool swapped = false;
+        float previous = 0.0f, largestStep = 0.0f;
+        int phase = 0;
+
+        // Keep playing a slow sine until the new table lands (or give up after ~2 seconds)
+        for (int b = 0; b < 200 && !swapped; ++b) {
+            for (float& x : block)
+                x = 0.5f * std::sin(0.01f * phase++);
+
+            overdrive.process(block.data(), BUFFER_SIZE);
+
+            for (float x : block) {
+                REQUIRE(std::isfinite(x));
+                largestStep = std::max(largestStep, std::abs(x - previous));
+                previous = x;
+            }
+
+            swapped = overdrive.getTableDrive() == 8.0f;
+            juce::Thread::sleep(1);
+        }
+
+        REQUIRE(swapped);
+
+        // The crossfade keeps the change free of clicks
+        REQUIRE(largestStep < 0.1f);
+    }
+
+    SECTION("A request queued behind an unadopted table is still built") {
+        Overdrive overdrive;
+        overdrive.setMode(Overdrive::Mode::Soft);
+        overdrive.setDrive(2.0f);
+        overdrive.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+        std::vector<float> block(BUFFER_SIZE, 0.1f);
+
+        // Requested, then left to finish while the audio thread is away
+        overdrive.setDrive(4.0f);
+        overdrive.process(block.data(), BUFFER_SIZE);
+        juce::Thread::sleep(50);
+
+        // The next block asks for another curve before adopting the first
+        overdrive.setDrive(8.0f);
+        for (int b = 0; b < 200 && overdrive.getTableDrive() != 8.0f; ++b) {
+            std::fill(block.begin(), block.end(), 0.1f);
+            overdrive.process(block.data(), BUFFER_SIZE);
+            juce::Thread::sleep(1);
+        }
+
+        REQUIRE(overdrive.getTableDrive() == 8.0f);
+    }
+
+    SECTION("Overdrives sharing a builder both get the new curve") {
+        const auto builder = Overdrive::createTableBuilder();
+        Overdrive left, right;
+        for (auto* overdrive : { &left, &right }) {
+            overdrive->setTableBuilder(builder);
+            overdrive->setMode(Overdrive::Mode::Fuzz);
+            overdrive->setDrive(2.0f);
+            overdrive->prepare(SAMPLE_RATE, BUFFER_SIZE);
+            overdrive->setDrive(6.0f);
+        }
+
+        std::vector<float> leftBlock(BUFFER_SIZE), rightBlock(BUFFER_SIZE);
+        for (int b = 0; b < 200 && (left.getTableDrive() != 6.0f || right.getTableDrive() != 6.0f); ++b) {
+            std::fill(leftBlock.begin(), leftBlock.end(), 0.3f);
+            std::fill(rightBlock.begin(), rightBlock.end(), 0.3f);
+            left.process(leftBlock.data(), BUFFER_SIZE);
+            right.process(rightBlock.data(), BUFFER_SIZE);
+            juce::Thread::sleep(1);
+        }
+
+        REQUIRE(left.getTableDrive() == 6.0f);
+        REQUIRE(right.getTableDrive() == 6.0f);
+
+        // Once both have crossfaded in, the copied curve shapes like the built one
+        for (int b = 0; b < 4; ++b) {
+            std::fill(leftBlock.begin(), leftBlock.end(), 0.3f);
+            std::fill(rightBlock.begin(), rightBlock.end(), 0.3f);
+            left.process(leftBlock.data(), BUFFER_SIZE);
+            right.process(rightBlock.data(), BUFFER_SIZE);
+        }
+        REQUIRE(leftBlock.back() == rightBlock.back());
+    }
+}
+
+TEST_CASE("Overdrive Silence Detection", "[overdrive][silence]") {
+    Overdrive overdrive;
+    overdrive.setMode(Overdrive::Mode::Classic);
+    overdrive.setDrive(5.0f);
+    overdrive.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+    std::vector<float> buffer(BUFFER_SIZE);
+    for (int n = 0; n < BUFFER_SIZE; ++n)
+        buffer[n] = 0.5f * std::sin(0.05f * n);
+    overdrive.process(buffer.data(), BUFFER_SIZE);
+    REQUIRE_FALSE(overdrive.isSilent());
+
+    SECTION("The DC blocker settles on silent input") {
+        bool silent = false;
+        for (int block = 0; block < 100 && !silent; ++block) {
+            std::fill(buffer.begin(), buffer.end(), 0.0f);
+            overdrive.process(buffer.data(), BUFFER_SIZE);
+            silent = overdrive.isSilent();
+        }
+        REQUIRE(silent);
+    }
+
+    SECTION("Lowering the drive to 1 after a loud block") {
+        overdrive.setDrive(1.0f);
+
+        // Keep playing until the unity table is in and the crossfade is over
+        for (int block = 0; block < 200 && overdrive.getTableDrive() != 1.0f; ++block) {
+            for (int n = 0; n < BUFFER_SIZE; ++n)
+                buffer[n] = 0.5f * std::sin(0.05f * n);
+            overdrive.process(buffer.data(), BUFFER_SIZE);
+            juce::Thread::sleep(1);
+        }
+        REQUIRE(overdrive.getTableDrive() == 1.0f);
+
+        for (int block = 0; block < 4; ++block) {
+            for (int n = 0; n < BUFFER_SIZE; ++n)
+                buffer[n] = 0.5f * std::sin(0.05f * n + 1.0f);
+            overdrive.process(buffer.data(), BUFFER_SIZE);
+        }
+
+        // Bypassed, it goes silent with its input
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        overdrive.process(buffer.data(), BUFFER_SIZE);
+        REQUIRE(overdrive.isSilent());
+    }
+}
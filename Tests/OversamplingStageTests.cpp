@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <vector>
+
+// Include oversampling stage
+#include "dsp/OversamplingStage.h"
+
+using namespace Catch::Matchers;
+
+constexpr double SAMPLE_RATE = 44100.0;
+constexpr int BUFFER_SIZE = 512;
+constexpr float TWO_PI = 6.2831853f;
+
+namespace {
+    // Magnitude of one frequency in a block (single DFT bin)
+    float measureMagnitude(const std::vector<float>& signal, int start, float frequency) {
+        double re = 0.0, im = 0.0;
+        const int length = static_cast<int>(signal.size()) - start;
+        for (int i = 0; i < length; ++i) {
+            const double phase = TWO_PI * frequency * i / SAMPLE_RATE;
+            re += signal[start + i] * std::cos(phase);
+            im += signal[start + i] * std::sin(phase);
+        }
+        return static_cast<float>(2.0 * std::sqrt(re * re + im * im) / length);
+    }
+
+    // Hard-clipped sine rendered through the stage
+    std::vector<float> renderClippedSine(OversamplingStage& stage, float frequency, int numBlocks) {
+        std::vector<float> output;
+        std::vector<float> block(BUFFER_SIZE);
+        int n = 0;
+
+        for (int b = 0; b < numBlocks; ++b) {
+            for (int i = 0; i < BUFFER_SIZE; ++i, ++n)
+                block[i] = 0.8f * std::sin(TWO_PI * frequency * n / static_cast<float>(SAMPLE_RATE));
+
+            stage.process(block.data(), nullptr, BUFFER_SIZE, [](float* const* channels, int numChannels, int numSamples) {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        channels[ch][i] = std::tanh(10.0f * channels[ch][i]);
+            });
+
+            output.insert(output.end(), block.begin(), block.end());
+        }
+
+        return output;
+    }
+}
+
+TEST_CASE("OversamplingStage Factor And Latency", "[oversampling][latency]") {
+    OversamplingStage stage;
+    stage.prepare(SAMPLE_RATE, BUFFER_SIZE);
+
+    SECTION("Off is a zero-latency passthrough") {
+        REQUIRE(stage.getFactor() == 1);
+        REQUIRE(stage.getLatencySamples() == 0);
+
+        std::vector<float> block(BUFFER_SIZE);
+        for (int i = 0; i < BUFFER_SIZE; ++i)
+            block[i] = std::sin(0.01f * i);
+        const auto original = block;
+
+        int calledWith = 0;
+        stage.process(block.data(), nullptr, BUFFER_SIZE, [&](float* const*, int, int numSamples) { calledWith = numSamples; });
+
+        REQUIRE(calledWith == BUFFER_SIZE);
+        REQUIRE(block == original);
+    }
+
+    SECTION("Callback runs at the oversampled length") {
+        for (int index = 1; index <= 3; ++index) {
+            stage.setFactor(index);
+            REQUIRE(stage.getFactor() == (1 << index));
+            REQUIRE(stage.getOversampledRate() == SAMPLE_RATE * (1 << index));
+
+            std::vector<float> left(BUFFER_SIZE, 0.0f), right(BUFFER_SIZE, 0.0f);
+            int calledWith = 0, channels = 0;
+            stage.process(left.data(), right.data(), BUFFER_SIZE, [&](float* const*, int numChannels, int numSamples) {
+                calledWith = numSamples;
+                channels = numChannels;
+            });
+
+            REQUIRE(calledWith == BUFFER_SIZE * (1 << index));
+            REQUIRE(channels == 2);
+        }
+    }
+
+    SECTION("Linear phase costs more latency than minimum phase") {
+        stage.setFactor(OversamplingStage::Factor::X4);
+
+        stage.setFilterType(OversamplingStage::FilterType::MinimumPhase);
+        const int minimumPhaseLatency = stage.getLatencySamples();
+
+        stage.setFilterType(OversamplingStage::FilterType::LinearPhase);
+        const int linearPhaseLatency = stage.getLatencySamples();
+
+        REQUIRE(minimumPhaseLatency >= 0);
+        REQUIRE(linearPhaseLatency > minimumPhaseLatency);
+    }
+}
+
+TEST_CASE("OversamplingStage Aliasing", "[oversampling][aliasing]") {
+    // A 5 kHz sine clipped at the base rate folds its 7th harmonic (35 kHz) to 9.1 kHz
+    const float fundamental = 5000.0f;
+    const float alias = static_cast<float>(SAMPLE_RATE) - 7.0f * fundamental;
+    const int settle = BUFFER_SIZE;
+
+    OversamplingStage baseRate;
+    baseRate.prepare(SAMPLE_RATE, BUFFER_SIZE);
+    const auto direct = renderClippedSine(baseRate, fundamental, 8);
+
+    for (int filterType = 0; filterType <= 1; ++filterType) {
+        OversamplingStage oversampled;
+        oversampled.prepare(SAMPLE_RATE, BUFFER_SIZE);
+        oversampled.setFactor(OversamplingStage::Factor::X8);
+        oversampled.setFilterType(filterType);
+        const auto filtered = renderClippedSine(oversampled, fundamental, 8);
+
+        INFO("Filter type: " << filterType);
+
+        // Fundamental survives, the alias drops by at least 20 dB
+        REQUIRE(measureMagnitude(filtered, settle, fundamental) > 0.5f * measureMagnitude(direct, settle, fundamental));
+        REQUIRE(measureMagnitude(filtered, settle, alias) < 0.1f * measureMagnitude(direct, settle, alias));
+    }
+}
+
+TEST_CASE("OversamplingStage Control Upsampling", "[oversampling][control]") {
+    OversamplingStage stage;
+    stage.prepare(SAMPLE_RATE, BUFFER_SIZE);
+    stage.setFactor(OversamplingStage::Factor::X4);
+
+    std::vector<float> control(BUFFER_SIZE);
+    for (int i = 0; i < BUFFER_SIZE; ++i)
+        control[i] = static_cast<float>(i + 1) / BUFFER_SIZE;
+
+    const float* upsampled = stage.upsampleControl(control.data(), BUFFER_SIZE);
+
+    SECTION("Every base-rate value lands on its last oversampled sample") {
+        for (int i = 0; i < BUFFER_SIZE; ++i) {
+            REQUIRE_THAT(upsampled[i * 4 + 3], WithinAbs(control[i], 1.0e-6f));
+        }
+    }
+
+    SECTION("Values in between are linear") {
+        REQUIRE_THAT(upsampled[5], WithinAbs(0.5f * (control[0] + control[1]), 1.0e-6f));
+    }
+}
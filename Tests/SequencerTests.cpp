@@ -0,0 +1,271 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Include sequencer
+#include "dsp/Sequencer.h"
+#include "core/TripleBuffer.h"
+
+constexpr double SAMPLE_RATE = 48000.0;
+constexpr double BPM = 120.0;
+constexpr double SAMPLES_PER_BEAT = SAMPLE_RATE * 60.0 / BPM;
+constexpr int64_t STEP_SAMPLES = static_cast<int64_t>(SAMPLES_PER_BEAT / 4.0);     // 6000
+constexpr int BUFFER_SIZE = 480;
+
+using Event = Sequencer::Event;
+using Pattern = Sequencer::Pattern;
+
+namespace {
+    struct TimedEvent {
+        Event event;
+        int64_t sample = 0;
+    };
+
+    /** Runs the sequencer over consecutive blocks and collects events at absolute sample positions. */
+    std::vector<TimedEvent> runBlocks(Sequencer& sequencer, int numBlocks, int blockSize, double startPpq = 0.0)
+    {
+        std::vector<TimedEvent> events;
+        int64_t position = 0;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const double ppq = startPpq + position / SAMPLES_PER_BEAT;
+            for (const auto& event : sequencer.process(BPM, ppq, blockSize))
+            {
+                REQUIRE(event.offset >= 0);
+                REQUIRE(event.offset < blockSize);
+                events.push_back({event, position + event.offset});
+            }
+
+            position += blockSize;
+        }
+
+        return events;
+    }
+
+    std::vector<TimedEvent> noteOns(const std::vector<TimedEvent>& events)
+    {
+        std::vector<TimedEvent> result;
+        for (const auto& timed : events)
+            if (timed.event.type == Event::Type::NoteOn)
+                result.push_back(timed);
+        return result;
+    }
+
+    Pattern makeScale()
+    {
+        Pattern pattern;
+        for (int step = 0; step < Pattern::NUM_STEPS; ++step)
+            pattern.notes[static_cast<size_t>(step)] = static_cast<uint8_t>(36 + step);
+        return pattern;
+    }
+}
+
+TEST_CASE("Sequencer Pattern", "[sequencer][pattern]") {
+    SECTION("Default pattern gates every step") {
+        Pattern pattern;
+        for (int step = 0; step < Pattern::NUM_STEPS; ++step) {
+            REQUIRE(pattern.hasFlag(step, Pattern::Gate));
+            REQUIRE_FALSE(pattern.hasFlag(step, Pattern::Accent));
+            REQUIRE_FALSE(pattern.hasFlag(step, Pattern::Slide));
+        }
+    }
+
+    SECTION("Survives a round trip through its string form") {
+        Pattern pattern = makeScale();
+        pattern.setFlag(3, Pattern::Accent, true);
+        pattern.setFlag(7, Pattern::Slide, true);
+        pattern.setFlag(9, Pattern::Gate, false);
+
+        Pattern loaded;
+        REQUIRE(loaded.fromString(pattern.toString()));
+        REQUIRE(loaded.notes == pattern.notes);
+        REQUIRE(loaded.flags == pattern.flags);
+    }
+
+    SECTION("Rejects malformed text") {
+        Pattern pattern = makeScale();
+        REQUIRE_FALSE(pattern.fromString(""));
+        REQUIRE_FALSE(pattern.fromString("36:1 36:1"));
+        REQUIRE_FALSE(pattern.fromString(juce::String("200:1 ").repeatedString("200:1 ", 16)));
+        REQUIRE(pattern.notes == makeScale().notes);
+    }
+}
+
+TEST_CASE("Sequencer Timing", "[sequencer][timing]") {
+    Sequencer sequencer;
+    sequencer.prepare(SAMPLE_RATE);
+    sequencer.setPattern(makeScale());
+
+    SECTION("Silent while disabled") {
+        REQUIRE(sequencer.process(BPM, 0.0, BUFFER_SIZE).empty());
+    }
+
+    sequencer.setEnabled(true);
+
+    SECTION("Steps land on the 1/16 grid and follow the bar") {
+        const auto starts = noteOns(runBlocks(sequencer, 400, BUFFER_SIZE));
+
+        REQUIRE(starts.size() == 32);
+        for (size_t i = 0; i < starts.size(); ++i) {
+            REQUIRE(starts[i].sample == static_cast<int64_t>(i) * STEP_SAMPLES);
+            REQUIRE(starts[i].event.note == 36 + static_cast<int>(i % 16));
+        }
+    }
+
+    SECTION("Starting mid-bar picks up the matching step") {
+        // Beat 2 of the bar is step 8
+        const auto starts = noteOns(runBlocks(sequencer, 20, BUFFER_SIZE, 2.0));
+        REQUIRE(starts.front().sample == 0);
+        REQUIRE(starts.front().event.note == 36 + 8);
+    }
+
+    SECTION("Gated steps close after half a step") {
+        const auto events = runBlocks(sequencer, 100, BUFFER_SIZE);
+
+        for (size_t i = 0; i + 1 < events.size(); i += 2) {
+            REQUIRE(events[i].event.type == Event::Type::NoteOn);
+            REQUIRE(events[i + 1].event.type == Event::Type::NoteOff);
+            REQUIRE(events[i + 1].sample - events[i].sample == STEP_SAMPLES / 2);
+        }
+    }
+
+    SECTION("Shuffle delays odd steps") {
+        sequencer.setShuffle(1.0f);
+        const auto starts = noteOns(runBlocks(sequencer, 200, BUFFER_SIZE));
+
+        for (size_t i = 0; i < 8; ++i) {
+            const int64_t shuffle = (i % 2 == 1) ? STEP_SAMPLES / 2 : 0;
+            REQUIRE(starts[i].sample == static_cast<int64_t>(i) * STEP_SAMPLES + shuffle);
+        }
+    }
+
+    SECTION("Block size does not change the schedule") {
+        const auto large = runBlocks(sequencer, 24, 4096);
+
+        Sequencer other;
+        other.prepare(SAMPLE_RATE);
+        other.setPattern(makeScale());
+        other.setEnabled(true);
+        const auto small = runBlocks(other, 4096 * 24 / 64, 64);
+
+        REQUIRE(large.size() == small.size());
+        for (size_t i = 0; i < large.size(); ++i)
+            REQUIRE(large[i].sample == small[i].sample);
+    }
+
+    SECTION("Disabling releases the sounding note") {
+        runBlocks(sequencer, 1, BUFFER_SIZE);
+        sequencer.setEnabled(false);
+
+        const auto& events = sequencer.process(BPM, BUFFER_SIZE / SAMPLES_PER_BEAT, BUFFER_SIZE);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].type == Event::Type::NoteOff);
+        REQUIRE(sequencer.getPlayingStep() == -1);
+    }
+}
+
+TEST_CASE("Sequencer Accent, Slide and Rests", "[sequencer][steps]") {
+    Sequencer sequencer;
+    sequencer.prepare(SAMPLE_RATE);
+    sequencer.setEnabled(true);
+
+    Pattern pattern = makeScale();
+    pattern.setFlag(1, Pattern::Accent, true);
+    pattern.setFlag(2, Pattern::Slide, true);      // Ties into step 3
+    pattern.setFlag(5, Pattern::Gate, false);      // Rest
+    pattern.setFlag(6, Pattern::Slide, true);
+    pattern.setFlag(7, Pattern::Gate, false);      // Slide into a rest does not tie
+    sequencer.setPattern(pattern);
+
+    const auto events = runBlocks(sequencer, 200, BUFFER_SIZE);
+    const auto starts = noteOns(events);
+
+    SECTION("Accent is reported per step") {
+        REQUIRE(starts[1].event.accent);
+        REQUIRE_FALSE(starts[0].event.accent);
+        REQUIRE_FALSE(starts[2].event.accent);
+    }
+
+    SECTION("A slid step ties into the next without a gate-off") {
+        REQUIRE(starts[3].event.note == 39);
+        REQUIRE(starts[3].event.slide);
+        REQUIRE_FALSE(starts[2].event.slide);
+        REQUIRE_FALSE(starts[4].event.slide);
+
+        for (const auto& timed : events)
+            if (timed.event.type == Event::Type::NoteOff)
+                REQUIRE(timed.sample != 2 * STEP_SAMPLES + STEP_SAMPLES / 2);
+    }
+
+    SECTION("Rests play nothing and a slide into a rest closes normally") {
+        for (const auto& timed : starts) {
+            REQUIRE(timed.sample != 5 * STEP_SAMPLES);
+            REQUIRE(timed.sample != 7 * STEP_SAMPLES);
+        }
+
+        bool closed = false;
+        for (const auto& timed : events)
+            if (timed.event.type == Event::Type::NoteOff && timed.sample == 6 * STEP_SAMPLES + STEP_SAMPLES / 2)
+                closed = true;
+        REQUIRE(closed);
+    }
+}
+
+TEST_CASE("TripleBuffer", "[sequencer][triplebuffer]") {
+    struct Block {
+        int values[64];
+    };
+
+    SECTION("Reader sees the initial value until something is published") {
+        TripleBuffer<int> buffer(7);
+        REQUIRE_FALSE(buffer.update());
+        REQUIRE(buffer.read() == 7);
+
+        buffer.write(8);
+        buffer.write(9);
+        REQUIRE(buffer.update());
+        REQUIRE(buffer.read() == 9);
+        REQUIRE_FALSE(buffer.update());
+        REQUIRE(buffer.read() == 9);
+    }
+
+    SECTION("Concurrent writes are never torn") {
+        TripleBuffer<Block> buffer;
+        std::atomic<bool> done{false};
+
+        std::thread writer([&]
+        {
+            for (int version = 1; version <= 20000; ++version)
+            {
+                auto& block = buffer.getWriteBuffer();
+                for (int& value : block.values)
+                    value = version;
+                buffer.publish();
+            }
+            done.store(true);
+        });
+
+        int lastVersion = 0;
+        bool torn = false;
+        bool ordered = true;
+        while (!done.load())
+        {
+            buffer.update();
+            const auto& block = buffer.read();
+            for (int value : block.values)
+                torn = torn || value != block.values[0];
+
+            ordered = ordered && block.values[0] >= lastVersion;
+            lastVersion = block.values[0];
+        }
+
+        writer.join();
+        buffer.update();
+
+        REQUIRE_FALSE(torn);
+        REQUIRE(ordered);
+        REQUIRE(buffer.read().values[0] == 20000);
+    }
+}
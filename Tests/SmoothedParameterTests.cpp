@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <vector>
+
+// Include smoother
+#include "core/SmoothedParameter.h"
+
+using namespace Catch::Matchers;
+
+constexpr double SAMPLE_RATE = 44100.0;
+constexpr int BUFFER_SIZE = 512;
+
+TEST_CASE("SmoothedParameter Constant Output", "[smoothing][constant]") {
+    SmoothedParameter smoother;
+    smoother.prepare(SAMPLE_RATE, BUFFER_SIZE, 0.01f);
+    smoother.reset(0.5f);
+
+    SECTION("Renders the current value when not ramping") {
+        const float* values = smoother.render(BUFFER_SIZE);
+        for (int i = 0; i < BUFFER_SIZE; ++i) {
+            REQUIRE(values[i] == 0.5f);
+        }
+        REQUIRE_FALSE(smoother.isSmoothing());
+    }
+
+    SECTION("Setting the same target does not start a ramp") {
+        smoother.setTarget(0.5f);
+        REQUIRE_FALSE(smoother.isSmoothing());
+    }
+}
+
+TEST_CASE("SmoothedParameter Linear Ramp", "[smoothing][linear]") {
+    SmoothedParameter smoother;
+    smoother.prepare(SAMPLE_RATE, BUFFER_SIZE, 0.01f); // 441 samples
+    smoother.reset(0.0f);
+    smoother.setTarget(1.0f);
+
+    SECTION("Ramps monotonically and lands exactly on the target") {
+        const float* values = smoother.render(BUFFER_SIZE);
+
+        for (int i = 1; i < 441; ++i) {
+            REQUIRE(values[i] > values[i - 1]);
+        }
+        REQUIRE_THAT(values[219], WithinAbs(220.0f / 441.0f, 1e-4f));
+        REQUIRE(values[440] == 1.0f);
+        REQUIRE(values[BUFFER_SIZE - 1] == 1.0f);
+        REQUIRE_FALSE(smoother.isSmoothing());
+    }
+
+    SECTION("Ramps split across blocks match a single render") {
+        SmoothedParameter reference;
+        reference.prepare(SAMPLE_RATE, BUFFER_SIZE, 0.01f);
+        reference.reset(0.0f);
+        reference.setTarget(1.0f);
+        const float* rendered = reference.render(BUFFER_SIZE);
+        std::vector<float> expected(rendered, rendered + BUFFER_SIZE);
+
+        std::vector<float> actual;
+        for (int block = 0; block < BUFFER_SIZE / 64; ++block) {
+            const float* values = smoother.render(64);
+            actual.insert(actual.end(), values, values + 64);
+        }
+
+        for (int i = 0; i < BUFFER_SIZE; ++i) {
+            REQUIRE_THAT(actual[i], WithinAbs(expected[i], 1e-6f));
+        }
+    }
+}
+
+TEST_CASE("SmoothedParameter Multiplicative Ramp", "[smoothing][multiplicative]") {
+    SmoothedParameter smoother(SmoothedParameter::Curve::Multiplicative);
+    smoother.prepare(SAMPLE_RATE, BUFFER_SIZE, 0.01f);
+    smoother.reset(100.0f);
+    smoother.setTarget(1600.0f);
+
+    SECTION("Moves by a constant ratio and reaches the target") {
+        const float* values = smoother.render(BUFFER_SIZE);
+
+        // Four octaves over 441 samples - sample 219 is half a step short of two octaves up
+        REQUIRE_THAT(values[219], WithinRel(400.0f * std::pow(16.0f, -0.5f / 441.0f), 1e-3f));
+        REQUIRE_THAT(values[100] / values[99], WithinRel(values[300] / values[299], 1e-4f));
+        REQUIRE(values[440] == 1600.0f);
+    }
+
+    SECTION("Falls back to a linear ramp through zero") {
+        smoother.reset(0.0f);
+        smoother.setTarget(1.0f);
+        const float* values = smoother.render(BUFFER_SIZE);
+
+        REQUIRE(values[0] > 0.0f);
+        REQUIRE(values[440] == 1.0f);
+    }
+}
+
+TEST_CASE("SmoothedParameter Sample Rate Change", "[smoothing][samplerate]") {
+    SmoothedParameter smoother;
+    smoother.prepare(SAMPLE_RATE, 4 * BUFFER_SIZE, 0.01f); // 441 samples
+    smoother.reset(0.0f);
+    smoother.setTarget(1.0f);
+
+    // Half way through the ramp, then twice the rate: the rest takes as long
+    smoother.render(220);
+    const float halfWay = smoother.getCurrentValue();
+    smoother.setSampleRate(2.0 * SAMPLE_RATE);
+
+    const float* values = smoother.render(442);
+    REQUIRE(values[0] > halfWay);
+    REQUIRE(values[0] - halfWay < 0.01f);
+    REQUIRE(values[440] < 1.0f);
+    REQUIRE(values[441] == 1.0f);
+    REQUIRE_FALSE(smoother.isSmoothing());
+
+    // Later ramps use the new rate
+    smoother.setTarget(0.0f);
+    smoother.render(881);
+    REQUIRE(smoother.isSmoothing());
+    smoother.render(1);
+    REQUIRE_FALSE(smoother.isSmoothing());
+}